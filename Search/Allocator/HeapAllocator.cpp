@@ -7,23 +7,75 @@
 #include "../Utility/Util.h"
 #include "../Utility/Memory.h"
 
-#include "../Parallel/SpinLock.h"
-#include "../Parallel/LockGuard.h"
 
+namespace {
+	const int MIN_CLASS_SHIFT = 6;  // 64 B
+	const int MAX_CLASS_SHIFT = 16; // 64 KB
+	const int CLASSES_COUNT = MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1;
+	const int MAX_CACHED_BLOCKS = 64;
+
+	const unsigned int NO_CLASS = 0xFFffFFffu;
+
+	// Stored just before every returned memory
+	struct BlockHeader {
+		void* real;
+		size_t size;
+		unsigned int sizeClass;
+	};
+
+	struct FreeBlock {
+		FreeBlock* next;
+	};
+
+	struct ThreadCache {
+		FreeBlock* blocks[CLASSES_COUNT];
+		int counts[CLASSES_COUNT];
+
+		~ThreadCache() {
+			for (int i = 0; i < CLASSES_COUNT; ++i) {
+				while (blocks[i]) {
+					FreeBlock* block = blocks[i];
+					blocks[i] = block->next;
+					free(block);
+				}
+			}
+		}
+	};
+
+	thread_local ThreadCache t_Cache = {};
+}
+
+
+static unsigned int SizeClass(size_t size) {
+	for (unsigned int i = 0; i < CLASSES_COUNT; ++i) {
+		if (size <= ((size_t) 1 << (i + MIN_CLASS_SHIFT)))
+			return i;
+	}
+	return NO_CLASS;
+}
 
 void HeapDeallocate(IAllocator* allocator, void* mem) {
 	assert(allocator);
 	HeapAllocator* heapAllocator = static_cast<HeapAllocator*>(allocator);
 
-	void* real = *((void**) mem - 1);
-
-	SpinLock lock;
-	LockGuard<SpinLock> lockGuard(lock);
-
-	assert(heapAllocator->_allocationsCount > 0);
-	--heapAllocator->_allocationsCount;
+	BlockHeader* header = static_cast<BlockHeader*>(mem) - 1;
+	void* real = header->real;
+	unsigned int sizeClass = header->sizeClass;
+
+	size_t previousCount = heapAllocator->_allocationsCount.fetch_sub(1, std::memory_order_relaxed);
+	assert(previousCount > 0);
+	heapAllocator->_allocatedSize.fetch_sub(header->size, std::memory_order_relaxed);
+
+	ThreadCache& cache = t_Cache;
+	if (sizeClass != NO_CLASS && cache.counts[sizeClass] < MAX_CACHED_BLOCKS) {
+		FreeBlock* block = static_cast<FreeBlock*>(real);
+		block->next = cache.blocks[sizeClass];
+		cache.blocks[sizeClass] = block;
+		++cache.counts[sizeClass];
+		return;
+	}
 
-	free(real); // Just to be sure lock free too
+	free(real);
 }
 
 void* HeapAllocate(IAllocator* allocator, size_t size, size_t alignment) {
@@ -32,18 +84,42 @@ void* HeapAllocate(IAllocator* allocator, size_t size, size_t alignment) {
 
 	HeapAllocator* heapAllocator = static_cast<HeapAllocator*>(allocator);
 
-	size_t extraSize = alignment - 1 + sizeof(void*);
+	if (alignment < alignof(BlockHeader))
+		alignment = alignof(BlockHeader);
+
+	size_t extraSize = alignment - 1 + sizeof(BlockHeader);
+
+	unsigned int sizeClass = SizeClass(size + extraSize);
+
+	char* mem = nullptr;
+	if (sizeClass != NO_CLASS) {
+		ThreadCache& cache = t_Cache;
+		FreeBlock* block = cache.blocks[sizeClass];
+		if (block) {
+			cache.blocks[sizeClass] = block->next;
+			--cache.counts[sizeClass];
+			mem = reinterpret_cast<char*>(block);
+		}
+		else {
+			mem = (char*) malloc((size_t) 1 << (sizeClass + MIN_CLASS_SHIFT));
+		}
+	}
+	else {
+		mem = (char*) malloc(size + extraSize);
+	}
+
+	heapAllocator->_allocationsCount.fetch_add(1, std::memory_order_relaxed);
 
-	char* mem;
-	{
-		SpinLock lock;
-		LockGuard<SpinLock> lockGuard(lock);
-		++heapAllocator->_allocationsCount;
-		mem = (char*) malloc(size + extraSize); // Just to be sure lock malloc too
+	size_t allocatedSize = heapAllocator->_allocatedSize.fetch_add(size, std::memory_order_relaxed) + size;
+	size_t peak = heapAllocator->_peakAllocatedSize.load(std::memory_order_relaxed);
+	while (allocatedSize > peak && !heapAllocator->_peakAllocatedSize.compare_exchange_weak(peak, allocatedSize, std::memory_order_relaxed)) {
 	}
 
-	void* res = AlignForward(mem + sizeof(void*), alignment);
-	*((void**) res - 1) = mem;
+	void* res = AlignForward(mem + sizeof(BlockHeader), alignment);
+	BlockHeader* header = static_cast<BlockHeader*>(res) - 1;
+	header->real = mem;
+	header->size = size;
+	header->sizeClass = sizeClass;
 
 	assert((uintptr_t) res % alignment == 0);
 
@@ -54,17 +130,19 @@ void HeapDestruct(IAllocator* allocator) {
 	assert(allocator);
 	HeapAllocator* heapAllocator = static_cast<HeapAllocator*>(allocator);
 
-	SpinLock lock;
-	LockGuard<SpinLock> lockGuard(lock);
-	assert(heapAllocator->_allocationsCount == 0);
-	*heapAllocator = {};
+	assert(heapAllocator->_allocationsCount.load() == 0);
+	heapAllocator->Allocate = nullptr;
+	heapAllocator->Deallocate = nullptr;
+	heapAllocator->Destruct = nullptr;
 }
 
 
 IAllocator* InitHeapAllocator(HeapAllocator* allocator) {
 	assert(allocator);
-	// Heap allocator dosnt need context, only one number as debug counter
-	allocator->_allocationsCount = 0;
+	// Heap allocator dosnt need context, only debug counters
+	allocator->_allocationsCount.store(0);
+	allocator->_allocatedSize.store(0);
+	allocator->_peakAllocatedSize.store(0);
 	allocator->Allocate = HeapAllocate;
 	allocator->Deallocate = HeapDeallocate;
 	allocator->Destruct = HeapDestruct;
@@ -72,3 +150,18 @@ IAllocator* InitHeapAllocator(HeapAllocator* allocator) {
 	return allocator;
 }
 
+size_t HeapAllocatorAllocationsCount(const HeapAllocator* allocator) {
+	return allocator->_allocationsCount.load();
+}
+
+size_t HeapAllocatorAllocatedSize(const HeapAllocator* allocator) {
+	return allocator->_allocatedSize.load();
+}
+
+size_t HeapAllocatorPeakAllocatedSize(const HeapAllocator* allocator) {
+	return allocator->_peakAllocatedSize.load();
+}
+
+void HeapAllocatorResetPeak(HeapAllocator* allocator) {
+	allocator->_peakAllocatedSize.store(allocator->_allocatedSize.load());
+}
@@ -1,15 +1,34 @@
 #pragma once
 
+#include <atomic>
+
 #include "IAllocator.h"
 
 //  HeapAllocator 
 //    Simple allocator wrapping malloc / free
-//    Is thread safe
+//    Is thread safe, doesnt lock (malloc does)
 //    Allocates extra memory to properly align all allocations
-//    For debug, counting allocations
+//    For debug, counting allocations (atomic)
+//    Counts allocated bytes and their high-water mark (atomic, requested sizes without headers and caches)
+//
+//    Freed small blocks are kept in per thread cache (power of two size classes, shared by all heap allocators)
+//    Allocation on the same thread takes block from the cache without calling malloc
+//    Cache is freed when thread ends
 
 struct HeapAllocator : public IAllocator {
-	size_t _allocationsCount;
+	std::atomic<size_t> _allocationsCount;
+	std::atomic<size_t> _allocatedSize;
+	std::atomic<size_t> _peakAllocatedSize;
 };
 
 IAllocator* InitHeapAllocator(HeapAllocator* allocator);
+
+size_t HeapAllocatorAllocationsCount(const HeapAllocator* allocator);
+
+size_t HeapAllocatorAllocatedSize(const HeapAllocator* allocator);
+
+// Max allocated size since init or last reset
+size_t HeapAllocatorPeakAllocatedSize(const HeapAllocator* allocator);
+
+// Peak starts again from currently allocated size
+void HeapAllocatorResetPeak(HeapAllocator* allocator);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 
 //  IAllocator
 //    Allocator interface for aligned allocations
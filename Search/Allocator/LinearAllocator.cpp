@@ -0,0 +1,122 @@
+#include "LinearAllocator.h"
+
+#include <cassert>
+#include <cstdint>
+
+#include "../Utility/Util.h"
+#include "../Utility/Memory.h"
+
+
+namespace {
+	// Stored just before every returned memory, allocator state before the allocation
+	struct AllocationHeader {
+		char* previousCurrent;
+		char* previousLastAllocation;
+	};
+}
+
+
+void LinearDeallocate(IAllocator* allocator, void* mem) {
+	assert(allocator);
+	LinearAllocator* linearAllocator = static_cast<LinearAllocator*>(allocator);
+
+	assert(mem >= linearAllocator->_begin && mem < linearAllocator->_current);
+	assert(linearAllocator->_allocationsCount > 0);
+	--linearAllocator->_allocationsCount;
+
+	AllocationHeader* header = static_cast<AllocationHeader*>(mem) - 1;
+
+	// Only the last allocation can be returned, others wait for Reset
+	if (reinterpret_cast<char*>(header) == linearAllocator->_lastAllocation) {
+		linearAllocator->_current = header->previousCurrent;
+		linearAllocator->_lastAllocation = header->previousLastAllocation;
+	}
+}
+
+void* LinearAllocate(IAllocator* allocator, size_t size, size_t alignment) {
+	assert(allocator);
+	assert(IsPowerOfTwo(alignment));
+
+	LinearAllocator* linearAllocator = static_cast<LinearAllocator*>(allocator);
+
+	// Header before the memory has to be aligned too
+	if (alignment < alignof(AllocationHeader))
+		alignment = alignof(AllocationHeader);
+
+	char* res = static_cast<char*>(AlignForward(linearAllocator->_current + sizeof(AllocationHeader), alignment));
+	assert(res + size <= linearAllocator->_end); // Out of memory
+
+	AllocationHeader* header = reinterpret_cast<AllocationHeader*>(res) - 1;
+	header->previousCurrent = linearAllocator->_current;
+	header->previousLastAllocation = linearAllocator->_lastAllocation;
+
+	linearAllocator->_current = res + size;
+	linearAllocator->_lastAllocation = reinterpret_cast<char*>(header);
+	++linearAllocator->_allocationsCount;
+
+	assert((uintptr_t) res % alignment == 0);
+
+	return res;
+}
+
+void LinearDestruct(IAllocator* allocator) {
+	assert(allocator);
+	LinearAllocator* linearAllocator = static_cast<LinearAllocator*>(allocator);
+
+	assert(linearAllocator->_allocationsCount == 0);
+
+	if (linearAllocator->_backing)
+		Deallocate(linearAllocator->_backing, linearAllocator->_begin);
+
+	*linearAllocator = {};
+}
+
+
+IAllocator* InitLinearAllocator(LinearAllocator* allocator, void* mem, size_t size) {
+	assert(allocator);
+	assert(mem);
+
+	allocator->_begin = static_cast<char*>(mem);
+	allocator->_current = allocator->_begin;
+	allocator->_end = allocator->_begin + size;
+	allocator->_lastAllocation = nullptr;
+	allocator->_allocationsCount = 0;
+	allocator->_backing = nullptr;
+
+	allocator->Allocate = LinearAllocate;
+	allocator->Deallocate = LinearDeallocate;
+	allocator->Destruct = LinearDestruct;
+
+	return allocator;
+}
+
+IAllocator* InitLinearAllocator(LinearAllocator* allocator, IAllocator* backing, size_t size) {
+	assert(backing);
+
+	InitLinearAllocator(allocator, Allocate(backing, size, alignof(AllocationHeader)), size);
+	allocator->_backing = backing;
+
+	return allocator;
+}
+
+LinearAllocatorMark LinearAllocatorGetMark(const LinearAllocator* allocator) {
+	return LinearAllocatorMark{allocator->_current, allocator->_lastAllocation, allocator->_allocationsCount};
+}
+
+void LinearAllocatorReset(LinearAllocator* allocator, const LinearAllocatorMark* mark) {
+	assert(mark->current >= allocator->_begin && mark->current <= allocator->_current);
+
+	allocator->_current = mark->current;
+	allocator->_lastAllocation = mark->lastAllocation;
+	allocator->_allocationsCount = mark->allocationsCount;
+}
+
+void LinearAllocatorReset(LinearAllocator* allocator) {
+	allocator->_current = allocator->_begin;
+	allocator->_lastAllocation = nullptr;
+	allocator->_allocationsCount = 0;
+}
+
+size_t LinearAllocatorUsed(const LinearAllocator* allocator) {
+	return allocator->_current - allocator->_begin;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "IAllocator.h"
+
+//  LinearAllocator
+//    Bump pointer allocator in one memory block, for scratch memory of single query / frame
+//    Memory block is given by caller, or allocated from backing allocator (any allocator, also other linear allocator -> nesting)
+//    Not thread safe
+//
+//    Deallocate returns memory only if it was the last allocation (stack order), other memory is returned by Reset
+//    Mark / Reset returns allocator to the marked state, all allocations after mark are freed at once
+//    Out of memory is error (assert), size is known up front
+//    For debug, counting allocations
+
+struct LinearAllocator : public IAllocator {
+	char* _begin;
+	char* _current;
+	char* _end;
+
+	char* _lastAllocation; // Header of last allocation, nullptr if there is none
+
+	size_t _allocationsCount;
+
+	IAllocator* _backing; // Owner of the memory block, nullptr if memory was given by caller
+};
+
+struct LinearAllocatorMark {
+	char* current;
+	char* lastAllocation;
+	size_t allocationsCount;
+};
+
+IAllocator* InitLinearAllocator(LinearAllocator* allocator, void* mem, size_t size);
+IAllocator* InitLinearAllocator(LinearAllocator* allocator, IAllocator* backing, size_t size);
+
+LinearAllocatorMark LinearAllocatorGetMark(const LinearAllocator* allocator);
+
+void LinearAllocatorReset(LinearAllocator* allocator, const LinearAllocatorMark* mark);
+
+// Frees all allocations
+void LinearAllocatorReset(LinearAllocator* allocator);
+
+size_t LinearAllocatorUsed(const LinearAllocator* allocator);
@@ -0,0 +1,111 @@
+#include "PoolAllocator.h"
+
+#include <cassert>
+#include <cstdint>
+
+#include "../Utility/Util.h"
+#include "../Utility/Memory.h"
+
+
+namespace {
+	// Free block and chunk header share layout, both are only pointers to next one
+	struct Link {
+		Link* next;
+	};
+}
+
+
+static void AllocateChunk(PoolAllocator* poolAllocator) {
+	size_t headerSize = poolAllocator->_blockAlignment > sizeof(Link) ? poolAllocator->_blockAlignment : sizeof(Link);
+	size_t chunkSize = headerSize + poolAllocator->_blockSize * poolAllocator->_blocksPerChunk;
+
+	char* chunk = static_cast<char*>(Allocate(poolAllocator->_backing, chunkSize, poolAllocator->_blockAlignment > alignof(Link) ? poolAllocator->_blockAlignment : alignof(Link)));
+
+	Link* chunkLink = reinterpret_cast<Link*>(chunk);
+	chunkLink->next = static_cast<Link*>(poolAllocator->_chunks);
+	poolAllocator->_chunks = chunkLink;
+
+	// Blocks are linked in address order
+	char* blocks = chunk + headerSize;
+	for (int i = poolAllocator->_blocksPerChunk - 1; i >= 0; --i) {
+		Link* block = reinterpret_cast<Link*>(blocks + i * poolAllocator->_blockSize);
+		block->next = static_cast<Link*>(poolAllocator->_freeBlocks);
+		poolAllocator->_freeBlocks = block;
+	}
+}
+
+void PoolDeallocate(IAllocator* allocator, void* mem) {
+	assert(allocator);
+	PoolAllocator* poolAllocator = static_cast<PoolAllocator*>(allocator);
+
+	assert(poolAllocator->_allocationsCount > 0);
+	--poolAllocator->_allocationsCount;
+
+	Link* block = static_cast<Link*>(mem);
+	block->next = static_cast<Link*>(poolAllocator->_freeBlocks);
+	poolAllocator->_freeBlocks = block;
+}
+
+void* PoolAllocate(IAllocator* allocator, size_t size, size_t alignment) {
+	assert(allocator);
+	assert(IsPowerOfTwo(alignment));
+
+	PoolAllocator* poolAllocator = static_cast<PoolAllocator*>(allocator);
+
+	assert(size <= poolAllocator->_blockSize);
+	assert(alignment <= poolAllocator->_blockAlignment);
+
+	if (!poolAllocator->_freeBlocks)
+		AllocateChunk(poolAllocator);
+
+	Link* block = static_cast<Link*>(poolAllocator->_freeBlocks);
+	poolAllocator->_freeBlocks = block->next;
+	++poolAllocator->_allocationsCount;
+
+	assert((uintptr_t) block % alignment == 0);
+
+	return block;
+}
+
+void PoolDestruct(IAllocator* allocator) {
+	assert(allocator);
+	PoolAllocator* poolAllocator = static_cast<PoolAllocator*>(allocator);
+
+	assert(poolAllocator->_allocationsCount == 0);
+
+	Link* chunk = static_cast<Link*>(poolAllocator->_chunks);
+	while (chunk) {
+		Link* next = chunk->next;
+		Deallocate(poolAllocator->_backing, chunk);
+		chunk = next;
+	}
+
+	*poolAllocator = {};
+}
+
+
+IAllocator* InitPoolAllocator(PoolAllocator* allocator, IAllocator* backing, size_t blockSize, size_t blockAlignment, int blocksPerChunk) {
+	assert(allocator);
+	assert(backing);
+	assert(IsPowerOfTwo(blockAlignment));
+	assert(blocksPerChunk > 0);
+
+	// Block has to hold free list link and keep alignment of following blocks
+	size_t minAlignment = blockAlignment > alignof(Link) ? blockAlignment : alignof(Link);
+	blockSize = blockSize > sizeof(Link) ? blockSize : sizeof(Link);
+	blockSize = (blockSize + minAlignment - 1) & ~(minAlignment - 1);
+
+	allocator->_blockSize = blockSize;
+	allocator->_blockAlignment = minAlignment;
+	allocator->_blocksPerChunk = blocksPerChunk;
+	allocator->_freeBlocks = nullptr;
+	allocator->_chunks = nullptr;
+	allocator->_allocationsCount = 0;
+	allocator->_backing = backing;
+
+	allocator->Allocate = PoolAllocate;
+	allocator->Deallocate = PoolDeallocate;
+	allocator->Destruct = PoolDestruct;
+
+	return allocator;
+}
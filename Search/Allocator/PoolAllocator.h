@@ -0,0 +1,25 @@
+#pragma once
+
+#include "IAllocator.h"
+
+//  PoolAllocator
+//    Fixed size blocks, O(1) Allocate and Deallocate through free list
+//    Blocks are taken from chunks allocated by backing allocator, chunks are freed in Destruct
+//    Allocation size and alignment must not be bigger than the block ones
+//    Not thread safe
+//    For debug, counting allocations
+
+struct PoolAllocator : public IAllocator {
+	size_t _blockSize;
+	size_t _blockAlignment;
+	int _blocksPerChunk;
+
+	void* _freeBlocks;
+	void* _chunks;
+
+	size_t _allocationsCount;
+
+	IAllocator* _backing;
+};
+
+IAllocator* InitPoolAllocator(PoolAllocator* allocator, IAllocator* backing, size_t blockSize, size_t blockAlignment, int blocksPerChunk);
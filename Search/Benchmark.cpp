@@ -0,0 +1,1205 @@
+#include "Benchmark.h"
+
+#include "Allocator/IAllocator.h"
+#include "Allocator/HeapAllocator.h"
+
+#include "Collection/BucketQueue.h"
+#include "Collection/MinPriorityQueue.h"
+#include "Collection/IndexedPriorityQueue.h"
+#include "Collection/UIntSet.h"
+#include "Collection/ChainedUIntSet.h"
+
+#include "Graph/SearchContext.h"
+#include "Graph/CompactSearchContext.h"
+#include "Graph/SparseSearchContext.h"
+#include "Graph/AStar.h"
+#include "Graph/BidirectionalAStar.h"
+#include "Graph/SearchStats.h"
+#include "Graph/JumpPointSearch.h"
+#include "Graph/PassabilityMap.h"
+#include "Graph/PaddedMap.h"
+#include "Graph/TiledMap.h"
+#include "Graph/PathBatch.h"
+#include "Graph/PathPostProcess.h"
+#include "Graph/HierarchicalMap.h"
+#include "Graph/IncrementalSearch.h"
+#include "Graph/ComponentMap.h"
+#include "Graph/WeightedAStar.h"
+
+#include "Map/MapGenerator.h"
+#include "Map/MovingAI.h"
+
+#include "Utility/Timer.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <time.h>
+
+#include <chrono>
+#include <thread>
+
+
+static const int HIERARCHICAL_CLUSTER_SIZE = 32;
+
+
+struct BenchmarkMap {
+	unsigned char* map;
+	int width;
+	int height;
+};
+
+enum class BenchmarkMapKind {
+	Random,
+	Open,
+	Maze,
+	Rooms
+};
+
+static const char* BenchmarkMapKindName(BenchmarkMapKind kind) {
+	switch (kind) {
+	case BenchmarkMapKind::Random: return "random";
+	case BenchmarkMapKind::Open:   return "open";
+	case BenchmarkMapKind::Maze:   return "maze";
+	case BenchmarkMapKind::Rooms:  return "rooms";
+	}
+	return "";
+}
+
+// Random kind uses density in percent
+static BenchmarkMap MakeMap(IAllocator* allocator, BenchmarkMapKind kind, int width, int height, int density, unsigned int seed) {
+	const int ROOM_SIZE = 16;
+
+	BenchmarkMap res = {static_cast<unsigned char*>(Allocate(allocator, width * height, alignof(unsigned char))), width, height};
+
+	switch (kind) {
+	case BenchmarkMapKind::Random: GenerateRandomMap(res.map, width, height, density, seed); break;
+	case BenchmarkMapKind::Open:   GenerateOpenMap(res.map, width, height, seed); break;
+	case BenchmarkMapKind::Maze:   GenerateMazeMap(allocator, res.map, width, height, seed); break;
+	case BenchmarkMapKind::Rooms:  GenerateRoomsMap(allocator, res.map, width, height, ROOM_SIZE, seed); break;
+	}
+
+	return res;
+}
+
+static BenchmarkMap MakeRandomMap(IAllocator* allocator, int width, int height, int density, unsigned int seed) {
+	return MakeMap(allocator, BenchmarkMapKind::Random, width, height, density, seed);
+}
+
+static int RandomPassableNode(const BenchmarkMap* map, unsigned int* random) {
+	return RandomPassableCell(map->map, map->width, map->height, random);
+}
+
+
+static void BenchmarkJumpPointSearch(IAllocator* allocator) {
+	const int QUERIES = 100;
+	const int sizes[] = {64, 256, 1024};
+	const int densities[] = {0, 10, 25};
+
+	SearchContext context;
+	context.Init(allocator);
+
+	printf("A* vs JPS (%d queries per map), JPS bits is JPS on PassabilityMap\n", QUERIES);
+	printf("%6s %8s | %12s %12s %8s | %10s %10s %10s\n", "size", "density", "A* expanded", "JPS expanded", "ratio", "A* ms", "JPS ms", "bits ms");
+
+	for (int size : sizes) {
+		for (int density : densities) {
+			BenchmarkMap map = MakeRandomMap(allocator, size, size, density, size * 100 + density);
+			int* buffer = static_cast<int*>(Allocate(allocator, size * size * sizeof(int), alignof(int)));
+
+			void* bitsMem = Allocate(allocator, PassabilityMapMemorySize(size, size), 8);
+			PassabilityMap bits = PassabilityMapMake(bitsMem, size, size);
+			PassabilityMapBuild(&bits, map.map);
+
+			long long visitedAStar = 0, visitedJPS = 0;
+			clock_t timeAStar = 0, timeJPS = 0, timeBits = 0;
+			int mismatches = 0;
+			SearchStats stats;
+			unsigned int random = size + density;
+
+			for (int i = 0; i < QUERIES; ++i) {
+				int start = RandomPassableNode(&map, &random);
+				int target = RandomPassableNode(&map, &random);
+
+				clock_t begin = clock();
+				int costAStar = FindPath(&context, start % size, start / size, target % size, target / size, map.map, size, size, buffer, size * size, &stats);
+				timeAStar += clock() - begin;
+				visitedAStar += stats.expandedCount;
+
+				begin = clock();
+				int costJPS = FindPathJPS(&context, start % size, start / size, target % size, target / size, map.map, size, size, buffer, size * size, &stats);
+				timeJPS += clock() - begin;
+				visitedJPS += stats.expandedCount;
+
+				begin = clock();
+				int costBits = FindPathJPS(&context, start % size, start / size, target % size, target / size, &bits, buffer, size * size);
+				timeBits += clock() - begin;
+
+				if (costAStar != costJPS || costAStar != costBits)
+					++mismatches;
+			}
+
+			printf("%6d %7d%% | %12lld %12lld %7.2fx | %10.2f %10.2f %10.2f\n", size, density, visitedAStar, visitedJPS,
+				visitedJPS ? (double) visitedAStar / visitedJPS : 0.0,
+				timeAStar * 1000.0 / CLOCKS_PER_SEC, timeJPS * 1000.0 / CLOCKS_PER_SEC, timeBits * 1000.0 / CLOCKS_PER_SEC);
+
+			if (mismatches)
+				printf("ERROR: %d path costs differ\n", mismatches);
+
+			Deallocate(allocator, bitsMem);
+			Deallocate(allocator, buffer);
+			Deallocate(allocator, map.map);
+		}
+	}
+	printf("\n");
+}
+
+
+static void BenchmarkPathBatch(IAllocator* allocator) {
+	const int SIZE = 512;
+	const int QUERIES = 2000;
+	const int BUFFER_SIZE = SIZE * SIZE;
+
+	BenchmarkMap map = MakeRandomMap(allocator, SIZE, SIZE, 20, 7);
+	unsigned int random = 7;
+
+	PathQuery* queries = static_cast<PathQuery*>(Allocate(allocator, QUERIES * sizeof(PathQuery), alignof(PathQuery)));
+	int* buffer = static_cast<int*>(Allocate(allocator, BUFFER_SIZE * sizeof(int), alignof(int)));
+
+	// Only costs are compared, paths share one buffer (written only when they fit, queries are short)
+	for (int i = 0; i < QUERIES; ++i) {
+		int start = RandomPassableNode(&map, &random);
+		int target = RandomPassableNode(&map, &random);
+
+		PathQuery& query = queries[i];
+		query.startX = start % SIZE;
+		query.startY = start / SIZE;
+		query.targetX = target % SIZE;
+		query.targetY = target / SIZE;
+		query.outBuffer = buffer;
+		query.outBufferSize = 0;
+	}
+
+	int threads = (int) std::thread::hardware_concurrency();
+	if (threads < 1)
+		threads = 1;
+
+	printf("FindPathBatch %dx%d map, %d queries\n", SIZE, SIZE, QUERIES);
+	printf("%8s | %12s %8s\n", "workers", "queries/s", "speedup");
+
+	double single = 0.0;
+	for (int workersCount = 1; ; workersCount = workersCount * 2 < threads ? workersCount * 2 : threads) {
+		PathBatchWorkers workers;
+		workers.Init(allocator, workersCount);
+
+		// Warm up, contexts allocate memory for the map
+		FindPathBatch(&workers, map.map, SIZE, SIZE, queries, workersCount * 4);
+
+		auto begin = std::chrono::steady_clock::now();
+		FindPathBatch(&workers, map.map, SIZE, SIZE, queries, QUERIES);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+		double queriesPerSecond = QUERIES / seconds;
+		if (workersCount == 1)
+			single = queriesPerSecond;
+
+		printf("%8d | %12.0f %7.2fx\n", workersCount, queriesPerSecond, queriesPerSecond / single);
+
+		if (workersCount == threads)
+			break;
+	}
+	printf("\n");
+
+	Deallocate(allocator, buffer);
+	Deallocate(allocator, queries);
+	Deallocate(allocator, map.map);
+}
+
+
+// Cells are blocked and opened again (every other change), path is repaired and compared with A* from scratch
+// Changed cells are random cells of map or cells on current path
+static void BenchmarkIncrementalChanges(IAllocator* allocator, const char* mapName, BenchmarkMap* map, int start, int target, bool onPath) {
+	const int CHANGES = 50;
+
+	const int width = map->width;
+	const int height = map->height;
+
+	int* buffer = static_cast<int*>(Allocate(allocator, width * height * sizeof(int), alignof(int)));
+
+	SearchContext context;
+	context.Init(allocator);
+
+	IncrementalSearch search;
+	search.Init(allocator);
+	search.Begin(map->map, width, height, target % width, target / width);
+
+	SearchStats stats;
+	search.FindPath(start % width, start / width, buffer, width * height, &stats);
+
+	long long int expanded = 0, expandedAStar = 0;
+	double seconds = 0.0, secondsAStar = 0.0;
+	int mismatches = 0;
+
+	unsigned int random = 7;
+	int blocked = -1;
+	for (int i = 0; i < CHANGES; ++i) {
+		int cost = search.FindPath(start % width, start / width, buffer, width * height);
+
+		int cell;
+		if (blocked >= 0) {
+			cell = blocked;
+			blocked = -1;
+		}
+		else if (onPath && cost != SearchContext::INFINITE_COST && cost > 2) {
+			random = random * 1103515245u + 12345u;
+			cell = blocked = buffer[1 + (int) ((random >> 8) % (cost - 2))];
+		}
+		else {
+			cell = blocked = RandomPassableNode(map, &random);
+			if (cell == start || cell == target)
+				cell = blocked = -1;
+		}
+
+		if (cell < 0)
+			continue;
+
+		map->map[cell] = !map->map[cell];
+
+		auto begin = std::chrono::steady_clock::now();
+		search.UpdateCells(&cell, 1);
+		cost = search.FindPath(start % width, start / width, buffer, width * height, &stats);
+		seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+		expanded += stats.expandedCount;
+
+		begin = std::chrono::steady_clock::now();
+		int costAStar = FindPath(&context, start % width, start / width, target % width, target / width, map->map, width, height, buffer, width * height, &stats);
+		secondsAStar += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+		expandedAStar += stats.expandedCount;
+
+		if (cost != costAStar)
+			++mismatches;
+	}
+
+	const char* changes = onPath ? "on path" : "random";
+	printf("%-8s %-8s | %-12s | %15.1f %10.3f\n", mapName, changes, "incremental", (double) expanded / CHANGES, seconds * 1000.0 / CHANGES);
+	printf("%-8s %-8s | %-12s | %15.1f %10.3f\n", mapName, changes, "A* scratch", (double) expandedAStar / CHANGES, secondsAStar * 1000.0 / CHANGES);
+
+	if (mismatches)
+		printf("ERROR: %d path costs differ\n", mismatches);
+
+	Deallocate(allocator, buffer);
+}
+
+static void BenchmarkIncrementalSearch(IAllocator* allocator) {
+	const int SIZE = 1024;
+	const BenchmarkMapKind kinds[] = {BenchmarkMapKind::Rooms, BenchmarkMapKind::Random};
+
+	printf("IncrementalSearch %dx%d maps, cell changes (block and open again) and repair vs A* from scratch\n", SIZE, SIZE);
+	printf("%-8s %-8s | %-12s | %15s %10s\n", "map", "changes", "search", "expanded/change", "ms/change");
+
+	for (BenchmarkMapKind kind : kinds) {
+		BenchmarkMap map = MakeMap(allocator, kind, SIZE, SIZE, 20, 5);
+
+		// Start and target in opposite corners, path crosses map
+		unsigned int random = 5;
+		int start, target;
+		do {
+			start = RandomPassableNode(&map, &random);
+		} while (start % SIZE >= SIZE / 4 || start / SIZE >= SIZE / 4);
+		do {
+			target = RandomPassableNode(&map, &random);
+		} while (target % SIZE < SIZE * 3 / 4 || target / SIZE < SIZE * 3 / 4);
+
+		BenchmarkIncrementalChanges(allocator, BenchmarkMapKindName(kind), &map, start, target, false);
+		BenchmarkIncrementalChanges(allocator, BenchmarkMapKindName(kind), &map, start, target, true);
+
+		Deallocate(allocator, map.map);
+	}
+	printf("\n");
+}
+
+
+// Queries between different components (A* searches whole component of start) and label updates vs rebuild
+static void BenchmarkComponentMap(IAllocator* allocator) {
+	const int SIZE = 1024;
+	const int QUERIES = 200;
+	const int CHANGES = 1000;
+	const int densities[] = {30, 40};
+
+	printf("ComponentMap %dx%d random maps, unreachable queries and cell changes\n", SIZE, SIZE);
+	printf("%-8s | %10s %10s | %14s %14s | %10s %12s\n", "density", "components", "build ms", "A* ms/query", "comp ms/query", "changes", "ms/change");
+
+	for (int density : densities) {
+		BenchmarkMap map = MakeRandomMap(allocator, SIZE, SIZE, density, 9);
+
+		SearchContext context;
+		context.Init(allocator);
+
+		ComponentMap components;
+		components.Init(allocator);
+
+		auto begin = std::chrono::steady_clock::now();
+		components.Build(map.map, SIZE, SIZE);
+		double buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+		// Pairs of passable cells in different components
+		int queries[2 * QUERIES];
+		int queriesCount = 0;
+		unsigned int random = 9;
+		for (int i = 0; i < 100 * QUERIES && queriesCount < QUERIES; ++i) {
+			int start = RandomPassableNode(&map, &random);
+			int target = RandomPassableNode(&map, &random);
+			if (!components.Connected(start, target)) {
+				queries[2 * queriesCount] = start;
+				queries[2 * queriesCount + 1] = target;
+				++queriesCount;
+			}
+		}
+
+		context.Begin(SIZE * SIZE);
+
+		int mismatches = 0;
+		double secondsAStar = 0.0, seconds = 0.0;
+		for (int i = 0; i < queriesCount; ++i) {
+			int start = queries[2 * i];
+			int target = queries[2 * i + 1];
+
+			begin = std::chrono::steady_clock::now();
+			int cost = FindPath(&context, start % SIZE, start / SIZE, target % SIZE, target / SIZE, map.map, SIZE, SIZE, nullptr, 0);
+			secondsAStar += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+			begin = std::chrono::steady_clock::now();
+			int costConnected = FindPathConnected(&context, &components, start % SIZE, start / SIZE, target % SIZE, target / SIZE, map.map, SIZE, SIZE, nullptr, 0);
+			seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+			if (cost != costConnected)
+				++mismatches;
+		}
+
+		// Cell is toggled and toggled back, every toggle updates labels
+		double secondsChanges = 0.0;
+		for (int i = 0; i < CHANGES; ++i) {
+			random = random * 1103515245u + 12345u;
+			int cell = (int) ((random >> 4) % (SIZE * SIZE));
+
+			for (int j = 0; j < 2; ++j) {
+				map.map[cell] = !map.map[cell];
+
+				begin = std::chrono::steady_clock::now();
+				components.UpdateCells(&context, &cell, 1);
+				secondsChanges += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+			}
+		}
+
+		printf("%-8d | %10d %10.3f | %14.3f %14.6f | %10d %12.6f\n", density, components.ComponentsCount(), buildSeconds * 1000.0,
+			secondsAStar * 1000.0 / queriesCount, seconds * 1000.0 / queriesCount, 2 * CHANGES, secondsChanges * 1000.0 / (2 * CHANGES));
+
+		if (mismatches)
+			printf("ERROR: %d path costs differ\n", mismatches);
+
+		Deallocate(allocator, map.map);
+	}
+	printf("\n");
+}
+
+static void BenchmarkPathOutput(IAllocator* allocator) {
+	const int SIZE = 1024;
+	const int QUERIES = 100;
+	const BenchmarkMapKind kinds[] = {BenchmarkMapKind::Random, BenchmarkMapKind::Open, BenchmarkMapKind::Maze, BenchmarkMapKind::Rooms};
+
+	printf("Path outputs on %dx%d maps (%d queries), bytes per path and ms per path of post process\n", SIZE, SIZE, QUERIES);
+	printf("%-8s | %10s %10s %10s %10s | %10s %10s %10s\n", "map", "raw B", "segments B", "waypoint B", "smooth B", "segments", "waypoints", "smooth");
+
+	SearchContext context;
+	context.Init(allocator);
+
+	int* path = static_cast<int*>(Allocate(allocator, SIZE * SIZE * sizeof(int), alignof(int)));
+	int* waypoints = static_cast<int*>(Allocate(allocator, SIZE * SIZE * sizeof(int), alignof(int)));
+	PathSegment* segments = static_cast<PathSegment*>(Allocate(allocator, SIZE * SIZE * sizeof(PathSegment), alignof(PathSegment)));
+
+	for (BenchmarkMapKind kind : kinds) {
+		BenchmarkMap map = MakeMap(allocator, kind, SIZE, SIZE, 20, 21);
+
+		long long rawCount = 0, segmentsCount = 0, waypointsCount = 0, smoothCount = 0;
+		double segmentsSeconds = 0.0, waypointsSeconds = 0.0, smoothSeconds = 0.0;
+		int pathsCount = 0;
+		unsigned int random = 21;
+
+		for (int i = 0; i < QUERIES; ++i) {
+			int start = RandomPassableNode(&map, &random);
+			int target = RandomPassableNode(&map, &random);
+
+			int cost = FindPath(&context, start % SIZE, start / SIZE, target % SIZE, target / SIZE, map.map, SIZE, SIZE, path, SIZE * SIZE);
+			if (cost == SearchContext::INFINITE_COST)
+				continue;
+
+			++pathsCount;
+			rawCount += cost;
+
+			auto begin = std::chrono::steady_clock::now();
+			segmentsCount += PathToSegments(path, cost, start, SIZE, segments, SIZE * SIZE);
+			segmentsSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+			begin = std::chrono::steady_clock::now();
+			waypointsCount += PathToWaypoints(path, cost, start, SIZE, waypoints, SIZE * SIZE);
+			waypointsSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+			begin = std::chrono::steady_clock::now();
+			smoothCount += PathSmooth(path, cost, start, map.map, SIZE, SIZE, waypoints, SIZE * SIZE);
+			smoothSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+		}
+
+		if (pathsCount) {
+			printf("%-8s | %10.1f %10.1f %10.1f %10.1f | %10.4f %10.4f %10.4f\n", BenchmarkMapKindName(kind),
+				(double) rawCount * sizeof(int) / pathsCount, (double) segmentsCount * sizeof(PathSegment) / pathsCount,
+				(double) waypointsCount * sizeof(int) / pathsCount, (double) smoothCount * sizeof(int) / pathsCount,
+				segmentsSeconds * 1000.0 / pathsCount, waypointsSeconds * 1000.0 / pathsCount, smoothSeconds * 1000.0 / pathsCount);
+		}
+
+		Deallocate(allocator, map.map);
+	}
+	printf("\n");
+
+	Deallocate(allocator, segments);
+	Deallocate(allocator, waypoints);
+	Deallocate(allocator, path);
+}
+
+// Open list with DecreaseKey vs duplicate insert, passable cells get random cost 1 .. 9
+static void BenchmarkWeightedGrids(IAllocator* allocator) {
+	const int QUERIES = 100;
+	const int sizes[] = {256, 1024};
+	const BenchmarkMapKind kinds[] = {BenchmarkMapKind::Random, BenchmarkMapKind::Open, BenchmarkMapKind::Rooms};
+
+	printf("Weighted A* (cell cost 1 .. 9, %d queries per map), indexed open list (DecreaseKey) vs duplicate insert\n", QUERIES);
+	printf("%-8s %6s %-10s | %10s %10s %10s %10s\n", "map", "size", "open list", "ms", "expanded", "pushed", "peak open");
+
+	SearchContext context;
+	context.Init(allocator);
+
+	IndexedPriorityQueue indexed;
+	indexed.Init(allocator);
+
+	MinPriorityQueue<int> duplicates;
+	duplicates.Init(allocator);
+
+	for (int size : sizes) {
+		for (BenchmarkMapKind kind : kinds) {
+			BenchmarkMap map = MakeMap(allocator, kind, size, size, 20, 23);
+
+			unsigned int random = 23;
+			for (int i = 0; i < size * size; ++i) {
+				random = random * 1103515245u + 12345u;
+				if (map.map[i])
+					map.map[i] = (unsigned char) (1 + (random >> 16) % 9);
+			}
+
+			int queries[2 * QUERIES];
+			for (int i = 0; i < QUERIES; ++i) {
+				queries[2 * i] = RandomPassableNode(&map, &random);
+				queries[2 * i + 1] = RandomPassableNode(&map, &random);
+			}
+
+			long long costs[2] = {0, 0};
+			for (int k = 0; k < 2; ++k) {
+				long long expanded = 0, pushed = 0, peakOpen = 0;
+				double seconds = 0.0;
+
+				for (int i = 0; i < QUERIES; ++i) {
+					int start = queries[2 * i];
+					int target = queries[2 * i + 1];
+
+					SearchStats stats;
+					auto begin = std::chrono::steady_clock::now();
+					int cost = k == 0 ?
+						FindPathWeighted(&context, &indexed, start % size, start / size, target % size, target / size, map.map, size, size, nullptr, 0, nullptr, &stats) :
+						FindPathWeighted(&context, &duplicates, start % size, start / size, target % size, target / size, map.map, size, size, nullptr, 0, nullptr, &stats);
+					seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+					if (cost != SearchContext::INFINITE_COST)
+						costs[k] += cost;
+
+					expanded += stats.expandedCount;
+					pushed += stats.pushedCount;
+					peakOpen += stats.peakOpenCount;
+				}
+
+				printf("%-8s %6d %-10s | %10.3f %10lld %10lld %10lld\n", BenchmarkMapKindName(kind), size, k == 0 ? "indexed" : "duplicates",
+					seconds * 1000.0 / QUERIES, expanded / QUERIES, pushed / QUERIES, peakOpen / QUERIES);
+			}
+
+			if (costs[0] != costs[1])
+				printf("ERROR: open lists found different path costs (%lld, %lld)\n", costs[0], costs[1]);
+
+			Deallocate(allocator, map.map);
+		}
+	}
+	printf("\n");
+}
+
+enum class BenchmarkSearch {
+	AStar,         // FindPath with MinPriorityQueue
+	AStarBucket,   // FindPath with BucketQueue
+	AStarHeap4,    // FindPath with MinPriorityQueue of 4 children per node
+	AStarHeap8,    // FindPath with MinPriorityQueue of 8 children per node
+	AStarPadded,   // FindPath on PaddedMap
+	AStarTiled,    // FindPath on TiledMap
+	AStarCompact,  // FindPath with CompactSearchContext (one byte per node, states cleared every 31st search)
+	AStarSparse,   // FindPath with SparseSearchContext (hash map of reached nodes)
+	Bidirectional, // FindPathBidirectional (two contexts)
+	JPSBits,       // FindPathJPS on PassabilityMap
+	Hierarchical   // FindPathHierarchical (HPA*), path can be longer
+};
+
+static const BenchmarkSearch ALL_SEARCHES[] = {BenchmarkSearch::AStar, BenchmarkSearch::AStarBucket, BenchmarkSearch::AStarHeap4,
+	BenchmarkSearch::AStarHeap8, BenchmarkSearch::AStarPadded, BenchmarkSearch::AStarTiled, BenchmarkSearch::AStarCompact, BenchmarkSearch::AStarSparse,
+	BenchmarkSearch::Bidirectional, BenchmarkSearch::JPSBits, BenchmarkSearch::Hierarchical};
+static const int ALL_SEARCHES_COUNT = sizeof(ALL_SEARCHES) / sizeof(ALL_SEARCHES[0]);
+
+struct BenchmarkResult {
+	double seconds;
+	long long int expandedCount;
+	long long int costsSum; // Found paths, same for all optimal searches on same queries
+	size_t memory;          // Peak of allocated memory of search (contexts, open list, passability, padded or hierarchical map)
+};
+
+static const char* BenchmarkSearchName(BenchmarkSearch search) {
+	switch (search) {
+	case BenchmarkSearch::AStar:       return "A*";
+	case BenchmarkSearch::AStarBucket: return "A* bucket";
+	case BenchmarkSearch::AStarHeap4:  return "A* heap4";
+	case BenchmarkSearch::AStarHeap8:  return "A* heap8";
+	case BenchmarkSearch::AStarPadded: return "A* padded";
+	case BenchmarkSearch::AStarTiled: return "A* tiled";
+	case BenchmarkSearch::AStarCompact: return "A* compact";
+	case BenchmarkSearch::AStarSparse: return "A* sparse";
+	case BenchmarkSearch::Bidirectional: return "A* bidir";
+	case BenchmarkSearch::JPSBits:     return "JPS bits";
+	case BenchmarkSearch::Hierarchical: return "HPA*";
+	}
+	return "";
+}
+
+// Queries are pairs of nodes (start, target), every search gets fresh context (its allocations are part of memory)
+static BenchmarkResult RunQueries(HeapAllocator* allocator, BenchmarkSearch search, const BenchmarkMap* map,
+	const int* queries, int queriesCount, int* buffer, int bufferSize) {
+
+	BenchmarkResult res = {0.0, 0, 0, 0};
+
+	size_t allocatedBefore = HeapAllocatorAllocatedSize(allocator);
+	HeapAllocatorResetPeak(allocator);
+
+	{
+		SearchContext context;
+		context.Init(allocator);
+
+		BucketQueue<int> bucketQueue;
+		bucketQueue.Init(allocator);
+
+		MinPriorityQueue<int, 4> heap4;
+		heap4.Init(allocator);
+
+		MinPriorityQueue<int, 8> heap8;
+		heap8.Init(allocator);
+
+		void* bitsMem = nullptr;
+		PassabilityMap bits = {};
+		if (search == BenchmarkSearch::JPSBits) {
+			bitsMem = Allocate(allocator, PassabilityMapMemorySize(map->width, map->height), 8);
+			bits = PassabilityMapMake(bitsMem, map->width, map->height);
+			PassabilityMapBuild(&bits, map->map);
+		}
+
+		void* paddedMem = nullptr;
+		PaddedMap padded = {};
+		if (search == BenchmarkSearch::AStarPadded) {
+			paddedMem = Allocate(allocator, PaddedMapMemorySize(map->width, map->height), 1);
+			padded = PaddedMapMake(paddedMem, map->width, map->height);
+			PaddedMapBuild(&padded, map->map);
+		}
+
+		void* tiledMem = nullptr;
+		TiledMap tiled = {};
+		if (search == BenchmarkSearch::AStarTiled) {
+			tiledMem = Allocate(allocator, TiledMapMemorySize(map->width, map->height), 64);
+			tiled = TiledMapMake(tiledMem, map->width, map->height);
+			TiledMapBuild(&tiled, map->map);
+		}
+
+		CompactSearchContext compactContext;
+		compactContext.Init(allocator);
+
+		SparseSearchContext sparseContext;
+		sparseContext.Init(allocator);
+
+		SearchContext abstractContext;
+		abstractContext.Init(allocator);
+
+		SearchContext backwardContext;
+		backwardContext.Init(allocator);
+
+		HierarchicalMap hierarchicalMap;
+		hierarchicalMap.Init(allocator);
+		if (search == BenchmarkSearch::Hierarchical)
+			hierarchicalMap.Build(&context, map->map, map->width, map->height, HIERARCHICAL_CLUSTER_SIZE);
+
+		// Node states are allocated and cleared before timing (memory is still counted)
+		int nodesCount = map->width * map->height;
+		if (search == BenchmarkSearch::AStarPadded)
+			nodesCount = PaddedMapIndicesCount(&padded);
+		else if (search == BenchmarkSearch::AStarTiled)
+			nodesCount = TiledMapIndicesCount(&tiled);
+		// Sparse context has no node states to prepare, it allocates during searches
+		if (search == BenchmarkSearch::AStarCompact)
+			compactContext.Begin(nodesCount);
+		else if (search != BenchmarkSearch::AStarSparse)
+			context.Begin(nodesCount);
+		if (search == BenchmarkSearch::Bidirectional)
+			backwardContext.Begin(map->width * map->height);
+
+		SearchStats stats;
+		auto begin = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < queriesCount; ++i) {
+			int start = queries[2 * i];
+			int target = queries[2 * i + 1];
+			int startX = start % map->width, startY = start / map->width;
+			int targetX = target % map->width, targetY = target / map->width;
+
+			int cost = 0;
+			switch (search) {
+			case BenchmarkSearch::AStar:
+				cost = FindPath(&context, startX, startY, targetX, targetY, map->map, map->width, map->height, buffer, bufferSize, &stats);
+				break;
+			case BenchmarkSearch::AStarBucket:
+				cost = FindPath(&context, &bucketQueue, startX, startY, targetX, targetY, map->map, map->width, map->height, buffer, bufferSize, &stats);
+				break;
+			case BenchmarkSearch::AStarHeap4:
+				cost = FindPath(&context, &heap4, startX, startY, targetX, targetY, map->map, map->width, map->height, buffer, bufferSize, &stats);
+				break;
+			case BenchmarkSearch::AStarHeap8:
+				cost = FindPath(&context, &heap8, startX, startY, targetX, targetY, map->map, map->width, map->height, buffer, bufferSize, &stats);
+				break;
+			case BenchmarkSearch::AStarPadded:
+				cost = FindPath(&context, startX, startY, targetX, targetY, &padded, buffer, bufferSize, &stats);
+				break;
+			case BenchmarkSearch::AStarTiled:
+				cost = FindPath(&context, startX, startY, targetX, targetY, &tiled, buffer, bufferSize, &stats);
+				break;
+			case BenchmarkSearch::AStarCompact:
+				cost = FindPath(&compactContext, startX, startY, targetX, targetY, map->map, map->width, map->height, buffer, bufferSize, &stats);
+				break;
+			case BenchmarkSearch::AStarSparse:
+				cost = FindPath(&sparseContext, startX, startY, targetX, targetY, map->map, map->width, map->height, buffer, bufferSize, &stats);
+				break;
+			case BenchmarkSearch::Bidirectional:
+				cost = FindPathBidirectional(&context, &backwardContext, startX, startY, targetX, targetY, map->map, map->width, map->height, buffer, bufferSize, &stats);
+				break;
+			case BenchmarkSearch::JPSBits:
+				cost = FindPathJPS(&context, startX, startY, targetX, targetY, &bits, buffer, bufferSize, &stats);
+				break;
+			case BenchmarkSearch::Hierarchical:
+				cost = FindPathHierarchical(&hierarchicalMap, &abstractContext, &context, startX, startY, targetX, targetY, map->map, buffer, bufferSize, &stats);
+				break;
+			}
+
+			res.expandedCount += stats.expandedCount;
+			if (cost != SearchContext::INFINITE_COST)
+				res.costsSum += cost;
+		}
+
+		res.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+		if (bitsMem)
+			Deallocate(allocator, bitsMem);
+		if (paddedMem)
+			Deallocate(allocator, paddedMem);
+		if (tiledMem)
+			Deallocate(allocator, tiledMem);
+	}
+
+	res.memory = HeapAllocatorPeakAllocatedSize(allocator) - allocatedBefore;
+	return res;
+}
+
+static void PrintResultsHeader() {
+	printf("%-8s %11s %7s | %-10s | %12s %12s %14s %12s %8s\n", "map", "size", "queries", "search", "queries/s", "ns/expanded", "expanded/query", "memory KB", "path %");
+}
+
+// Runs searches on the same queries, prints one line per search, first search has to be optimal
+static void BenchmarkQueries(HeapAllocator* allocator, const char* mapName, const BenchmarkMap* map, const int* queries, int queriesCount,
+	const BenchmarkSearch* searches, int searchesCount) {
+
+	// Path can have all cells of map
+	int bufferSize = map->width * map->height;
+	int* buffer = static_cast<int*>(Allocate(allocator, bufferSize * sizeof(int), alignof(int)));
+
+	long long int costsSum = 0;
+	for (int s = 0; s < searchesCount; ++s) {
+		BenchmarkSearch search = searches[s];
+		BenchmarkResult res = RunQueries(allocator, search, map, queries, queriesCount, buffer, bufferSize);
+
+		char size[32];
+		snprintf(size, sizeof(size), "%dx%d", map->width, map->height);
+
+		if (s == 0)
+			costsSum = res.costsSum;
+
+		// Path length compared to first (optimal) search
+		printf("%-8s %11s %7d | %-10s | %12.1f %12.2f %14.1f %12zu %8.2f\n", mapName, size, queriesCount, BenchmarkSearchName(search),
+			queriesCount / res.seconds,
+			res.expandedCount ? res.seconds * 1e9 / res.expandedCount : 0.0,
+			(double) res.expandedCount / queriesCount,
+			res.memory / 1024,
+			costsSum ? 100.0 * res.costsSum / costsSum : 100.0);
+
+		if (search != BenchmarkSearch::Hierarchical && costsSum != res.costsSum)
+			printf("ERROR: path costs differ from %s\n", BenchmarkSearchName(searches[0]));
+	}
+
+	Deallocate(allocator, buffer);
+}
+
+
+void BenchmarkSuite(int maxSize) {
+	const int MIN_SIZE = 32;
+	const int QUERIES_BUDGET = 16384; // Queries count is QUERIES_BUDGET / size (bigger maps have longer paths)
+	const int MIN_QUERIES = 2;
+	const int MAX_QUERIES = 500;
+	const int RANDOM_DENSITY = 20;
+
+	const BenchmarkMapKind kinds[] = {BenchmarkMapKind::Random, BenchmarkMapKind::Open, BenchmarkMapKind::Maze, BenchmarkMapKind::Rooms};
+
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	printf("Generated maps %dx%d - %dx%d, memory is peak of search allocations\n", MIN_SIZE, MIN_SIZE, maxSize, maxSize);
+	PrintResultsHeader();
+
+	for (BenchmarkMapKind kind : kinds) {
+		for (int size = MIN_SIZE; size <= maxSize; size *= 2) {
+			unsigned int seed = size * 31 + (unsigned int) kind;
+			BenchmarkMap map = MakeMap(&allocator, kind, size, size, RANDOM_DENSITY, seed);
+
+			int queriesCount = QUERIES_BUDGET / size;
+			queriesCount = queriesCount < MIN_QUERIES ? MIN_QUERIES : (queriesCount > MAX_QUERIES ? MAX_QUERIES : queriesCount);
+
+			int* queries = static_cast<int*>(Allocate(&allocator, 2 * queriesCount * sizeof(int), alignof(int)));
+			unsigned int random = seed;
+			for (int i = 0; i < 2 * queriesCount; ++i)
+				queries[i] = RandomPassableNode(&map, &random);
+
+			BenchmarkQueries(&allocator, BenchmarkMapKindName(kind), &map, queries, queriesCount, ALL_SEARCHES, ALL_SEARCHES_COUNT);
+
+			Deallocate(&allocator, queries);
+			Deallocate(&allocator, map.map);
+		}
+	}
+	printf("\n");
+
+	AllocatorDestruct(&allocator);
+}
+
+void BenchmarkLayouts(int width) {
+	const int QUERIES = 8;
+	const BenchmarkMapKind kinds[] = {BenchmarkMapKind::Random, BenchmarkMapKind::Open, BenchmarkMapKind::Rooms};
+	const BenchmarkSearch searches[] = {BenchmarkSearch::AStar, BenchmarkSearch::AStarPadded, BenchmarkSearch::AStarTiled, BenchmarkSearch::AStarCompact};
+
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	printf("Map layouts on %dx%d maps (row major, padded, 8x8 tiles, one byte node states), same queries\n", width, width);
+	PrintResultsHeader();
+
+	for (BenchmarkMapKind kind : kinds) {
+		unsigned int seed = width * 17 + (unsigned int) kind;
+		BenchmarkMap map = MakeMap(&allocator, kind, width, width, 20, seed);
+
+		// Long queries between opposite halves (vertical moves are the ones which leave cache line in row major layout)
+		int queries[2 * QUERIES];
+		unsigned int random = seed;
+		for (int i = 0; i < QUERIES; ++i) {
+			do {
+				queries[2 * i] = RandomPassableNode(&map, &random);
+			} while (queries[2 * i] / width >= width / 2);
+			do {
+				queries[2 * i + 1] = RandomPassableNode(&map, &random);
+			} while (queries[2 * i + 1] / width < width / 2);
+		}
+
+		BenchmarkQueries(&allocator, BenchmarkMapKindName(kind), &map, queries, QUERIES, searches, sizeof(searches) / sizeof(searches[0]));
+
+		Deallocate(&allocator, map.map);
+	}
+	printf("\n");
+
+	AllocatorDestruct(&allocator);
+}
+
+// Short queries on huge map, sparse context keeps states only of reached nodes
+// Compact context clears whole state array every 31st search (generation overflow), timing includes it
+// -> its time per query is amortized width * width / 31 bytes of memset, not only the nodes touched
+static void BenchmarkSparseQueries(int width) {
+	const int QUERIES = 100;
+	const int MAX_DISTANCE = 64;
+	const BenchmarkSearch searches[] = {BenchmarkSearch::AStar, BenchmarkSearch::AStarCompact, BenchmarkSearch::AStarSparse};
+
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	printf("Short queries (up to %d cells apart) on %dx%d maps, dense vs sparse node states\n", MAX_DISTANCE, width, width);
+	printf("Compact states are cleared every %d searches, amortized %d bytes per search are included\n",
+		(int) CompactSearchContext::MAX_GENERATION, width * width / (int) CompactSearchContext::MAX_GENERATION);
+	PrintResultsHeader();
+
+	BenchmarkMap map = MakeMap(&allocator, BenchmarkMapKind::Open, width, width, 0, 5);
+
+	int queries[2 * QUERIES];
+	unsigned int random = 5;
+	for (int i = 0; i < QUERIES; ++i) {
+		int start, target;
+		do {
+			start = RandomPassableNode(&map, &random);
+			target = RandomPassableNode(&map, &random);
+		} while (abs(start % width - target % width) + abs(start / width - target / width) > MAX_DISTANCE);
+
+		queries[2 * i] = start;
+		queries[2 * i + 1] = target;
+	}
+
+	BenchmarkQueries(&allocator, "open", &map, queries, QUERIES, searches, sizeof(searches) / sizeof(searches[0]));
+
+	Deallocate(&allocator, map.map);
+	printf("\n");
+
+	AllocatorDestruct(&allocator);
+}
+
+// Unique keys without array (bijection of 32 bit integers, murmur finalizer)
+static unsigned int SetKey(unsigned int i) {
+	i ^= i >> 16;
+	i *= 0x85EBCA6Bu;
+	i ^= i >> 13;
+	i *= 0xC2B2AE35u;
+	i ^= i >> 16;
+	return i;
+}
+
+struct SetResult {
+	double addSeconds;
+	double findSeconds;
+	double missSeconds;
+	double removeSeconds;
+	size_t memory;
+	unsigned int leftCount; // Elements left after all were removed
+	bool valid;
+};
+
+// Adds keys 0 .. count - 1, finds them, finds count missing keys and removes all, set has Find, Add, Remove interface
+template<typename Set>
+static SetResult RunSetOperations(HeapAllocator* allocator, unsigned int count) {
+	SetResult res = {0.0, 0.0, 0.0, 0.0, 0, 0, true};
+
+	size_t allocatedBefore = HeapAllocatorAllocatedSize(allocator);
+	HeapAllocatorResetPeak(allocator);
+
+	{
+		Set set;
+		set.Init(allocator);
+
+		auto begin = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < count; ++i)
+			set.Add(SetKey(i));
+		res.addSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+		unsigned int found = 0;
+		begin = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < count; ++i)
+			found += set.Find(SetKey(i));
+		res.findSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+		unsigned int missFound = 0;
+		begin = std::chrono::steady_clock::now();
+		for (unsigned int i = count; i < 2 * count; ++i)
+			missFound += set.Find(SetKey(i));
+		res.missSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+		res.memory = HeapAllocatorPeakAllocatedSize(allocator) - allocatedBefore;
+
+		begin = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < count; ++i)
+			set.Remove(SetKey(i));
+		res.removeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+		res.leftCount = set.Count();
+		res.valid = found == count && missFound == 0;
+	}
+
+	return res;
+}
+
+static void PrintSetResult(const char* name, unsigned int count, const SetResult* res) {
+	printf("%-8s %10u | %10.1f %10.1f %10.1f %10.1f | %12zu\n", name, count,
+		res->addSeconds * 1e9 / count, res->findSeconds * 1e9 / count, res->missSeconds * 1e9 / count, res->removeSeconds * 1e9 / count,
+		res->memory / 1024);
+
+	if (!res->valid)
+		printf("ERROR: %s returned wrong results\n", name);
+	if (res->leftCount)
+		printf("%s left %u elements after removing all\n", name, res->leftCount);
+}
+
+void BenchmarkSets(unsigned int maxCount) {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	printf("UIntSet (open addressing, SSE2 groups) vs ChainedUIntSet (previous), ns per operation, memory is peak\n");
+	printf("%-8s %10s | %10s %10s %10s %10s | %12s\n", "set", "count", "add", "find", "find miss", "remove", "memory KB");
+
+	for (unsigned long long count = 1000; count <= maxCount; count *= 10) {
+		SetResult res = RunSetOperations<UIntSet>(&allocator, (unsigned int) count);
+		PrintSetResult("UIntSet", (unsigned int) count, &res);
+
+		res = RunSetOperations<ChainedUIntSet>(&allocator, (unsigned int) count);
+		PrintSetResult("chained", (unsigned int) count, &res);
+	}
+	printf("\n");
+
+	AllocatorDestruct(&allocator);
+}
+
+// Range operations (one call, reserved memory, prefetching / heapify) vs the same done element by element
+static void BenchmarkBulkOperations(unsigned int maxCount) {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	printf("Range vs per element operations, ns per element\n");
+	printf("%10s | %10s %10s %10s %10s | %10s %10s %10s\n", "count", "set Add", "AddRange", "set Find", "FindRange",
+		"queue Add", "reserved", "AddRange");
+
+	for (unsigned long long count = 10000; count <= maxCount; count *= 10) {
+		unsigned int n = (unsigned int) count;
+		unsigned int* keys = static_cast<unsigned int*>(Allocate(&allocator, 2 * n * sizeof(unsigned int), alignof(unsigned int)));
+		bool* found = static_cast<bool*>(Allocate(&allocator, 2 * n * sizeof(bool), alignof(bool)));
+		for (unsigned int i = 0; i < 2 * n; ++i)
+			keys[i] = SetKey(i);
+
+		double seconds[7];
+		unsigned int foundCounts[2] = {0, 0};
+
+		{
+			UIntSet set;
+			set.Init(&allocator);
+			auto begin = std::chrono::steady_clock::now();
+			for (unsigned int i = 0; i < n; ++i)
+				set.Add(keys[i]);
+			seconds[0] = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+			// Second half of keys is not inside
+			begin = std::chrono::steady_clock::now();
+			for (unsigned int i = 0; i < 2 * n; ++i)
+				foundCounts[0] += set.Find(keys[i]);
+			seconds[2] = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+		}
+
+		{
+			UIntSet set;
+			set.Init(&allocator);
+			auto begin = std::chrono::steady_clock::now();
+			set.AddRange(keys, n);
+			seconds[1] = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+			begin = std::chrono::steady_clock::now();
+			foundCounts[1] = set.FindRange(keys, 2 * n, found);
+			seconds[3] = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+		}
+
+		{
+			MinPriorityQueue<unsigned int> q;
+			q.Init(&allocator);
+			auto begin = std::chrono::steady_clock::now();
+			for (unsigned int i = 0; i < n; ++i)
+				q.Add(i, keys[i]);
+			seconds[4] = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+		}
+
+		{
+			MinPriorityQueue<unsigned int> q;
+			q.Init(&allocator);
+			auto begin = std::chrono::steady_clock::now();
+			q.Reserve(n);
+			for (unsigned int i = 0; i < n; ++i)
+				q.Add(i, keys[i]);
+			seconds[5] = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+		}
+
+		{
+			MinPriorityQueue<unsigned int> q;
+			q.Init(&allocator);
+			auto begin = std::chrono::steady_clock::now();
+			q.AddRange(keys, keys, n);
+			seconds[6] = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+		}
+
+		printf("%10u | %10.1f %10.1f %10.1f %10.1f | %10.1f %10.1f %10.1f\n", n,
+			seconds[0] * 1e9 / n, seconds[1] * 1e9 / n, seconds[2] * 1e9 / (2 * n), seconds[3] * 1e9 / (2 * n),
+			seconds[4] * 1e9 / n, seconds[5] * 1e9 / n, seconds[6] * 1e9 / n);
+
+		if (foundCounts[0] != n || foundCounts[1] != n)
+			printf("ERROR: set found %u and %u of %u keys\n", foundCounts[0], foundCounts[1], n);
+
+		Deallocate(&allocator, found);
+		Deallocate(&allocator, keys);
+	}
+	printf("\n");
+
+	AllocatorDestruct(&allocator);
+}
+
+// Adds count keys with random weights and pops them all, returns seconds (false valid if pop order is not sorted)
+template<unsigned int Arity>
+static double RunHeapOperations(IAllocator* allocator, const unsigned int* weights, unsigned int count, bool* outValid) {
+	MinPriorityQueue<unsigned int, Arity> q;
+	q.Init(allocator);
+
+	auto begin = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < count; ++i)
+		q.Add(i, weights[i]);
+
+	unsigned int last = 0;
+	bool valid = true;
+	while (!q.Empty()) {
+		valid = valid && (unsigned int) q.FirstWeight() >= last;
+		last = q.FirstWeight();
+		q.PopFirst();
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+	*outValid = valid;
+	return seconds;
+}
+
+// Binary heap vs d-ary heaps (children in one cache line, branchless minimum of children)
+static void BenchmarkHeapArity(unsigned int maxCount) {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	printf("MinPriorityQueue children per node, ns per Add + PopFirst\n");
+	printf("%10s | %10s %10s %10s %10s\n", "count", "2", "4", "8", "16");
+
+	for (unsigned long long count = 1000; count <= maxCount; count *= 10) {
+		unsigned int n = (unsigned int) count;
+		unsigned int* weights = static_cast<unsigned int*>(Allocate(&allocator, n * sizeof(unsigned int), alignof(unsigned int)));
+		for (unsigned int i = 0; i < n; ++i)
+			weights[i] = SetKey(i) >> 8;
+
+		bool valid[4];
+		double seconds[4] = {
+			RunHeapOperations<2>(&allocator, weights, n, &valid[0]),
+			RunHeapOperations<4>(&allocator, weights, n, &valid[1]),
+			RunHeapOperations<8>(&allocator, weights, n, &valid[2]),
+			RunHeapOperations<16>(&allocator, weights, n, &valid[3])
+		};
+
+		printf("%10u | %10.1f %10.1f %10.1f %10.1f\n", n,
+			seconds[0] * 1e9 / n, seconds[1] * 1e9 / n, seconds[2] * 1e9 / n, seconds[3] * 1e9 / n);
+
+		if (!valid[0] || !valid[1] || !valid[2] || !valid[3])
+			printf("ERROR: heap popped weights out of order\n");
+
+		Deallocate(&allocator, weights);
+	}
+	printf("\n");
+
+	AllocatorDestruct(&allocator);
+}
+
+bool BenchmarkMovingAI(const char* mapPath, const char* scenarioPath) {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	MovingAIMap movingAIMap = {};
+	MovingAIScenario scenario = {};
+
+	bool loaded = MovingAILoadMap(&allocator, mapPath, &movingAIMap);
+	if (!loaded) {
+		printf("ERROR: cant load map %s\n", mapPath);
+	}
+	else if (!(loaded = MovingAILoadScenario(&allocator, scenarioPath, &scenario))) {
+		printf("ERROR: cant load scenario %s\n", scenarioPath);
+	}
+
+	if (loaded) {
+		BenchmarkMap map = {movingAIMap.map, movingAIMap.width, movingAIMap.height};
+
+		// Queries outside of map or on blocked cells are skipped
+		int* queries = static_cast<int*>(Allocate(&allocator, 2 * scenario.queriesCount * sizeof(int), alignof(int)));
+		int queriesCount = 0;
+		for (int i = 0; i < scenario.queriesCount; ++i) {
+			const MovingAIQuery& query = scenario.queries[i];
+			if (query.startX < 0 || query.startX >= map.width || query.startY < 0 || query.startY >= map.height ||
+				query.targetX < 0 || query.targetX >= map.width || query.targetY < 0 || query.targetY >= map.height)
+				continue;
+
+			int start = query.startX + query.startY * map.width;
+			int target = query.targetX + query.targetY * map.width;
+			if (!map.map[start] || !map.map[target])
+				continue;
+
+			queries[2 * queriesCount] = start;
+			queries[2 * queriesCount + 1] = target;
+			++queriesCount;
+		}
+
+		printf("MovingAI %s, %s (%d of %d queries)\n", mapPath, scenarioPath, queriesCount, scenario.queriesCount);
+		PrintResultsHeader();
+
+		if (queriesCount > 0)
+			BenchmarkQueries(&allocator, "movingai", &map, queries, queriesCount, ALL_SEARCHES, ALL_SEARCHES_COUNT);
+		printf("\n");
+
+		Deallocate(&allocator, queries);
+	}
+
+	MovingAIFreeScenario(&allocator, &scenario);
+	MovingAIFreeMap(&allocator, &movingAIMap);
+
+	AllocatorDestruct(&allocator);
+	return loaded;
+}
+
+
+void BenchmarkAll() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	BenchmarkJumpPointSearch(&allocator);
+
+	BenchmarkPathBatch(&allocator);
+
+	BenchmarkIncrementalSearch(&allocator);
+
+	BenchmarkComponentMap(&allocator);
+
+	BenchmarkPathOutput(&allocator);
+
+	BenchmarkWeightedGrids(&allocator);
+
+	BenchmarkSets(10000000);
+
+	BenchmarkBulkOperations(10000000);
+
+	BenchmarkHeapArity(10000000);
+
+	BenchmarkLayouts(4096);
+
+	BenchmarkSparseQueries(4096);
+
+	BenchmarkSuite(8192);
+
+#if PROFILE
+	ProfilerReport();
+#endif
+
+	AllocatorDestruct(&allocator);
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+
+void BenchmarkAll();
+
+// Generated maps (random, open, maze, rooms) from 32x32 to maxSize x maxSize, sizes are powers of two
+// Prints queries/s, ns per expanded node and peak memory of searches
+void BenchmarkSuite(int maxSize);
+
+// Row major, padded and tiled map layouts for A* on width x width maps (random, open, rooms)
+void BenchmarkLayouts(int width);
+
+// UIntSet against previous chained implementation, 1e3 .. maxCount elements (powers of ten)
+void BenchmarkSets(unsigned int maxCount);
+
+// Same as BenchmarkSuite on MovingAI map (.map) and scenario (.scen) files, false if files cant be loaded
+bool BenchmarkMovingAI(const char* mapPath, const char* scenarioPath);
@@ -22,6 +22,14 @@ inline bool BitArrayIs(BitArray* arr, int index) {
 	return arr->data[index >> 3] & (1 << (index & 7));
 }
 
+// Bits index * 64 .. index * 64 + 63, lowest bit is the first (little endian byte order)
+// Data has to be aligned to 8 bytes
+inline unsigned long long BitArrayWord64(const BitArray* arr, int index) {
+	assert(((index + 1) << 3) <= arr->capacity);
+	assert(((size_t) arr->data & 7) == 0);
+	return reinterpret_cast<const unsigned long long*>(arr->data)[index];
+}
+
 inline void BitArrayClear(BitArray* arr) {
 	MemSet(arr->data, 0, arr->capacity);
 }
\ No newline at end of file
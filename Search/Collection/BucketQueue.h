@@ -0,0 +1,305 @@
+#pragma once
+
+#include <cassert>
+
+#include "../Allocator/IAllocator.h"
+#include "../Utility/Move.h"
+#include "../Utility/Memory.h"
+
+//  BucketQueue
+//    Min priority queue with templated values and unsigned int weights, same interface as MinPriorityQueue
+//    Add and PopFirst are O(1) (amortized), if weights in queue are in small range (max - min)
+//    Made for A* on uniform cost grid, weights in open list are in range <f, f + 2>
+//    Values with the same weight are returned in LIFO order
+//
+//    Other INTERNAL implementation details:
+//      Weight w lives in bucket (w & (_bucketsCount - 1)), every bucket holds only one weight -> range < _bucketsCount
+//      When range grows, buckets are reallocated (count is power of two)
+//      _firstWeight is minimal weight in queue, _lastWeight is upper bound of weights in queue
+
+
+
+
+template<typename T>
+class BucketQueue {
+private:
+	static const unsigned int FIRST_BUCKETS_COUNT = 4;
+	static const unsigned int FIRST_ADD_CAPACITY = 16;
+
+	struct Bucket {
+		unsigned int count;
+		unsigned int capacity;
+		T* values;
+	};
+
+public:
+	BucketQueue();
+	~BucketQueue();
+
+	BucketQueue(const BucketQueue& oth) = delete;
+	BucketQueue& operator=(const BucketQueue& rhs) = delete;
+
+	void Init(IAllocator* allocator);
+
+	void Add(const T& value, unsigned int weight);
+	void Add(T&& value, unsigned int weight);
+
+	void PopFirst();
+
+	// Removes all values, keeps allocated memory for reuse
+	void Clear();
+
+	int FirstWeight() const;
+
+	const T& First() const;
+	T&& First();
+
+	bool Empty() const;
+
+	unsigned int Count() const;
+
+	// Count of memory reallocations since Init (for statistics)
+	unsigned int ReallocationsCount() const;
+
+private:
+	void ReallocateBuckets(unsigned int newBucketsCount);
+	void ReallocateBucket(Bucket* bucket, unsigned int newCapacity);
+
+	// Makes sure weight fits into buckets range, returns bucket for the weight
+	Bucket* PrepareBucket(unsigned int weight);
+
+private:
+	unsigned int _count;
+	unsigned int _firstWeight;
+	unsigned int _lastWeight;
+
+	unsigned int _bucketsCount;
+	Bucket* _buckets;
+
+	unsigned int _reallocationsCount;
+
+	IAllocator* _allocator;
+};
+
+
+
+
+
+
+
+
+template<typename T>
+inline BucketQueue<T>::BucketQueue() :
+	_count(0),
+	_firstWeight(0),
+	_lastWeight(0),
+	_bucketsCount(0),
+	_buckets(nullptr),
+	_reallocationsCount(0),
+	_allocator(nullptr) {
+}
+
+template<typename T>
+inline BucketQueue<T>::~BucketQueue() {
+	if (_buckets) {
+		for (unsigned int i = 0; i < _bucketsCount; ++i) {
+			Bucket& bucket = _buckets[i];
+			if (bucket.values) {
+				for (unsigned int j = 0; j < bucket.count; ++j) {
+					bucket.values[j].~T();
+				}
+
+				Deallocate(_allocator, bucket.values);
+			}
+		}
+
+		Deallocate(_allocator, _buckets);
+	}
+}
+
+template<typename T>
+inline void BucketQueue<T>::Init(IAllocator* allocator) {
+	assert(!_allocator);
+	_allocator = allocator;
+}
+
+template<typename T>
+inline void BucketQueue<T>::Add(const T& value, unsigned int weight) {
+	Bucket* bucket = PrepareBucket(weight);
+	bucket->values[bucket->count++] = value;
+}
+
+template<typename T>
+inline void BucketQueue<T>::Add(T&& value, unsigned int weight) {
+	Bucket* bucket = PrepareBucket(weight);
+	bucket->values[bucket->count++] = Move(value);
+}
+
+template<typename T>
+inline int BucketQueue<T>::FirstWeight() const {
+	assert(!Empty());
+	return _firstWeight;
+}
+
+template<typename T>
+inline const T& BucketQueue<T>::First() const {
+	assert(!Empty());
+	const Bucket& bucket = _buckets[_firstWeight & (_bucketsCount - 1)];
+	assert(bucket.count > 0);
+	return bucket.values[bucket.count - 1];
+}
+
+template<typename T>
+inline T&& BucketQueue<T>::First() {
+	assert(!Empty());
+	Bucket& bucket = _buckets[_firstWeight & (_bucketsCount - 1)];
+	assert(bucket.count > 0);
+	return Move(bucket.values[bucket.count - 1]);
+}
+
+template<typename T>
+inline bool BucketQueue<T>::Empty() const {
+	return _count == 0;
+}
+
+template<typename T>
+inline unsigned int BucketQueue<T>::Count() const {
+	return _count;
+}
+
+template<typename T>
+inline unsigned int BucketQueue<T>::ReallocationsCount() const {
+	return _reallocationsCount;
+}
+
+template<typename T>
+inline void BucketQueue<T>::PopFirst() {
+	assert(!Empty());
+
+	unsigned int mask = _bucketsCount - 1;
+	Bucket* bucket = &_buckets[_firstWeight & mask];
+	assert(bucket->count > 0);
+
+	--bucket->count;
+	bucket->values[bucket->count].~T();
+
+	--_count;
+
+	if (_count == 0) {
+		_lastWeight = _firstWeight;
+		return;
+	}
+
+	// Range is smaller than buckets count, next non empty bucket is found in less than _bucketsCount steps
+	while (bucket->count == 0) {
+		++_firstWeight;
+		bucket = &_buckets[_firstWeight & mask];
+	}
+	assert(_firstWeight <= _lastWeight);
+}
+
+template<typename T>
+inline void BucketQueue<T>::Clear() {
+	for (unsigned int i = 0; i < _bucketsCount; ++i) {
+		Bucket& bucket = _buckets[i];
+		for (unsigned int j = 0; j < bucket.count; ++j) {
+			bucket.values[j].~T();
+		}
+
+		bucket.count = 0;
+	}
+
+	_count = 0;
+}
+
+template<typename T>
+inline typename BucketQueue<T>::Bucket* BucketQueue<T>::PrepareBucket(unsigned int weight) {
+	if (_count == 0) {
+		_firstWeight = weight;
+		_lastWeight = weight;
+	}
+
+	unsigned int first = weight < _firstWeight ? weight : _firstWeight;
+	unsigned int last = weight > _lastWeight ? weight : _lastWeight;
+
+	if (last - first >= _bucketsCount) {
+		unsigned int newBucketsCount = _bucketsCount == 0 ? FIRST_BUCKETS_COUNT : _bucketsCount;
+		while (last - first >= newBucketsCount)
+			newBucketsCount <<= 1;
+
+		ReallocateBuckets(newBucketsCount);
+	}
+
+	_firstWeight = first;
+	_lastWeight = last;
+
+	Bucket* bucket = &_buckets[weight & (_bucketsCount - 1)];
+	if (bucket->count == bucket->capacity)
+		ReallocateBucket(bucket, bucket->capacity == 0 ? FIRST_ADD_CAPACITY : bucket->capacity * 2);
+
+	++_count;
+	return bucket;
+}
+
+template<typename T>
+inline void BucketQueue<T>::ReallocateBuckets(unsigned int newBucketsCount) {
+	assert(_allocator);
+	assert(newBucketsCount > _bucketsCount);
+
+	Bucket* newBuckets = static_cast<Bucket*>(Allocate(_allocator, newBucketsCount * sizeof(Bucket), alignof(Bucket)));
+	MemSet(newBuckets, 0, newBucketsCount * sizeof(Bucket));
+
+	unsigned int oldMask = _bucketsCount - 1;
+	unsigned int newMask = newBucketsCount - 1;
+
+	// Buckets are moved with their memory, weight of old bucket i is the only weight in <_firstWeight, _firstWeight + oldCount) with same low bits
+	unsigned int freeBucket = 0;
+	for (unsigned int i = 0; i < _bucketsCount; ++i) {
+		Bucket& bucket = _buckets[i];
+		if (bucket.count == 0)
+			continue;
+
+		unsigned int weight = _firstWeight + ((i - _firstWeight) & oldMask);
+		newBuckets[weight & newMask] = bucket;
+		bucket.values = nullptr;
+	}
+
+	// Empty buckets keep their memory too, they are placed into unused new buckets
+	for (unsigned int i = 0; i < _bucketsCount; ++i) {
+		Bucket& bucket = _buckets[i];
+		if (!bucket.values)
+			continue;
+
+		while (newBuckets[freeBucket].values)
+			++freeBucket;
+
+		newBuckets[freeBucket] = bucket;
+	}
+
+	if (_buckets)
+		Deallocate(_allocator, _buckets);
+
+	_buckets = newBuckets;
+	_bucketsCount = newBucketsCount;
+	++_reallocationsCount;
+}
+
+template<typename T>
+inline void BucketQueue<T>::ReallocateBucket(Bucket* bucket, unsigned int newCapacity) {
+	assert(_allocator);
+
+	T* newValues = static_cast<T*>(Allocate(_allocator, newCapacity * sizeof(T), alignof(T)));
+
+	if (bucket->values) {
+		for (unsigned int i = 0; i < bucket->count; ++i) {
+			newValues[i] = Move(bucket->values[i]);
+			bucket->values[i].~T();
+		}
+
+		Deallocate(_allocator, bucket->values);
+	}
+
+	bucket->capacity = newCapacity;
+	bucket->values = newValues;
+	++_reallocationsCount;
+}
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <cassert>
+
+#include "../Allocator/IAllocator.h"
+#include "../Utility/Memory.h"
+
+//  IndexedPriorityQueue
+//    Min priority queue of keys 0 .. keysCount - 1 (graph nodes) with unsigned int weights, every key is inside at most once
+//    Position map (key -> heap slot) makes Contains O(1) and DecreaseKey / Remove O(log n)
+//    Weight of open node is decreased in place -> heap size is bounded by count of open nodes (no stale duplicates)
+//    Same First / PopFirst interface as MinPriorityQueue, keys are added by Add or DecreaseKey
+//
+//    Other INTERNAL implementation details:
+//      Keys not in queue have INVALID_POSITION, Clear resets only positions of keys in queue -> O(count)
+//      Begin reallocates position map only for bigger keysCount, heap grows by doubling (same as MinPriorityQueue)
+//      Equal weights are not ordered (keys move up only when parent is heavier)
+
+
+class IndexedPriorityQueue {
+private:
+	static const unsigned int FIRST_ADD_CAPACITY = 16;
+	static const unsigned int INVALID_POSITION = 0xFFffFFffu;
+
+public:
+	IndexedPriorityQueue();
+	~IndexedPriorityQueue();
+
+	IndexedPriorityQueue(const IndexedPriorityQueue& oth) = delete;
+	IndexedPriorityQueue& operator=(const IndexedPriorityQueue& rhs) = delete;
+
+	void Init(IAllocator* allocator);
+
+	// Clears queue, keys can be from 0 to keysCount - 1, memory is kept for the same or smaller keysCount
+	void Begin(int keysCount);
+
+	// Key must not be in queue
+	void Add(int key, unsigned int weight);
+
+	// Weight of key in queue must not be smaller than new weight
+	void DecreaseKey(int key, unsigned int weight);
+
+	// Adds key or decreases its weight, false if key is in queue with smaller or the same weight
+	bool AddOrDecreaseKey(int key, unsigned int weight);
+
+	bool Contains(int key) const;
+
+	// Key must be in queue
+	unsigned int Weight(int key) const;
+
+	// False if key was not in queue
+	bool Remove(int key);
+
+	void PopFirst();
+
+	// Removes all keys, keeps allocated memory for reuse
+	void Clear();
+
+	int FirstWeight() const;
+	int First() const;
+
+	bool Empty() const;
+
+	unsigned int Count() const;
+
+	// Count of memory reallocations since Init (for statistics)
+	unsigned int ReallocationsCount() const;
+
+private:
+	void ReallocateHeap(unsigned int newCapacity);
+
+	// Moves key with weight up from slot i / down from slot i, positions of moved keys are updated
+	void BubbleUp(unsigned int i, int key, unsigned int weight);
+	void SiftDown(unsigned int i, int key, unsigned int weight);
+
+	void SetSlot(unsigned int i, int key, unsigned int weight);
+
+private:
+	unsigned int _count;
+	unsigned int _capacity;
+	int _keysCount;
+	int _keysCapacity;
+	unsigned int _reallocationsCount;
+
+	int* _keys;
+	unsigned int* _weights;
+	unsigned int* _positions;
+
+	IAllocator* _allocator;
+};
+
+
+
+
+
+
+
+
+inline IndexedPriorityQueue::IndexedPriorityQueue() :
+	_count(0),
+	_capacity(0),
+	_keysCount(0),
+	_keysCapacity(0),
+	_reallocationsCount(0),
+	_keys(nullptr),
+	_weights(nullptr),
+	_positions(nullptr),
+	_allocator(nullptr) {
+}
+
+inline IndexedPriorityQueue::~IndexedPriorityQueue() {
+	if (_keys) {
+		Deallocate(_allocator, _keys);
+	}
+	if (_positions) {
+		Deallocate(_allocator, _positions);
+	}
+}
+
+inline void IndexedPriorityQueue::Init(IAllocator* allocator) {
+	assert(!_allocator);
+	_allocator = allocator;
+}
+
+inline void IndexedPriorityQueue::Begin(int keysCount) {
+	assert(_allocator);
+	assert(keysCount >= 0);
+
+	Clear();
+
+	if (keysCount > _keysCapacity) {
+		if (_positions) {
+			Deallocate(_allocator, _positions);
+		}
+
+		_positions = static_cast<unsigned int*>(Allocate(_allocator, keysCount * sizeof(unsigned int), alignof(unsigned int)));
+		_keysCapacity = keysCount;
+		++_reallocationsCount;
+
+		MemSet(_positions, 0xFF, keysCount * sizeof(unsigned int));
+	}
+
+	_keysCount = keysCount;
+}
+
+inline void IndexedPriorityQueue::Add(int key, unsigned int weight) {
+	assert(key >= 0 && key < _keysCount);
+	assert(!Contains(key));
+
+	if (_count == _capacity)
+		ReallocateHeap(_count == 0 ? FIRST_ADD_CAPACITY : _count * 2);
+
+	++_count;
+	BubbleUp(_count - 1, key, weight);
+}
+
+inline void IndexedPriorityQueue::DecreaseKey(int key, unsigned int weight) {
+	assert(Contains(key));
+	assert(weight <= Weight(key));
+
+	BubbleUp(_positions[key], key, weight);
+}
+
+inline bool IndexedPriorityQueue::AddOrDecreaseKey(int key, unsigned int weight) {
+	assert(key >= 0 && key < _keysCount);
+
+	unsigned int i = _positions[key];
+	if (i == INVALID_POSITION) {
+		Add(key, weight);
+		return true;
+	}
+
+	if (weight >= _weights[i])
+		return false;
+
+	BubbleUp(i, key, weight);
+	return true;
+}
+
+inline bool IndexedPriorityQueue::Contains(int key) const {
+	assert(key >= 0 && key < _keysCount);
+	return _positions[key] != INVALID_POSITION;
+}
+
+inline unsigned int IndexedPriorityQueue::Weight(int key) const {
+	assert(Contains(key));
+	return _weights[_positions[key]];
+}
+
+inline bool IndexedPriorityQueue::Remove(int key) {
+	assert(key >= 0 && key < _keysCount);
+
+	unsigned int i = _positions[key];
+	if (i == INVALID_POSITION)
+		return false;
+
+	_positions[key] = INVALID_POSITION;
+	--_count;
+
+	// Last key fills the hole, it can go up or down from there
+	if (i != _count) {
+		int lastKey = _keys[_count];
+		unsigned int lastWeight = _weights[_count];
+
+		if (i > 0 && _weights[(i - 1) >> 1] > lastWeight)
+			BubbleUp(i, lastKey, lastWeight);
+		else
+			SiftDown(i, lastKey, lastWeight);
+	}
+
+	return true;
+}
+
+inline void IndexedPriorityQueue::PopFirst() {
+	assert(!Empty());
+
+	_positions[_keys[0]] = INVALID_POSITION;
+	--_count;
+
+	if (_count != 0)
+		SiftDown(0, _keys[_count], _weights[_count]);
+}
+
+inline void IndexedPriorityQueue::Clear() {
+	for (unsigned int i = 0; i < _count; ++i) {
+		_positions[_keys[i]] = INVALID_POSITION;
+	}
+
+	_count = 0;
+}
+
+inline int IndexedPriorityQueue::FirstWeight() const {
+	assert(!Empty());
+	return _weights[0];
+}
+
+inline int IndexedPriorityQueue::First() const {
+	assert(!Empty());
+	return _keys[0];
+}
+
+inline bool IndexedPriorityQueue::Empty() const {
+	return _count == 0;
+}
+
+inline unsigned int IndexedPriorityQueue::Count() const {
+	return _count;
+}
+
+inline unsigned int IndexedPriorityQueue::ReallocationsCount() const {
+	return _reallocationsCount;
+}
+
+inline void IndexedPriorityQueue::BubbleUp(unsigned int i, int key, unsigned int weight) {
+	while (i != 0) {
+		unsigned int parent = (i - 1) >> 1;
+		if (_weights[parent] <= weight)
+			break;
+
+		SetSlot(i, _keys[parent], _weights[parent]);
+		i = parent;
+	}
+
+	SetSlot(i, key, weight);
+}
+
+inline void IndexedPriorityQueue::SiftDown(unsigned int i, int key, unsigned int weight) {
+	unsigned int left = (i << 1) + 1;
+	while (left < _count) {
+		unsigned int child = (left + 1 < _count && _weights[left + 1] < _weights[left]) ? left + 1 : left;
+		if (_weights[child] >= weight)
+			break;
+
+		SetSlot(i, _keys[child], _weights[child]);
+		i = child;
+		left = (i << 1) + 1;
+	}
+
+	SetSlot(i, key, weight);
+}
+
+inline void IndexedPriorityQueue::SetSlot(unsigned int i, int key, unsigned int weight) {
+	_keys[i] = key;
+	_weights[i] = weight;
+	_positions[key] = i;
+}
+
+inline void IndexedPriorityQueue::ReallocateHeap(unsigned int newCapacity) {
+	assert(_allocator);
+
+	size_t sizeNeeded = newCapacity * (sizeof(int) + sizeof(unsigned int));
+
+	int* newKeys = static_cast<int*>(Allocate(_allocator, sizeNeeded, alignof(int)));
+	unsigned int* newWeights = reinterpret_cast<unsigned int*>(newKeys + newCapacity);
+
+	if (_keys) {
+		MemCopy(newKeys, _keys, _count * sizeof(int));
+		MemCopy(newWeights, _weights, _count * sizeof(unsigned int));
+		Deallocate(_allocator, _keys);
+	}
+
+	_capacity = newCapacity;
+	_keys = newKeys;
+	_weights = newWeights;
+	++_reallocationsCount;
+}
@@ -2,15 +2,98 @@
 
 #include <cassert>
 
+#include "../Config.h"
 #include "../Allocator/IAllocator.h"
 #include "../Utility/Move.h"
 #include "../Utility/Memory.h"
+#include "../Utility/Util.h"
+
+#if SIMD_SSE4
+#include <smmintrin.h>
+#endif
+
+//  MinPriorityQueue
+//    Min priority queue with templated values and unsigned int weights, d-ary heap (Arity children per node)
+//    Arity 2 is binary heap, 4 or 8 has all children of node in one cache line and half / third of binary heap levels
+//    Minimum of children is found without branches (SSE4 for Arity 4 and 8, conditional moves otherwise)
+//
+//    Other INTERNAL implementation details:
+//      Values and weights are split arrays, only weights are read while sifting
+//      Weights are shifted by Arity - 1 slots from 64 byte aligned memory -> children of node (Arity * i + 1 ..)
+//      start on multiple of Arity slots, they never cross cache line
+//      Weights after the last value are PADDING (max weight) up to the end of the last children group,
+//      so children group is always read whole, padding is never the first minimum (real children are before it),
+//      except binary heap on max weights (it prefers right child on equal weights, same as before d-ary heap)
+
+template<unsigned int Arity>
+struct HeapMinChild {
+	// Offset of first minimal weight of group
+	static unsigned int Find(const unsigned int* group) {
+		unsigned int best = 0;
+		unsigned int bestWeight = group[0];
+		for (unsigned int i = 1; i < Arity; ++i) {
+			bool less = group[i] < bestWeight;
+			best = less ? i : best;
+			bestWeight = less ? group[i] : bestWeight;
+		}
+		return best;
+	}
+};
+
+// Binary heap prefers right child on equal weights (same order of equal weights as before d-ary heap)
+template<>
+struct HeapMinChild<2> {
+	static unsigned int Find(const unsigned int* group) {
+		return group[1] <= group[0] ? 1 : 0;
+	}
+};
+
+#if SIMD_SSE4
+
+template<>
+struct HeapMinChild<4> {
+	static unsigned int Find(const unsigned int* group) {
+		__m128i weights = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+
+		// Minimum in all lanes, lowest lane equal to it is the child
+		__m128i min = _mm_min_epu32(weights, _mm_shuffle_epi32(weights, _MM_SHUFFLE(2, 3, 0, 1)));
+		min = _mm_min_epu32(min, _mm_shuffle_epi32(min, _MM_SHUFFLE(1, 0, 3, 2)));
+
+		unsigned int mask = (unsigned int) _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(weights, min)));
+		return (unsigned int) CountTrailingZeros64(mask);
+	}
+};
+
+template<>
+struct HeapMinChild<8> {
+	static unsigned int Find(const unsigned int* group) {
+		__m128i low = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+		__m128i high = _mm_load_si128(reinterpret_cast<const __m128i*>(group + 4));
+
+		__m128i min = _mm_min_epu32(low, high);
+		min = _mm_min_epu32(min, _mm_shuffle_epi32(min, _MM_SHUFFLE(2, 3, 0, 1)));
+		min = _mm_min_epu32(min, _mm_shuffle_epi32(min, _MM_SHUFFLE(1, 0, 3, 2)));
+
+		unsigned int mask = (unsigned int) _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(low, min))) |
+			((unsigned int) _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(high, min))) << 4);
+		return (unsigned int) CountTrailingZeros64(mask);
+	}
+};
+
+#endif
 
 
-template<typename T>
+template<typename T, unsigned int Arity = 2>
 class MinPriorityQueue {
 private:
+	static_assert(Arity >= 2 && Arity <= 16 && (Arity & (Arity - 1)) == 0, "Children group has to fit into cache line");
+
 	static const unsigned int FIRST_ADD_CAPACITY = 16;
+	static const unsigned int CACHE_LINE = 64;
+	static const unsigned int PADDING = 0xFFffFFffu;
+
+	// Weights slots before the root, children groups start on multiple of Arity
+	static const unsigned int OFFSET = Arity - 1;
 
 public:
 	MinPriorityQueue();
@@ -24,8 +107,17 @@ public:
 	void Add(const T& value, unsigned int weight);
 	void Add(T&& value, unsigned int weight);
 
+	// Adds count values at once, big ranges are heapified together (Floyd, O(n)) instead of bubbling up one by one
+	void AddRange(const T* values, const unsigned int* weights, unsigned int count);
+
 	void PopFirst();
 
+	// Removes all values, keeps allocated memory for reuse
+	void Clear();
+
+	// Allocates memory for capacity values (no reallocation until Count reaches it)
+	void Reserve(unsigned int capacity);
+
 	int FirstWeight() const;
 
 	const T& First() const;
@@ -33,6 +125,11 @@ public:
 
 	bool Empty() const;
 
+	unsigned int Count() const;
+
+	// Count of memory reallocations since Init (for statistics)
+	unsigned int ReallocationsCount() const;
+
 private:
 	void Reallocate(unsigned int newCapacity);
 
@@ -40,9 +137,16 @@ private:
 	// Value has to be set on outIndex after the function is called
 	void BubbleUp(unsigned int weight, unsigned int& outIndex);
 
+	// Moves weight and value down from index i until its children have bigger weights, value is moved out
+	void SiftDown(unsigned int i, unsigned int weight, T& value);
+
+	// Weights slots allocated for capacity values (padding of the last children group included)
+	static size_t WeightsSize(unsigned int capacity);
+
 private:
 	unsigned int _count;
 	unsigned int _capacity;
+	unsigned int _reallocationsCount;
 
 	T* _values;
 	unsigned int* _weights;
@@ -57,123 +161,174 @@ private:
 
 
 
-template<typename T>
-inline MinPriorityQueue<T>::MinPriorityQueue() :
+template<typename T, unsigned int Arity>
+inline MinPriorityQueue<T, Arity>::MinPriorityQueue() :
 	_count(0),
 	_capacity(0),
-	_weights(nullptr),
+	_reallocationsCount(0),
 	_values(nullptr),
+	_weights(nullptr),
 	_allocator(nullptr) {
 }
 
-template<typename T>
-inline MinPriorityQueue<T>::~MinPriorityQueue() {
-	if (_values) {
+template<typename T, unsigned int Arity>
+inline MinPriorityQueue<T, Arity>::~MinPriorityQueue() {
+	if (_weights) {
 		for (unsigned int i = 0; i < _count; ++i) {
 			_values[i].~T();
 		}
 
-		Deallocate(_allocator, _values);
+		Deallocate(_allocator, _weights - OFFSET);
 	}
 }
 
-template<typename T>
-inline void MinPriorityQueue<T>::Init(IAllocator* allocator) {
+template<typename T, unsigned int Arity>
+inline void MinPriorityQueue<T, Arity>::Init(IAllocator* allocator) {
 	assert(!_allocator);
 	_allocator = allocator;
 }
 
 
-template<typename T>
-inline void MinPriorityQueue<T>::Add(const T& value, unsigned int weight) {
+template<typename T, unsigned int Arity>
+inline void MinPriorityQueue<T, Arity>::Add(const T& value, unsigned int weight) {
 	unsigned int index;
 	BubbleUp(weight, index);
 
 	_values[index] = value;
 }
 
-template<typename T>
-inline void MinPriorityQueue<T>::Add(T&& value, unsigned int weight) {
+template<typename T, unsigned int Arity>
+inline void MinPriorityQueue<T, Arity>::Add(T&& value, unsigned int weight) {
 	unsigned int index;
 	BubbleUp(weight, index);
 
 	_values[index] = Move(value);
 }
 
-template<typename T>
-inline int MinPriorityQueue<T>::FirstWeight() const {
+template<typename T, unsigned int Arity>
+inline void MinPriorityQueue<T, Arity>::AddRange(const T* values, const unsigned int* weights, unsigned int count) {
+	assert(count == 0 || (values && weights));
+
+	if (_count + count > _capacity)
+		Reallocate(_count + count);
+
+	// Heapify is O(count + _count), bubbling up O(count * log(_count + count)) -> heapify only for big ranges
+	if (count < _count) {
+		for (unsigned int i = 0; i < count; ++i)
+			Add(values[i], weights[i]);
+		return;
+	}
+
+	for (unsigned int i = 0; i < count; ++i) {
+		_values[_count + i] = values[i];
+		_weights[_count + i] = weights[i];
+	}
+	_count += count;
+
+	// From the last parent to the root
+	for (unsigned int i = _count > 1 ? (_count - 2) / Arity + 1 : 0; i > 0; --i) {
+		T value = Move(_values[i - 1]);
+		SiftDown(i - 1, _weights[i - 1], value);
+	}
+}
+
+template<typename T, unsigned int Arity>
+inline int MinPriorityQueue<T, Arity>::FirstWeight() const {
 	assert(!Empty());
 	return _weights[0];
 }
 
-template<typename T>
-inline const T& MinPriorityQueue<T>::First() const {
+template<typename T, unsigned int Arity>
+inline const T& MinPriorityQueue<T, Arity>::First() const {
 	assert(!Empty());
 	return _values[0];
 }
 
-template<typename T>
-inline T&& MinPriorityQueue<T>::First() {
+template<typename T, unsigned int Arity>
+inline T&& MinPriorityQueue<T, Arity>::First() {
 	assert(!Empty());
 	return Move(_values[0]);
 }
 
-template<typename T>
-inline bool MinPriorityQueue<T>::Empty() const {
+template<typename T, unsigned int Arity>
+inline bool MinPriorityQueue<T, Arity>::Empty() const {
 	return _count == 0;
 }
 
-template<typename T>
-inline void MinPriorityQueue<T>::PopFirst() {
+template<typename T, unsigned int Arity>
+inline unsigned int MinPriorityQueue<T, Arity>::Count() const {
+	return _count;
+}
+
+template<typename T, unsigned int Arity>
+inline unsigned int MinPriorityQueue<T, Arity>::ReallocationsCount() const {
+	return _reallocationsCount;
+}
+
+template<typename T, unsigned int Arity>
+inline void MinPriorityQueue<T, Arity>::PopFirst() {
 	assert(!Empty());
 
 	_values[0].~T();
 
 	--_count;
 
-	// last is "moved" to first position and bubling down
+	// last is "moved" to first position and bubling down, its slot becomes padding
 	unsigned int weight = _weights[_count];
 	T&& value = Move(_values[_count]);
+	_weights[_count] = PADDING;
 
-	unsigned int i = 0, left = 1, right = 2;
-	while (left < _count) {
-		if (right >= _count || _weights[left] < _weights[right]) {
-			if (_weights[left] <= weight) {   // last will stay "last"
-				_weights[i] = _weights[left];
-				_values[i] = Move(_values[left]);
-				i = left;
-			}
-			else {
-				break;
-			}
-		}
-		else {
-			if (_weights[right] <= weight) {
-				_weights[i] = _weights[right];
-				_values[i] = Move(_values[right]);
-				i = right;
-			}
-			else {
-				break;
-			}
-		}
-		left = (i << 1) + 1;
-		right = left + 1;
+	if (_count != 0)
+		SiftDown(0, weight, value);
+}
+
+template<typename T, unsigned int Arity>
+inline void MinPriorityQueue<T, Arity>::Clear() {
+	for (unsigned int i = 0; i < _count; ++i) {
+		_values[i].~T();
+	}
+
+	if (_count != 0)
+		MemSet(_weights, 0xFF, _count * sizeof(unsigned int));
+
+	_count = 0;
+}
+
+template<typename T, unsigned int Arity>
+inline void MinPriorityQueue<T, Arity>::Reserve(unsigned int capacity) {
+	if (capacity > _capacity)
+		Reallocate(capacity);
+}
+
+template<typename T, unsigned int Arity>
+inline void MinPriorityQueue<T, Arity>::SiftDown(unsigned int i, unsigned int weight, T& value) {
+	for (unsigned int first = Arity * i + 1; first < _count; first = Arity * i + 1) {
+		unsigned int child = first + HeapMinChild<Arity>::Find(_weights + first);
+
+		// Padding after the last child can win only tie of max weights (binary heap prefers right child)
+		if (child >= _count)
+			child = first;
+
+		if (_weights[child] > weight)   // last will stay "last" on equal weights
+			break;
+
+		_weights[i] = _weights[child];
+		_values[i] = Move(_values[child]);
+		i = child;
 	}
 
 	_weights[i] = weight;
 	_values[i] = Move(value);
 }
 
-template<typename T>
-inline void MinPriorityQueue<T>::BubbleUp(unsigned int weight, unsigned int& outIndex) {
+template<typename T, unsigned int Arity>
+inline void MinPriorityQueue<T, Arity>::BubbleUp(unsigned int weight, unsigned int& outIndex) {
 	if (_count == _capacity)
 		Reallocate(_count == 0 ? FIRST_ADD_CAPACITY : _count * 2);
 
 	unsigned int i = _count;
-	unsigned int parent = 0;
 	while (i != 0) {
-		parent = (i & 1) ? i >> 1 : (i >> 1) - 1; // i % 2 ? i/2 : i/2 - 1
+		unsigned int parent = (i - 1) / Arity;
 
 		if (_weights[parent] >= weight) { // Newer has priority
 			_values[i] = Move(_values[parent]);
@@ -191,14 +346,22 @@ inline void MinPriorityQueue<T>::BubbleUp(unsigned int weight, unsigned int& out
 	++_count;
 }
 
-template<typename T>
-inline void MinPriorityQueue<T>::Reallocate(unsigned int newCapacity) {
+template<typename T, unsigned int Arity>
+inline size_t MinPriorityQueue<T, Arity>::WeightsSize(unsigned int capacity) {
+	return (OFFSET + capacity + Arity) * sizeof(unsigned int);
+}
+
+template<typename T, unsigned int Arity>
+inline void MinPriorityQueue<T, Arity>::Reallocate(unsigned int newCapacity) {
 	assert(_allocator);
 
-	size_t sizeNeeded = newCapacity * (sizeof(T) + sizeof(unsigned int)) + alignof(unsigned int);
+	size_t weightsSize = WeightsSize(newCapacity);
+	size_t sizeNeeded = weightsSize + alignof(T) + newCapacity * sizeof(T);
 
-	T* newValues = static_cast<T*>(Allocate(_allocator, sizeNeeded, alignof(T)));
-	unsigned int* newWeights = static_cast<unsigned int*>(AlignForward(newValues + newCapacity, alignof(unsigned int)));
+	unsigned int* newWeights = static_cast<unsigned int*>(Allocate(_allocator, sizeNeeded, CACHE_LINE)) + OFFSET;
+	T* newValues = static_cast<T*>(AlignForward(newWeights - OFFSET + weightsSize / sizeof(unsigned int), alignof(T)));
+
+	MemSet(newWeights + _count, 0xFF, (newCapacity + Arity - _count) * sizeof(unsigned int));
 
 	if (_count != 0) {
 		for (unsigned int i = 0; i < _count; ++i) {
@@ -207,10 +370,14 @@ inline void MinPriorityQueue<T>::Reallocate(unsigned int newCapacity) {
 		}
 
 		MemCopy(newWeights, _weights, _count * sizeof(unsigned int));
-		Deallocate(_allocator, _values);
+	}
+
+	if (_weights) {
+		Deallocate(_allocator, _weights - OFFSET);
 	}
 
 	_capacity = newCapacity;
 	_values = newValues;
+	++_reallocationsCount;
 	_weights = newWeights;
 }
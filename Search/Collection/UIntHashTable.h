@@ -0,0 +1,394 @@
+#pragma once
+
+#include <cassert>
+#include <type_traits>
+
+#include "../Config.h"
+#include "../Allocator/IAllocator.h"
+#include "../Utility/Memory.h"
+#include "../Utility/Util.h"
+
+#if SIMD_SSE2
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#endif
+
+//  UIntHashTable
+//    Open addressing table of unsigned int keys with control byte per slot (Swiss table style), core of UIntSet and UIntMap
+//    Slot is key only (V = void, UIntSet) or key with trivially copyable value (UIntMap) -> value is in cache line of its key
+//    Lookup compares 16 control bytes at once (SSE2, scalar fallback), slots are read only on tag match
+//    Unsigned integral dont need extra templates for CompareFunc (bcs its trivial ==) or HashFunc (multiplicative hash)
+//    Signed integrals would be implementation dependant because of operator %. (They can still be converted by callee)
+//    Slot indices are valid until next Add, Remove or Reserve
+//
+//    Other INTERNAL implementation details:
+//      FULL RATIO == 0.875
+//      Linear probing from home slot (high bits of hash), control byte is EMPTY or 7 bit tag (remixed hash)
+//      Remove shifts following slots of the run back (no tombstones) -> probe always ends on first EMPTY
+//      Control bytes have GROUP_WIDTH - 1 bytes mirrored after the end -> group load near the end wraps around
+//      Growth moves slots into doubled table without lookups (keys are unique, only EMPTY is searched)
+//      Controls and slots are one allocation (slots after controls)
+
+
+template<typename V>
+struct UIntHashSlot {
+	unsigned int key;
+	V value;
+};
+
+template<>
+struct UIntHashSlot<void> {
+	unsigned int key;
+};
+
+
+template<typename V>
+class UIntHashTable {
+public:
+	typedef UIntHashSlot<V> Slot;
+
+	static const unsigned int INVALID_INDEX = 0xFFffFFffu;
+
+private:
+	static_assert(std::is_trivially_copyable<Slot>::value, "UIntHashTable slots are moved by copy");
+
+	static const unsigned int FIRST_ADD_CAPACITY = 16;
+	static const unsigned int GROUP_WIDTH = 16;
+
+	static const unsigned char EMPTY = 0x80;
+
+public:
+	UIntHashTable();
+	~UIntHashTable();
+
+	UIntHashTable(const UIntHashTable& oth) = delete;
+	UIntHashTable& operator=(const UIntHashTable& rhs) = delete;
+
+	void Init(IAllocator* allocator);
+
+	// Slot of key or INVALID_INDEX, outEmpty is first EMPTY of probe (if given and key is not inside)
+	unsigned int Find(unsigned int key, unsigned int* outEmpty = nullptr) const;
+
+	// Key must not be inside, emptyIndex is outEmpty of Find (or INVALID_INDEX), returns slot of added key
+	unsigned int Add(unsigned int emptyIndex, unsigned int key);
+
+	// Index is slot of key inside
+	void Remove(unsigned int index);
+
+	Slot& SlotAt(unsigned int index);
+	const Slot& SlotAt(unsigned int index) const;
+
+	// Removes all keys, keeps allocated memory for reuse
+	void Clear();
+
+	// Allocates memory for count keys (no reallocation until Count reaches it)
+	void Reserve(unsigned int count);
+
+	// Hint to load home control group and slot of key into cache
+	void Prefetch(unsigned int key) const;
+
+	unsigned int Count() const;
+	bool Empty() const;
+
+	// Allocated bytes (for statistics)
+	size_t MemorySize() const;
+
+	// Count of memory reallocations since Init (for statistics)
+	unsigned int ReallocationsCount() const;
+
+private:
+	void Reallocate(unsigned int newCapacity);
+
+	unsigned int Home(unsigned int hash) const;
+	unsigned int FindEmpty(unsigned int index) const;
+	void SetControl(unsigned int index, unsigned char control);
+
+	// Bit i is set for control byte i of group (at index) equal to control
+	unsigned int MatchGroup(unsigned int index, unsigned char control) const;
+
+	bool IsFull() const;
+
+	static unsigned int Hash(unsigned int key);
+	static unsigned char Tag(unsigned int hash);
+
+private:
+	unsigned int _count;
+	unsigned int _capacity;
+	unsigned int _capacityShift; // 32 - log2(_capacity)
+	unsigned int _reallocationsCount;
+
+	unsigned char* _controls;
+	Slot* _slots;
+
+	IAllocator* _allocator;
+};
+
+
+
+
+
+
+
+
+template<typename V>
+inline UIntHashTable<V>::UIntHashTable() :
+	_count(0),
+	_capacity(0),
+	_capacityShift(32),
+	_reallocationsCount(0),
+	_controls(nullptr),
+	_slots(nullptr),
+	_allocator(nullptr) {
+}
+
+template<typename V>
+inline UIntHashTable<V>::~UIntHashTable() {
+	if (_controls) {
+		Deallocate(_allocator, _controls);
+	}
+}
+
+template<typename V>
+inline void UIntHashTable<V>::Init(IAllocator* allocator) {
+	assert(!_allocator);
+	_allocator = allocator;
+}
+
+template<typename V>
+inline unsigned int UIntHashTable<V>::Find(unsigned int key, unsigned int* outEmpty) const {
+	if (outEmpty)
+		*outEmpty = INVALID_INDEX;
+
+	if (_capacity == 0)
+		return INVALID_INDEX;
+
+	assert(IsPowerOfTwo(_capacity));
+
+	const unsigned int mask = _capacity - 1;
+	unsigned int hash = Hash(key);
+	unsigned char tag = Tag(hash);
+
+	// Table is never full, probe ends on EMPTY
+	for (unsigned int group = Home(hash); ; group = (group + GROUP_WIDTH) & mask) {
+		unsigned int empties = MatchGroup(group, EMPTY);
+
+		// Tags after first EMPTY belong to other runs
+		unsigned int matches = MatchGroup(group, tag);
+		if (empties)
+			matches &= (empties & (0u - empties)) - 1;
+
+		for (; matches; matches &= matches - 1) {
+			unsigned int i = (group + CountTrailingZeros64(matches)) & mask;
+			if (_slots[i].key == key)
+				return i;
+		}
+
+		if (empties) {
+			if (outEmpty)
+				*outEmpty = (group + CountTrailingZeros64(empties)) & mask;
+			return INVALID_INDEX;
+		}
+	}
+}
+
+template<typename V>
+inline unsigned int UIntHashTable<V>::Add(unsigned int emptyIndex, unsigned int key) {
+	if (IsFull()) {
+		Reallocate(_capacity == 0 ? FIRST_ADD_CAPACITY : (_capacity << 1));
+		emptyIndex = FindEmpty(Home(Hash(key)));
+	}
+
+	assert(emptyIndex < _capacity);
+	assert(_controls[emptyIndex] == EMPTY);
+
+	_slots[emptyIndex].key = key;
+	SetControl(emptyIndex, Tag(Hash(key)));
+	++_count;
+
+	return emptyIndex;
+}
+
+template<typename V>
+inline void UIntHashTable<V>::Remove(unsigned int index) {
+	assert(index < _capacity);
+	assert(_controls[index] != EMPTY);
+
+	// Backward shift: slot of the run moves into the hole, if the hole is not before its home slot
+	const unsigned int mask = _capacity - 1;
+	unsigned int hole = index;
+	for (unsigned int i = (index + 1) & mask; _controls[i] != EMPTY; i = (i + 1) & mask) {
+		unsigned int home = Home(Hash(_slots[i].key));
+		if (((i - home) & mask) >= ((i - hole) & mask)) {
+			_slots[hole] = _slots[i];
+			SetControl(hole, _controls[i]);
+			hole = i;
+		}
+	}
+
+	SetControl(hole, EMPTY);
+	--_count;
+}
+
+template<typename V>
+inline typename UIntHashTable<V>::Slot& UIntHashTable<V>::SlotAt(unsigned int index) {
+	assert(index < _capacity);
+	return _slots[index];
+}
+
+template<typename V>
+inline const typename UIntHashTable<V>::Slot& UIntHashTable<V>::SlotAt(unsigned int index) const {
+	assert(index < _capacity);
+	return _slots[index];
+}
+
+template<typename V>
+inline void UIntHashTable<V>::Clear() {
+	if (_controls) {
+		MemSet(_controls, EMPTY, _capacity + GROUP_WIDTH - 1);
+	}
+	_count = 0;
+}
+
+template<typename V>
+inline void UIntHashTable<V>::Reserve(unsigned int count) {
+	if (count == 0)
+		return;
+
+	unsigned int capacity = _capacity == 0 ? FIRST_ADD_CAPACITY : _capacity;
+
+	// Same FULL RATIO as IsFull: count keys + one EMPTY
+	while (((unsigned long long) count + 1) * 8 > (unsigned long long) capacity * 7)
+		capacity <<= 1;
+
+	if (capacity != _capacity)
+		Reallocate(capacity);
+}
+
+template<typename V>
+inline void UIntHashTable<V>::Prefetch(unsigned int key) const {
+	if (_capacity == 0)
+		return;
+
+#if SIMD_SSE2
+	unsigned int home = Home(Hash(key));
+	_mm_prefetch(reinterpret_cast<const char*>(_controls + home), _MM_HINT_T0);
+	_mm_prefetch(reinterpret_cast<const char*>(_slots + home), _MM_HINT_T0);
+#else
+	(void) key;
+#endif
+}
+
+template<typename V>
+inline unsigned int UIntHashTable<V>::Count() const {
+	return _count;
+}
+
+template<typename V>
+inline bool UIntHashTable<V>::Empty() const {
+	return _count == 0;
+}
+
+template<typename V>
+inline size_t UIntHashTable<V>::MemorySize() const {
+	return _capacity ? _capacity + GROUP_WIDTH - 1 + alignof(Slot) + _capacity * sizeof(Slot) : 0;
+}
+
+template<typename V>
+inline unsigned int UIntHashTable<V>::ReallocationsCount() const {
+	return _reallocationsCount;
+}
+
+template<typename V>
+inline unsigned int UIntHashTable<V>::Home(unsigned int hash) const {
+	// High bits of multiplicative hash (low bits of key are mixed into them)
+	return (unsigned int) ((unsigned long long) hash >> _capacityShift);
+}
+
+template<typename V>
+inline unsigned int UIntHashTable<V>::FindEmpty(unsigned int index) const {
+	const unsigned int mask = _capacity - 1;
+	for (unsigned int group = index; ; group = (group + GROUP_WIDTH) & mask) {
+		unsigned int empties = MatchGroup(group, EMPTY);
+		if (empties)
+			return (group + CountTrailingZeros64(empties)) & mask;
+	}
+}
+
+template<typename V>
+inline void UIntHashTable<V>::SetControl(unsigned int index, unsigned char control) {
+	_controls[index] = control;
+	if (index < GROUP_WIDTH - 1)
+		_controls[_capacity + index] = control;
+}
+
+template<typename V>
+inline unsigned int UIntHashTable<V>::MatchGroup(unsigned int index, unsigned char control) const {
+	assert(index < _capacity);
+#if SIMD_SSE2
+	__m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_controls + index));
+	return (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char) control)));
+#else
+	unsigned int res = 0;
+	for (unsigned int i = 0; i < GROUP_WIDTH; ++i) {
+		if (_controls[index + i] == control)
+			res |= 1u << i;
+	}
+	return res;
+#endif
+}
+
+template<typename V>
+inline void UIntHashTable<V>::Reallocate(unsigned int newCapacity) {
+	assert(_allocator);
+	assert(IsPowerOfTwo(newCapacity) && newCapacity >= GROUP_WIDTH);
+
+	size_t controlsSize = newCapacity + GROUP_WIDTH - 1;
+	size_t sizeNeeded = controlsSize + alignof(Slot) + newCapacity * sizeof(Slot);
+
+	void* mem = Allocate(_allocator, sizeNeeded, GROUP_WIDTH);
+
+	unsigned char* oldControls = _controls;
+	Slot* oldSlots = _slots;
+	unsigned int oldCapacity = _capacity;
+
+	_controls = static_cast<unsigned char*>(mem);
+	_slots = static_cast<Slot*>(AlignForward(_controls + controlsSize, alignof(Slot)));
+	_capacity = newCapacity;
+	++_reallocationsCount;
+
+	_capacityShift = 32;
+	while ((1u << (32 - _capacityShift)) < newCapacity)
+		--_capacityShift;
+
+	MemSet(_controls, EMPTY, controlsSize);
+
+	if (oldControls) {
+		// Keys are unique, they only need empty slot (no lookups)
+		for (unsigned int i = 0; i < oldCapacity; ++i) {
+			if (oldControls[i] != EMPTY) {
+				unsigned int index = FindEmpty(Home(Hash(oldSlots[i].key)));
+				_slots[index] = oldSlots[i];
+				SetControl(index, oldControls[i]);
+			}
+		}
+
+		Deallocate(_allocator, oldControls);
+	}
+}
+
+template<typename V>
+inline bool UIntHashTable<V>::IsFull() const {
+	// count + 1 > capacity * 7 / 8, at least one EMPTY stays in table
+	return ((unsigned long long) _count + 1) * 8 > (unsigned long long) _capacity * 7;
+}
+
+template<typename V>
+inline unsigned int UIntHashTable<V>::Hash(unsigned int key) {
+	return 2654435769u * key;
+}
+
+template<typename V>
+inline unsigned char UIntHashTable<V>::Tag(unsigned int hash) {
+	// Home uses high bits of hash, tag is high 7 bits of hash mixed once more (independent of home)
+	return (unsigned char) ((hash * 0x85EBCA6Bu) >> 25);
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "UIntHashTable.h"
+
+//  UIntMap
+//    HashMap from unsigned int to trivially copyable V, UIntHashTable with key and value slots (see there)
+//    Returned value pointers are valid until next Insert or Remove
+
+
+template<typename V>
+class UIntMap {
+public:
+	UIntMap();
+
+	UIntMap(const UIntMap& oth) = delete;
+	UIntMap& operator=(const UIntMap& rhs) = delete;
+
+	void Init(IAllocator* allocator);
+
+	// Value of key, nullptr if key is not inside
+	V* Find(unsigned int key);
+	const V* Find(unsigned int key) const;
+
+	// Value of key, new key has uninitialized value (outInserted is true then)
+	V* Insert(unsigned int key, bool* outInserted = nullptr);
+
+	// False if key was not inside
+	bool Remove(unsigned int key);
+
+	// Removes all keys, keeps allocated memory for reuse
+	void Clear();
+
+	unsigned int Count() const;
+	bool Empty() const;
+
+	// Allocated bytes (for statistics)
+	size_t MemorySize() const;
+
+	// Count of memory reallocations since Init (for statistics)
+	unsigned int ReallocationsCount() const;
+
+private:
+	typedef UIntHashTable<V> Table;
+
+	Table _table;
+};
+
+
+
+
+
+
+
+
+template<typename V>
+inline UIntMap<V>::UIntMap() {
+}
+
+template<typename V>
+inline void UIntMap<V>::Init(IAllocator* allocator) {
+	_table.Init(allocator);
+}
+
+template<typename V>
+inline V* UIntMap<V>::Find(unsigned int key) {
+	unsigned int index = _table.Find(key);
+	return index != Table::INVALID_INDEX ? &_table.SlotAt(index).value : nullptr;
+}
+
+template<typename V>
+inline const V* UIntMap<V>::Find(unsigned int key) const {
+	unsigned int index = _table.Find(key);
+	return index != Table::INVALID_INDEX ? &_table.SlotAt(index).value : nullptr;
+}
+
+template<typename V>
+inline V* UIntMap<V>::Insert(unsigned int key, bool* outInserted) {
+	unsigned int empty = Table::INVALID_INDEX;
+	unsigned int index = _table.Find(key, &empty);
+
+	if (outInserted)
+		*outInserted = index == Table::INVALID_INDEX;
+
+	if (index == Table::INVALID_INDEX)
+		index = _table.Add(empty, key);
+
+	return &_table.SlotAt(index).value;
+}
+
+template<typename V>
+inline bool UIntMap<V>::Remove(unsigned int key) {
+	unsigned int index = _table.Find(key);
+	if (index == Table::INVALID_INDEX)
+		return false;
+
+	_table.Remove(index);
+	return true;
+}
+
+template<typename V>
+inline void UIntMap<V>::Clear() {
+	_table.Clear();
+}
+
+template<typename V>
+inline unsigned int UIntMap<V>::Count() const {
+	return _table.Count();
+}
+
+template<typename V>
+inline bool UIntMap<V>::Empty() const {
+	return _table.Empty();
+}
+
+template<typename V>
+inline size_t UIntMap<V>::MemorySize() const {
+	return _table.MemorySize();
+}
+
+template<typename V>
+inline unsigned int UIntMap<V>::ReallocationsCount() const {
+	return _table.ReallocationsCount();
+}
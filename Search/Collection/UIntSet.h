@@ -2,21 +2,14 @@
 
 #include <cassert>
 
-#include "../Allocator/IAllocator.h"
-#include "../Utility/Memory.h"
-#include "../Utility/Util.h"
+#include "UIntHashTable.h"
 
 //  UIntSet
-//    Very simple HashSet for unsigned int (easily extended to unsigned integrals: uchar, ushort, uint, ulong, ulonglong (void*))
-//    Unsigned integral dont need extra templates for CompareFunc (bcs its trivial ==) or HashFunc as they are hashes. (Not uniformly distributed?)
-//    Signed integrals would be implementation dependant because of operator %. (They can still be converted by callee)
+//    HashSet for unsigned int, UIntHashTable with key only slots (open addressing, SSE2 control groups)
 //
 //    Other INTERNAL implementation details:
-//      FULL RATIO == 0.6
-//      Using extra indices (_nexts) to faster look for correct values which had the same hash after operator %. (Extra memory, for faster traversing)
-//      FindRes _previous and _index are INVALID_INDEX  -> values count is 0
-//              _index is END_OF_CHAIN_INDEX            -> its not inside, (to ADD probing needs to be done from _previous)
-//              _index is good index                    -> res ? its on that index : can be added on that index
+//      FindRes _index is slot of value, or slot where value can be added (first EMPTY of probe)
+//      Range operations prefetch home slots PREFETCH_DISTANCE values ahead -> cache misses of consecutive values overlap
 
 
 
@@ -26,19 +19,14 @@ public:
 	// Content of the structure is used internaly, its given to user to speedup Find + Add / Remove combination (does only one find)
 	// Upon changing the UIntSet FindResult is invalid
 	struct FindResult {
-		unsigned int _previous;
 		unsigned int _index;
 	};
 
 private:
-	static const unsigned int FIRST_ADD_CAPACITY = 16;
-
-	static const unsigned int INVALID_INDEX      = 0xFFffFFffu;
-	static const unsigned int END_OF_CHAIN_INDEX    = 0xFFffFFfeu;
+	static const unsigned int PREFETCH_DISTANCE = 8;
 
 public:
 	UIntSet();
-	~UIntSet();
 
 	UIntSet(const UIntSet& oth) = delete;
 	UIntSet& operator=(const UIntSet& rhs) = delete;
@@ -53,26 +41,25 @@ public:
 
 	bool Find(unsigned int value, FindResult* outFindRes = nullptr) const;
 
-	unsigned int Count() const;
-	bool Empty() const;
+	// Same as Add / Find for every value, faster for big ranges of values that are not in cache
+	void AddRange(const unsigned int* values, unsigned int count);
 
-private:
-	void Reallocate(unsigned int newCapacity);
-	void Probe(FindResult* inOutFindRes) const;
+	// outFound[i] is set to Find(values[i]), returns count of found values
+	unsigned int FindRange(const unsigned int* values, unsigned int count, bool* outFound) const;
 
-	void InternalAdd(const FindResult* findRes, unsigned int value);
-	void InternalRemove(const FindResult* findRes);
+	// Removes all values, keeps allocated memory for reuse
+	void Clear();
 
-	bool IsFull() const;
+	// Allocates memory for count values (no reallocation until Count reaches it)
+	void Reserve(unsigned int count);
 
-private:
-	unsigned int _count;
-	unsigned int _capacity;
+	unsigned int Count() const;
+	bool Empty() const;
 
-	unsigned int* _values;
-	unsigned int* _nexts;
+private:
+	typedef UIntHashTable<void> Table;
 
-	IAllocator* _allocator;
+	Table _table;
 };
 
 
@@ -82,27 +69,16 @@ private:
 
 
 
-inline UIntSet::UIntSet() :
-	_count(0),
-	_capacity(0),
-	_nexts(nullptr),
-	_values(nullptr),
-	_allocator(nullptr) {
-}
-
-inline UIntSet::~UIntSet() {
-	if (_values) {
-		Deallocate(_allocator, _values);
-	}
+inline UIntSet::UIntSet() {
 }
 
 inline void UIntSet::Init(IAllocator* allocator) {
-	assert(!_allocator);
-	_allocator = allocator;
+	_table.Init(allocator);
 }
 
 inline void UIntSet::Add(const FindResult* findRes, unsigned int value) {
-	InternalAdd(findRes, value);
+	assert(findRes);
+	_table.Add(findRes->_index, value);
 }
 
 inline void UIntSet::Add(unsigned int value) {
@@ -110,163 +86,78 @@ inline void UIntSet::Add(unsigned int value) {
 	bool found = Find(value, &find);
 
 	if (!found) {
-		InternalAdd(&find, value);
+		_table.Add(find._index, value);
 	}
 }
 
-inline void UIntSet::InternalAdd(const FindResult* findRes, unsigned int value) {
-	assert(findRes);
-
-	FindResult find = *findRes;
-
-	if (IsFull()) {
-		Reallocate(_capacity == 0 ? FIRST_ADD_CAPACITY : (_capacity << 1));
-		Find(value, &find);
-	}
-
-	if (find._index == END_OF_CHAIN_INDEX) {
-		// The hash index was taken, probe for new spot
-		Probe(&find);
-	}
-	assert(find._index != INVALID_INDEX);
-
-	assert(find._index < _capacity);
-	_values[find._index] = value;
-	_nexts[find._index] = END_OF_CHAIN_INDEX;
-
-	if (find._previous != INVALID_INDEX) {
-		_nexts[find._previous] = find._index;
-	}
-	++_count;
-}
-
 inline void UIntSet::Remove(unsigned int value) {
-	FindResult find;
-	bool found = Find(value, &find);
+	unsigned int index = _table.Find(value);
 
-	if (found) {
-		InternalRemove(&find);
+	if (index != Table::INVALID_INDEX) {
+		_table.Remove(index);
 	}
 }
 
 inline void UIntSet::Remove(const FindResult* findRes, unsigned int value) {
 	assert(findRes);
-	assert(findRes->_index < _capacity);
-	assert(_values[findRes->_index] == value);
-	InternalRemove(findRes);
+	assert(_table.SlotAt(findRes->_index).key == value);
+	(void) value;
+	_table.Remove(findRes->_index);
 }
 
-inline void UIntSet::InternalRemove(const FindResult* findRes) {
-	assert(findRes);
-	assert(findRes->_index < _capacity);
-
-	if (findRes->_previous != INVALID_INDEX) {
-		assert(findRes->_previous < _capacity);
-		_nexts[findRes->_previous] = _nexts[findRes->_index];
-	}
-
-	_nexts[findRes->_index] = INVALID_INDEX;
-	--_count;
-}
-
-
 inline bool UIntSet::Find(unsigned int value, FindResult* outFindRes) const {
-	unsigned int index = INVALID_INDEX;
-	unsigned int prev = INVALID_INDEX;
-	bool found = false;
-
-	if (_capacity > 0) {
-		assert(IsPowerOfTwo(_capacity));
-		index = (2654435769u * value) & (_capacity - 1);
-
-		// Might be good idea to check collision count and reallocate if its too high 
-		while (_nexts[index] != INVALID_INDEX && _nexts[index] != END_OF_CHAIN_INDEX) {
-			if (_values[index] == value) {
-				found = true;
-				break;
-			}
-
-			prev = index;
-			index = _nexts[index];
-		}
-
-		if (_nexts[index] == END_OF_CHAIN_INDEX) {
-			found = _values[index] == value;
-			if (!found) {
-				prev = index;
-				index = END_OF_CHAIN_INDEX;
-			}
-		}
-	}
+	unsigned int empty = Table::INVALID_INDEX;
+	unsigned int index = _table.Find(value, &empty);
+	bool found = index != Table::INVALID_INDEX;
 
 	if (outFindRes) {
-		outFindRes->_index = index;
-		outFindRes->_previous = prev;
+		outFindRes->_index = found ? index : empty;
 	}
 
 	return found;
 }
 
-inline void UIntSet::Reallocate(unsigned int newCapacity) {
-	assert(_allocator);
+inline void UIntSet::AddRange(const unsigned int* values, unsigned int count) {
+	assert(count == 0 || values);
 
-	size_t sizeNeeded = newCapacity * (2 * sizeof(unsigned int)) + alignof(unsigned int);
+	// Reallocation in the middle would invalidate prefetched lines
+	Reserve(_table.Count() + count);
 
-	void* mem = Allocate(_allocator, sizeNeeded, alignof(unsigned int));
+	for (unsigned int i = 0; i < count; ++i) {
+		if (i + PREFETCH_DISTANCE < count)
+			_table.Prefetch(values[i + PREFETCH_DISTANCE]);
 
-	unsigned int* oldNexts = _nexts;
-	unsigned int* oldValues = _values;
-	unsigned int oldCapacity = _capacity;
-
-	_values = static_cast<unsigned int*>(mem);
-	_nexts = static_cast<unsigned int*>(AlignForward(static_cast<char*>(mem) + newCapacity * sizeof(unsigned int), alignof(unsigned int)));
-	_capacity = newCapacity;
-
-	for (unsigned int i = 0; i < _capacity; ++i) {
-		_nexts[i] = INVALID_INDEX; 
-	}
-
-	if (_count != 0) {
-		_count = 0;
-		// copy all, data arent contiguous
-		for (unsigned int i = 0; i < oldCapacity; ++i) {
-			if (oldNexts[i] != INVALID_INDEX)
-				Add(oldValues[i]);
-		}
-
-		Deallocate(_allocator, oldValues);
+		Add(values[i]);
 	}
 }
 
-inline void UIntSet::Probe(FindResult* inOutFindRes) const {
-	assert(inOutFindRes->_index == END_OF_CHAIN_INDEX);
+inline unsigned int UIntSet::FindRange(const unsigned int* values, unsigned int count, bool* outFound) const {
+	assert(count == 0 || (values && outFound));
 
-	for (unsigned int i = inOutFindRes->_previous + 1; i < _capacity; ++i) {
-		if (_nexts[i] == INVALID_INDEX) {
-			inOutFindRes->_index = i;
-			return;
-		}
-	}
+	unsigned int found = 0;
+	for (unsigned int i = 0; i < count; ++i) {
+		if (i + PREFETCH_DISTANCE < count)
+			_table.Prefetch(values[i + PREFETCH_DISTANCE]);
 
-	for (unsigned int i = 0; i < inOutFindRes->_previous; ++i) {
-		if (_nexts[i] == INVALID_INDEX) {
-			inOutFindRes->_index = i;
-			return;
-		}
+		outFound[i] = Find(values[i]);
+		found += outFound[i] ? 1 : 0;
 	}
 
-	assert(false);
+	return found;
 }
 
-inline bool UIntSet::IsFull() const {
-	const float FULL_RATIO = 0.6f;
-	return _count >= static_cast<unsigned int>(_capacity * FULL_RATIO);
+inline void UIntSet::Clear() {
+	_table.Clear();
+}
+
+inline void UIntSet::Reserve(unsigned int count) {
+	_table.Reserve(count);
 }
 
 inline unsigned int UIntSet::Count() const {
-	return _count;
+	return _table.Count();
 }
 
 inline bool UIntSet::Empty() const {
-	return _count == 0;
-}
\ No newline at end of file
+	return _table.Empty();
+}
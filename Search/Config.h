@@ -1,5 +1,39 @@
 #pragma once
  
+#if defined(_MSC_VER)
 #define MSVC 1
+#else
+#define MSVC 0
+#endif
+
+#if defined(_WIN32)
 #define WINDOWS 1
+#else
+#define WINDOWS 0
+#endif
+
 #define PROFILE 1
+
+// SSE2 is part of x64 (and x86 compiled with /arch:SSE2)
+#if (MSVC && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))) || defined(__SSE2__)
+#define SIMD_SSE2 1
+#else
+#define SIMD_SSE2 0
+#endif
+
+// SSE4.1 kernels only when target CPU is known to have them, x64 guarantees only SSE2
+// Compiled with -msse4.1 (or higher), MSVC /arch:AVX (or higher), or explicit opt in by defining SEARCH_SSE4
+// Scalar fallback otherwise
+#if defined(__SSE4_1__) || defined(__AVX__) || defined(SEARCH_SSE4)
+#define SIMD_SSE4 1
+#else
+#define SIMD_SSE4 0
+#endif
+
+// SSE4 neighbours expansion (GridNeighbours) vectorises only bounds and heuristics, gain over scalar one is within noise
+// -> scalar expansion is default, SSE4 kernel only with explicit opt in by defining SEARCH_SSE4
+#if SIMD_SSE4 && defined(SEARCH_SSE4)
+#define SIMD_GRID_EXPAND 1
+#else
+#define SIMD_GRID_EXPAND 0
+#endif
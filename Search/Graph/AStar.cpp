@@ -0,0 +1,47 @@
+#include "AStar.h"
+
+
+int FindPath(SearchContext* context, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats) {
+
+	assert(context);
+	return FindPath(context, &context->OpenList(), nStartX, nStartY, nTargetX, nTargetY, pMap, nMapWidth, nMapHeight, pOutBuffer, nOutBufferSize, outStats);
+}
+
+int FindPath(SearchContext* context, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const PaddedMap* map,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats) {
+
+	assert(context);
+	return FindPath(context, &context->OpenList(), nStartX, nStartY, nTargetX, nTargetY, map, pOutBuffer, nOutBufferSize, outStats);
+}
+
+int FindPath(SearchContext* context, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const TiledMap* map,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats) {
+
+	assert(context);
+	return FindPath(context, &context->OpenList(), nStartX, nStartY, nTargetX, nTargetY, map, pOutBuffer, nOutBufferSize, outStats);
+}
+
+int FindPath(CompactSearchContext* context, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats) {
+
+	assert(context);
+	return FindPath(context, &context->OpenList(), nStartX, nStartY, nTargetX, nTargetY, pMap, nMapWidth, nMapHeight, pOutBuffer, nOutBufferSize, outStats);
+}
+
+int FindPath(SparseSearchContext* context, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats) {
+
+	assert(context);
+	return FindPath(context, &context->OpenList(), nStartX, nStartY, nTargetX, nTargetY, pMap, nMapWidth, nMapHeight, pOutBuffer, nOutBufferSize, outStats);
+}
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <cassert>
+#include <cstdlib>
+
+#include "AStarPolicies.h"
+#include "SearchStats.h"
+
+#include "../Utility/Timer.h"
+#include "../Utility/Util.h"
+
+//  FindPath
+//    A* on uniform cost 4way grid, map cell 0 is blocked, anything else is passable
+//    Writes path from target (inclusive) to start (exclusive) into pOutBuffer, if it fits
+//    Returns path cost, SearchContext::INFINITE_COST if target is unreachable
+//    Context keeps its memory between searches, search itself doesnt allocate (except open list growth)
+//
+//    OpenList is any queue with MinPriorityQueue interface (MinPriorityQueue<int>, MinPriorityQueue<int, 8>, BucketQueue<int>)
+//    Version without open list uses the context's MinPriorityQueue
+//    Counters of the search are written into outStats, if given
+//    Open list keeps packed coordinates for maps up to 65536x32768, node indices of bigger maps (see GridCoder)
+//
+//    Version with PaddedMap searches indices of padded layout without bounds tests, context nodes are padded indices
+//    Path in pOutBuffer is translated back to caller's nodes (x + y * width), output is the same as with byte map
+//    Version with TiledMap is the same, context nodes are tiled indices (states of 8x8 cells are together)
+//
+//    Version with CompactSearchContext keeps one byte per node (closed flag and parent direction)
+//    Open list weight is f << 2 | parent direction -> cost of popped node is f - h, node is closed with direction of
+//    its first (cheapest) entry. Nodes without cost cant be relaxed -> node can be in open list more times (up to 4),
+//    later entries of closed node are skipped. Path cost is the same as with SearchContext, path can differ in ties
+//
+//    Version with SparseSearchContext keeps node states in hash map (memory scales with reached nodes, not map size)
+//    Neighbour state is looked up once (insert or find), search is the same as with SearchContext
+//
+//    All versions are one A* loop (FindPathOnLayout) with map layout and node states policies (AStarPolicies.h)
+
+int FindPath(SearchContext* context, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats = nullptr);
+
+template<typename OpenList>
+int FindPath(SearchContext* context, OpenList* openList, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats = nullptr);
+
+int FindPath(SearchContext* context, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const PaddedMap* map,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats = nullptr);
+
+template<typename OpenList>
+int FindPath(SearchContext* context, OpenList* openList, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const PaddedMap* map,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats = nullptr);
+
+int FindPath(SearchContext* context, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const TiledMap* map,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats = nullptr);
+
+template<typename OpenList>
+int FindPath(SearchContext* context, OpenList* openList, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const TiledMap* map,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats = nullptr);
+
+int FindPath(CompactSearchContext* context, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats = nullptr);
+
+template<typename OpenList>
+int FindPath(CompactSearchContext* context, OpenList* openList, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats = nullptr);
+
+int FindPath(SparseSearchContext* context, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats = nullptr);
+
+template<typename OpenList>
+int FindPath(SparseSearchContext* context, OpenList* openList, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats = nullptr);
+
+// A* loop of all FindPath versions, Layout and States are policies of AStarPolicies.h
+template<typename Layout, typename States, typename OpenList>
+int FindPathOnLayout(const Layout* layout, States* states, OpenList* openList, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats = nullptr);
+
+
+
+
+
+
+
+
+template<typename Layout, typename States, typename OpenList>
+int FindPathOnLayout(const Layout* layout, States* states, OpenList* openList, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats) {
+
+	assert(layout);
+	assert(states);
+	assert(openList);
+
+	SearchCounters counters = SearchCountersBegin(openList->ReallocationsCount(), states->ReallocationsCount(), 1);
+
+	int x, y;
+	int startEntry = layout->Entry(nStartX, nStartY);
+	int start = layout->Decode(startEntry, &x, &y);
+	int startHeuristic = layout->Heuristic(x, y);
+	int target = layout->Decode(layout->Entry(nTargetX, nTargetY), &x, &y);
+
+	states->Begin(layout->NodesCount(), start);
+
+	OpenList& queue = *openList;
+	queue.Clear();
+	queue.Add(startEntry, states->Weight(startHeuristic, 0));
+
+	int pathCost = SearchContext::INFINITE_COST;
+
+	PROFILE_START(search)
+
+	while (!queue.Empty()) {
+		int entry = queue.First();
+		unsigned int weight = static_cast<unsigned int>(queue.FirstWeight());
+
+		queue.PopFirst();
+
+		int node = layout->Decode(entry, &x, &y);
+
+		int cost;
+		if (!states->Close(node, weight, layout->Heuristic(x, y), &cost))
+			continue;
+
+		if (node == target) {
+			pathCost = cost;
+			break;
+		}
+
+		++counters.expandedCount;
+
+		GridNeighbours neighbours;
+		unsigned int mask = layout->Expand(x, y, node, &neighbours);
+
+		for (; mask; mask &= mask - 1) {
+			int i = CountTrailingZeros64(mask);
+
+			if (!states->Relax(neighbours.nodes[i], cost + 1, node, i))
+				continue;
+
+			queue.Add(layout->NeighbourEntry(&neighbours, i), states->Weight(cost + 1 + layout->NeighbourHeuristic(&neighbours, i), i));
+			++counters.pushedCount;
+		}
+
+		SearchCountersOpen(&counters, queue.Count());
+	}
+
+	PROFILE_END_LOG(search);
+
+	if (pathCost != SearchContext::INFINITE_COST && pathCost < nOutBufferSize) {
+		int node = target;
+		int i = 0;
+		while (node != start) {
+			pOutBuffer[i++] = layout->OutputNode(node);
+			node = states->Parent(node);
+		}
+	}
+
+	SearchCountersWrite(&counters, openList->ReallocationsCount(), states->ReallocationsCount(), outStats);
+
+	return pathCost;
+}
+
+template<typename OpenList>
+int FindPath(SearchContext* context, OpenList* openList, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats) {
+
+	assert(context);
+
+	GridLayout layout(pMap, nMapWidth, nMapHeight, nTargetX, nTargetY);
+	ContextStates states(context);
+	return FindPathOnLayout(&layout, &states, openList, nStartX, nStartY, nTargetX, nTargetY, pOutBuffer, nOutBufferSize, outStats);
+}
+
+template<typename OpenList>
+int FindPath(SearchContext* context, OpenList* openList, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const PaddedMap* map,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats) {
+
+	assert(context);
+	assert(map);
+
+	PaddedLayout layout(map, nTargetX, nTargetY);
+	ContextStates states(context);
+	return FindPathOnLayout(&layout, &states, openList, nStartX, nStartY, nTargetX, nTargetY, pOutBuffer, nOutBufferSize, outStats);
+}
+
+template<typename OpenList>
+int FindPath(SearchContext* context, OpenList* openList, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const TiledMap* map,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats) {
+
+	assert(context);
+	assert(map);
+
+	TiledLayout layout(map, nTargetX, nTargetY);
+	ContextStates states(context);
+	return FindPathOnLayout(&layout, &states, openList, nStartX, nStartY, nTargetX, nTargetY, pOutBuffer, nOutBufferSize, outStats);
+}
+
+template<typename OpenList>
+int FindPath(CompactSearchContext* context, OpenList* openList, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats) {
+
+	assert(context);
+
+	GridLayout layout(pMap, nMapWidth, nMapHeight, nTargetX, nTargetY);
+	CompactStates states(context, &layout);
+	return FindPathOnLayout(&layout, &states, openList, nStartX, nStartY, nTargetX, nTargetY, pOutBuffer, nOutBufferSize, outStats);
+}
+
+template<typename OpenList>
+int FindPath(SparseSearchContext* context, OpenList* openList, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats) {
+
+	assert(context);
+
+	GridLayout layout(pMap, nMapWidth, nMapHeight, nTargetX, nTargetY);
+	SparseStates states(context);
+	return FindPathOnLayout(&layout, &states, openList, nStartX, nStartY, nTargetX, nTargetY, pOutBuffer, nOutBufferSize, outStats);
+}
@@ -0,0 +1,461 @@
+#pragma once
+
+#include <cassert>
+#include <cstdlib>
+
+#include "GridNeighbours.h"
+#include "PaddedMap.h"
+#include "TiledMap.h"
+#include "CompactSearchContext.h"
+#include "SearchContext.h"
+#include "SparseSearchContext.h"
+
+//  AStarPolicies
+//    Map layouts and node states of FindPath, one A* loop (FindPathOnLayout, AStar.h) is instantiated for each combination
+//
+//    Layout maps cells to context nodes and open list entries, expands neighbours of node and translates path back
+//      Decode(entry, &x, &y) returns node of open list entry, x and y are layout's coordinates of it
+//      Expand(x, y, node, &neighbours) returns mask of passable neighbours (bit i for direction i: up, right, down, left)
+//      NeighbourEntry / NeighbourHeuristic give open list entry and heuristic of expanded neighbour i
+//      GridLayout (byte map, row major), PaddedLayout (padded indices), TiledLayout (8x8 tiles)
+//
+//    States keep cost, closed flag and parent of nodes, open list weight is made by them
+//      Close(node, weight, heuristic, &cost) closes popped node, false for later entry of closed node (skipped)
+//      Relax(nb, cost, node) is false when neighbour is closed or has the same or smaller cost, it is reached otherwise
+//      ContextStates (SearchContext), CompactStates (CompactSearchContext), SparseStates (SparseSearchContext)
+//
+//    Other INTERNAL implementation details:
+//      Policies are small values inlined into the loop, unused outputs (coordinates of padded layout) are optimized out
+//      GridLayout and TiledLayout keep coordinates in open list (GridCoder), PaddedLayout keeps padded indices
+//      Compact states have no cost, it is carried by weight (f << 2 | parent direction), parent is node minus offset
+
+
+class GridLayout {
+public:
+	GridLayout(const unsigned char* pMap, int width, int height, int targetX, int targetY);
+
+	int NodesCount() const;
+	int Entry(int x, int y) const;
+	int Decode(int entry, int* outX, int* outY) const;
+	int Heuristic(int x, int y) const;
+
+	unsigned int Expand(int x, int y, int node, GridNeighbours* out) const;
+	int NeighbourEntry(const GridNeighbours* neighbours, int i) const;
+	int NeighbourHeuristic(const GridNeighbours* neighbours, int i) const;
+
+	// Caller's node of layout node (x + y * width)
+	int OutputNode(int node) const;
+
+	// Offset of node to its neighbour in direction
+	int Offset(int direction) const;
+
+private:
+	const unsigned char* _map;
+	int _width;
+	int _height;
+	int _targetX;
+	int _targetY;
+	GridCoder _coder;
+};
+
+class PaddedLayout {
+public:
+	PaddedLayout(const PaddedMap* map, int targetX, int targetY);
+
+	int NodesCount() const;
+	int Entry(int x, int y) const;
+	int Decode(int entry, int* outX, int* outY) const;
+	int Heuristic(int x, int y) const;
+
+	unsigned int Expand(int x, int y, int node, GridNeighbours* out) const;
+	int NeighbourEntry(const GridNeighbours* neighbours, int i) const;
+	int NeighbourHeuristic(const GridNeighbours* neighbours, int i) const;
+
+	int OutputNode(int node) const;
+
+private:
+	const PaddedMap* _map;
+	int _strideMask;
+	// Heuristic is computed in padded coordinates (both are shifted by 1)
+	int _targetX;
+	int _targetY;
+};
+
+class TiledLayout {
+public:
+	TiledLayout(const TiledMap* map, int targetX, int targetY);
+
+	int NodesCount() const;
+	int Entry(int x, int y) const;
+	int Decode(int entry, int* outX, int* outY) const;
+	int Heuristic(int x, int y) const;
+
+	unsigned int Expand(int x, int y, int node, GridNeighbours* out) const;
+	int NeighbourEntry(const GridNeighbours* neighbours, int i) const;
+	int NeighbourHeuristic(const GridNeighbours* neighbours, int i) const;
+
+	int OutputNode(int node) const;
+
+private:
+	const TiledMap* _map;
+	int _targetX;
+	int _targetY;
+	GridCoder _coder;
+};
+
+
+class ContextStates {
+public:
+	explicit ContextStates(SearchContext* context);
+
+	void Begin(int nodesCount, int start);
+
+	unsigned int Weight(int f, int direction) const;
+
+	bool Close(int node, unsigned int weight, int heuristic, int* outCost);
+	bool Relax(int nb, int cost, int node, int direction);
+
+	int Parent(int node) const;
+
+	unsigned int ReallocationsCount() const;
+
+private:
+	SearchContext* _context;
+};
+
+class CompactStates {
+public:
+	// Parent is found by offset of layout in parent direction (layout with constant offsets, GridLayout)
+	CompactStates(CompactSearchContext* context, const GridLayout* layout);
+
+	void Begin(int nodesCount, int start);
+
+	unsigned int Weight(int f, int direction) const;
+
+	bool Close(int node, unsigned int weight, int heuristic, int* outCost);
+	bool Relax(int nb, int cost, int node, int direction);
+
+	int Parent(int node) const;
+
+	unsigned int ReallocationsCount() const;
+
+private:
+	CompactSearchContext* _context;
+	const GridLayout* _layout;
+};
+
+class SparseStates {
+public:
+	explicit SparseStates(SparseSearchContext* context);
+
+	void Begin(int nodesCount, int start);
+
+	unsigned int Weight(int f, int direction) const;
+
+	bool Close(int node, unsigned int weight, int heuristic, int* outCost);
+	bool Relax(int nb, int cost, int node, int direction);
+
+	int Parent(int node) const;
+
+	unsigned int ReallocationsCount() const;
+
+private:
+	SparseSearchContext* _context;
+};
+
+
+
+
+
+
+
+
+inline GridLayout::GridLayout(const unsigned char* pMap, int width, int height, int targetX, int targetY) :
+	_map(pMap),
+	_width(width),
+	_height(height),
+	_targetX(targetX),
+	_targetY(targetY),
+	_coder(GridCoderMake(width, height)) {
+}
+
+inline int GridLayout::NodesCount() const {
+	return _width * _height;
+}
+
+inline int GridLayout::Entry(int x, int y) const {
+	return GridEncode(&_coder, x, y);
+}
+
+inline int GridLayout::Decode(int entry, int* outX, int* outY) const {
+	// Packed coordinates give node without division
+	GridDecode(&_coder, entry, outX, outY);
+	return *outX + *outY * _width;
+}
+
+inline int GridLayout::Heuristic(int x, int y) const {
+	return abs(_targetX - x) + abs(_targetY - y);
+}
+
+inline unsigned int GridLayout::Expand(int x, int y, int node, GridNeighbours* out) const {
+	// Bounds, map and heuristics of all neighbours at once, mask has passable neighbours inside of map
+	return GridExpand(x, y, node, _targetX, _targetY, _map, _width, _height, out);
+}
+
+inline int GridLayout::NeighbourEntry(const GridNeighbours* neighbours, int i) const {
+	return GridEncodeNeighbour(&_coder, neighbours, i);
+}
+
+inline int GridLayout::NeighbourHeuristic(const GridNeighbours* neighbours, int i) const {
+	return neighbours->heuristics[i];
+}
+
+inline int GridLayout::OutputNode(int node) const {
+	return node;
+}
+
+inline int GridLayout::Offset(int direction) const {
+	assert(direction >= 0 && direction < 4);
+	return direction == 0 ? -_width : direction == 1 ? 1 : direction == 2 ? _width : -1;
+}
+
+inline PaddedLayout::PaddedLayout(const PaddedMap* map, int targetX, int targetY) :
+	_map(map),
+	_strideMask(map->stride - 1),
+	_targetX(targetX + 1),
+	_targetY(targetY + 1) {
+}
+
+inline int PaddedLayout::NodesCount() const {
+	return PaddedMapIndicesCount(_map);
+}
+
+inline int PaddedLayout::Entry(int x, int y) const {
+	return PaddedMapIndex(_map, x, y);
+}
+
+inline int PaddedLayout::Decode(int entry, int* outX, int* outY) const {
+	// Open list keeps padded indices, coordinates are only for heuristic of start
+	*outX = entry & _strideMask;
+	*outY = entry >> _map->strideShift;
+	return entry;
+}
+
+inline int PaddedLayout::Heuristic(int x, int y) const {
+	return abs(_targetX - x) + abs(_targetY - y);
+}
+
+inline unsigned int PaddedLayout::Expand(int, int, int node, GridNeighbours* out) const {
+	const int stride = _map->stride;
+	const int offsets[4] = {-stride, 1, stride, -1};
+
+	unsigned int mask = 0;
+	for (int i = 0; i < 4; ++i) {
+		// Border is blocked, neighbour of map cell is always valid index
+		int nb = node + offsets[i];
+		out->nodes[i] = nb;
+
+		if (_map->cells[nb])
+			mask |= 1u << i;
+	}
+
+	return mask;
+}
+
+inline int PaddedLayout::NeighbourEntry(const GridNeighbours* neighbours, int i) const {
+	return neighbours->nodes[i];
+}
+
+inline int PaddedLayout::NeighbourHeuristic(const GridNeighbours* neighbours, int i) const {
+	// Only for neighbours which are pushed
+	int nb = neighbours->nodes[i];
+	return abs(_targetX - (nb & _strideMask)) + abs(_targetY - (nb >> _map->strideShift));
+}
+
+inline int PaddedLayout::OutputNode(int node) const {
+	return PaddedMapNode(_map, node);
+}
+
+inline TiledLayout::TiledLayout(const TiledMap* map, int targetX, int targetY) :
+	_map(map),
+	_targetX(targetX),
+	_targetY(targetY),
+	_coder(GridCoderMake(map->width, map->height)) {
+}
+
+inline int TiledLayout::NodesCount() const {
+	return TiledMapIndicesCount(_map);
+}
+
+inline int TiledLayout::Entry(int x, int y) const {
+	return GridEncode(&_coder, x, y);
+}
+
+inline int TiledLayout::Decode(int entry, int* outX, int* outY) const {
+	// Open list keeps coordinates (same as GridLayout), index is computed from them
+	GridDecode(&_coder, entry, outX, outY);
+	return TiledMapIndex(_map, *outX, *outY);
+}
+
+inline int TiledLayout::Heuristic(int x, int y) const {
+	return abs(_targetX - x) + abs(_targetY - y);
+}
+
+inline unsigned int TiledLayout::Expand(int x, int y, int, GridNeighbours* out) const {
+	const int nbdx[4] = {0, 1, 0, -1};
+	const int nbdy[4] = {-1, 0, 1, 0};
+
+	unsigned int mask = 0;
+	for (int i = 0; i < 4; ++i) {
+		int nbx = x + nbdx[i];
+		int nby = y + nbdy[i];
+
+		if (nbx < 0 || nbx >= _map->width || nby < 0 || nby >= _map->height)
+			continue;
+
+		int nb = TiledMapIndex(_map, nbx, nby);
+		if (_map->cells[nb] == 0)
+			continue;
+
+		out->nodes[i] = nb;
+		out->coords[i] = GridEncode(&_coder, nbx, nby);
+		out->heuristics[i] = abs(_targetX - nbx) + abs(_targetY - nby);
+		mask |= 1u << i;
+	}
+
+	return mask;
+}
+
+inline int TiledLayout::NeighbourEntry(const GridNeighbours* neighbours, int i) const {
+	return neighbours->coords[i];
+}
+
+inline int TiledLayout::NeighbourHeuristic(const GridNeighbours* neighbours, int i) const {
+	return neighbours->heuristics[i];
+}
+
+inline int TiledLayout::OutputNode(int node) const {
+	return TiledMapNode(_map, node);
+}
+
+
+inline ContextStates::ContextStates(SearchContext* context) :
+	_context(context) {
+}
+
+inline void ContextStates::Begin(int nodesCount, int start) {
+	_context->Begin(nodesCount);
+	_context->Reach(start, 0, start);
+}
+
+inline unsigned int ContextStates::Weight(int f, int) const {
+	return static_cast<unsigned int>(f);
+}
+
+inline bool ContextStates::Close(int node, unsigned int, int, int* outCost) {
+	*outCost = _context->Cost(node);
+	_context->Close(node);
+	return true;
+}
+
+inline bool ContextStates::Relax(int nb, int cost, int node, int) {
+	if (_context->IsClosed(nb))
+		return false;
+
+	// With Manhatten heur. in uniform cost grid, we always get to the point in one of the fastest paths
+	// Since the cost is uniform (+1), the cost in queue never has to be updated
+	if (cost >= _context->Cost(nb))
+		return false;
+
+	_context->Reach(nb, cost, node);
+	return true;
+}
+
+inline int ContextStates::Parent(int node) const {
+	return _context->FromNode(node);
+}
+
+inline unsigned int ContextStates::ReallocationsCount() const {
+	return _context->ReallocationsCount();
+}
+
+inline CompactStates::CompactStates(CompactSearchContext* context, const GridLayout* layout) :
+	_context(context),
+	_layout(layout) {
+}
+
+inline void CompactStates::Begin(int nodesCount, int) {
+	// Start has no direction, it is never read (path ends at start)
+	_context->Begin(nodesCount);
+}
+
+inline unsigned int CompactStates::Weight(int f, int direction) const {
+	return (static_cast<unsigned int>(f) << 2) | static_cast<unsigned int>(direction);
+}
+
+inline bool CompactStates::Close(int node, unsigned int weight, int heuristic, int* outCost) {
+	// Node was closed by entry with smaller (or same) f, heuristic of node is the same -> cost was smaller too
+	if (_context->IsClosed(node))
+		return false;
+
+	_context->Close(node, weight & 3);
+	*outCost = static_cast<int>(weight >> 2) - heuristic;
+	return true;
+}
+
+inline bool CompactStates::Relax(int nb, int, int, int) {
+	// Nodes without cost cant be relaxed, open node can be added again (later entries are skipped by Close)
+	return !_context->IsClosed(nb);
+}
+
+inline int CompactStates::Parent(int node) const {
+	return node - _layout->Offset(_context->ParentDirection(node));
+}
+
+inline unsigned int CompactStates::ReallocationsCount() const {
+	return _context->ReallocationsCount();
+}
+
+inline SparseStates::SparseStates(SparseSearchContext* context) :
+	_context(context) {
+}
+
+inline void SparseStates::Begin(int, int start) {
+	_context->Begin();
+
+	bool reached;
+	*_context->Reach(start, &reached) = SparseSearchContext::NodeState{0, start, false};
+}
+
+inline unsigned int SparseStates::Weight(int f, int) const {
+	return static_cast<unsigned int>(f);
+}
+
+inline bool SparseStates::Close(int node, unsigned int, int, int* outCost) {
+	// State pointer is invalid after neighbours are inserted, cost is read before
+	bool reached;
+	SparseSearchContext::NodeState* state = _context->Reach(node, &reached);
+	assert(reached);
+	state->closed = true;
+	*outCost = state->cost;
+	return true;
+}
+
+inline bool SparseStates::Relax(int nb, int cost, int node, int) {
+	// Neighbour state is looked up once (insert or find)
+	bool reached;
+	SparseSearchContext::NodeState* nbState = _context->Reach(nb, &reached);
+	if (reached && (nbState->closed || cost >= nbState->cost))
+		return false;
+
+	*nbState = SparseSearchContext::NodeState{cost, node, false};
+	return true;
+}
+
+inline int SparseStates::Parent(int node) const {
+	return _context->State(node)->fromNode;
+}
+
+inline unsigned int SparseStates::ReallocationsCount() const {
+	return _context->ReallocationsCount();
+}
@@ -0,0 +1,169 @@
+#include "BidirectionalAStar.h"
+
+#include <cassert>
+#include <cstdlib>
+
+#include "SearchContext.h"
+#include "SearchStats.h"
+
+#include "../Utility/Timer.h"
+
+
+namespace {
+	struct Direction {
+		SearchContext* context;
+		SearchContext* otherContext;
+		int goalX;   // Target for forward direction, start for backward
+		int goalY;
+		int originX; // Start for forward direction, target for backward
+		int originY;
+		int distance; // Heuristic between start and target, keeps weights positive
+	};
+}
+
+
+// Weight is doubled key with average heuristic (heurGoal - heurOrigin) / 2 shifted by distance / 2
+// Average heuristics of both directions sum to 0 -> searches are balanced and can stop when their keys sum to best cost
+static inline unsigned int Weight(int cost, int heurGoal, int heurOrigin, int distance) {
+	return 2 * cost + heurGoal - heurOrigin + distance;
+}
+
+// Expands first open node of direction, returns false if it was already closed
+// Lowers bestCost (and sets meetNode) when reached node was reached by the other direction too
+static bool ExpandFirst(Direction* direction, const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* bestCost, int* meetNode, int* pushedCount) {
+
+	SearchContext* context = direction->context;
+	MinPriorityQueue<int>& queue = context->OpenList();
+
+	int node = queue.First();
+	queue.PopFirst();
+
+	if (context->IsClosed(node))
+		return false;
+
+	context->Close(node);
+
+	int x = node % nMapWidth;
+	int y = node / nMapWidth;
+	int cost = context->Cost(node) + 1;
+
+	int neighbours[4];
+	int count = 0;
+	if (x > 0)
+		neighbours[count++] = node - 1;
+	if (x < nMapWidth - 1)
+		neighbours[count++] = node + 1;
+	if (y > 0)
+		neighbours[count++] = node - nMapWidth;
+	if (y < nMapHeight - 1)
+		neighbours[count++] = node + nMapWidth;
+
+	for (int i = 0; i < count; ++i) {
+		int nb = neighbours[i];
+		if (pMap[nb] == 0 || context->IsClosed(nb) || cost >= context->Cost(nb))
+			continue;
+
+		int nbx = nb % nMapWidth;
+		int nby = nb / nMapWidth;
+		int heurGoal = abs(direction->goalX - nbx) + abs(direction->goalY - nby);
+		int heurOrigin = abs(direction->originX - nbx) + abs(direction->originY - nby);
+		queue.Add(nb, Weight(cost, heurGoal, heurOrigin, direction->distance));
+		context->Reach(nb, cost, node);
+		++(*pushedCount);
+
+		int otherCost = direction->otherContext->Cost(nb);
+		if (otherCost != SearchContext::INFINITE_COST && cost + otherCost < *bestCost) {
+			*bestCost = cost + otherCost;
+			*meetNode = nb;
+		}
+	}
+
+	return true;
+}
+
+int FindPathBidirectional(SearchContext* context, SearchContext* backwardContext, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats) {
+
+	assert(context);
+	assert(backwardContext);
+	assert(context != backwardContext);
+
+	// Reallocations of both directions are summed
+	SearchCounters counters = SearchCountersBegin(context->OpenList().ReallocationsCount() + backwardContext->OpenList().ReallocationsCount(),
+		context->ReallocationsCount() + backwardContext->ReallocationsCount(), 0);
+
+	int nodesCount = nMapWidth * nMapHeight;
+	int start = nStartX + nStartY * nMapWidth;
+	int target = nTargetX + nTargetY * nMapWidth;
+
+	context->Begin(nodesCount);
+	backwardContext->Begin(nodesCount);
+
+	MinPriorityQueue<int>& forwardQueue = context->OpenList();
+	MinPriorityQueue<int>& backwardQueue = backwardContext->OpenList();
+
+	int distance = abs(nTargetX - nStartX) + abs(nTargetY - nStartY);
+	Direction forward = {context, backwardContext, nTargetX, nTargetY, nStartX, nStartY, distance};
+	Direction backward = {backwardContext, context, nStartX, nStartY, nTargetX, nTargetY, distance};
+
+	int bestCost = SearchContext::INFINITE_COST;
+	int meetNode = -1;
+
+	context->Reach(start, 0, start);
+	backwardContext->Reach(target, 0, target);
+
+	if (start == target) {
+		bestCost = 0;
+		meetNode = start;
+	}
+	else if (pMap[target]) {
+		forwardQueue.Add(start, Weight(0, distance, 0, distance));
+		backwardQueue.Add(target, Weight(0, distance, 0, distance));
+	}
+
+	counters.pushedCount = forwardQueue.Count() + backwardQueue.Count();
+	SearchCountersOpen(&counters, forwardQueue.Count() + backwardQueue.Count());
+
+	PROFILE_START(bidirectionalSearch)
+
+	while (!forwardQueue.Empty() && !backwardQueue.Empty()) {
+		// Sum of lowest keys is lower bound of paths through unexpanded nodes (stale entries only lower it)
+		if (bestCost != SearchContext::INFINITE_COST &&
+			(unsigned int) (forwardQueue.FirstWeight() + backwardQueue.FirstWeight()) >= 2u * bestCost + 2u * distance)
+			break;
+
+		Direction* direction = forwardQueue.Count() <= backwardQueue.Count() ? &forward : &backward;
+		if (ExpandFirst(direction, pMap, nMapWidth, nMapHeight, &bestCost, &meetNode, &counters.pushedCount))
+			++counters.expandedCount;
+
+		SearchCountersOpen(&counters, forwardQueue.Count() + backwardQueue.Count());
+	}
+
+	PROFILE_END_LOG(bidirectionalSearch);
+
+	if (bestCost != SearchContext::INFINITE_COST && bestCost < nOutBufferSize) {
+		// Buffer index is distance to target, forward part is written from meet node back to start, backward part to target
+		int i = bestCost - context->Cost(meetNode);
+		int node = meetNode;
+		while (node != start) {
+			pOutBuffer[i++] = node;
+			node = context->FromNode(node);
+		}
+
+		i = bestCost - context->Cost(meetNode);
+		node = meetNode;
+		while (node != target) {
+			node = backwardContext->FromNode(node);
+			pOutBuffer[--i] = node;
+		}
+		assert(i == 0);
+	}
+
+	SearchCountersWrite(&counters, context->OpenList().ReallocationsCount() + backwardContext->OpenList().ReallocationsCount(),
+		context->ReallocationsCount() + backwardContext->ReallocationsCount(), outStats);
+
+	return bestCost;
+}
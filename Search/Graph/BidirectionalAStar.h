@@ -0,0 +1,21 @@
+#pragma once
+
+class SearchContext;
+struct SearchStats;
+
+//  FindPathBidirectional
+//    A* from start to target and from target to start at once, every direction has its own context (and open list)
+//    Direction with smaller open list is expanded, best path is updated when direction reaches node of the other one
+//    Same output as FindPath, expanded nodes of both directions are summed in outStats
+//    Blocked target is unreachable (unless it is start), same as in FindPath
+//    Saves expansions when A* frontier grows around obstacles (rooms, mazes), on open maps A* alone expands less
+//
+//    Other INTERNAL implementation details:
+//      Both directions use average heuristic (h to goal - h to origin) / 2, which is consistent and sums to 0 for both
+//      -> search ends when lowest keys of both open lists sum to best path cost (one sided f bound needs almost full A*)
+//      Open lists can contain nodes more times (cost update adds node again), closed nodes are skipped when popped
+
+int FindPathBidirectional(SearchContext* context, SearchContext* backwardContext, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats = nullptr);
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cassert>
+
+#include "../Allocator/IAllocator.h"
+#include "../Collection/MinPriorityQueue.h"
+#include "../Utility/Memory.h"
+
+//  CompactSearchContext
+//    Scratch memory for grid searches with one byte per node (SearchContext has 12 bytes per node)
+//    Node keeps only closed flag and direction to its parent (4way grid -> 2 bits), there is no cost and no from node
+//    Cost of node is carried by weight in open list (f - h), parent direction too (low bits of weight)
+//    Reused between searches, memory is reallocated only when bigger map is searched
+//    Not thread safe, one context per thread
+//
+//    Other INTERNAL implementation details:
+//      State byte is generation << 3 | closed << 2 | parent direction
+//      Generation has 5 bits, Begin only moves it -> new search is O(nodes touched)
+//      When generation overflows, all states are cleared (once per 31 searches)
+//      -> Begin is O(nodes) every 31st search, amortized nodes / 31 bytes of memset per search
+//      Short searches on huge map pay mostly for this reset (SparseSearchContext touches only reached nodes)
+//      Wider generation would need more bits per node, which is what this context avoids
+
+
+class CompactSearchContext {
+public:
+	// Direction is index of neighbour the node was reached from its parent (up, right, down, left)
+	static const int DIRECTIONS_COUNT = 4;
+
+	// Searches between clears of all node states (Begin is O(nodes) once per this count)
+	static const unsigned int MAX_GENERATION = 31;
+
+private:
+	static const unsigned char CLOSED_BIT = 1 << 2;
+	static const unsigned char DIRECTION_MASK = 3;
+	static const unsigned int GENERATION_SHIFT = 3;
+
+public:
+	CompactSearchContext();
+	~CompactSearchContext();
+
+	CompactSearchContext(const CompactSearchContext& oth) = delete;
+	CompactSearchContext& operator=(const CompactSearchContext& rhs) = delete;
+
+	void Init(IAllocator* allocator);
+
+	// Starts new search on graph with nodesCount nodes, invalidates all node states and clears open list
+	void Begin(int nodesCount);
+
+	bool IsClosed(int node) const;
+
+	// Node has to be closed
+	int ParentDirection(int node) const;
+
+	void Close(int node, int parentDirection);
+
+	int NodesCount() const;
+
+	MinPriorityQueue<int>& OpenList();
+
+	// Count of node states reallocations since Init (for statistics)
+	unsigned int ReallocationsCount() const;
+
+private:
+	void Reallocate(int newCapacity);
+	void ClearStates();
+
+private:
+	unsigned int _generation;
+
+	int _nodesCount;
+	int _capacity;
+	unsigned int _reallocationsCount;
+
+	unsigned char* _states;
+
+	MinPriorityQueue<int> _openList;
+
+	IAllocator* _allocator;
+};
+
+
+
+
+
+
+
+
+inline CompactSearchContext::CompactSearchContext() :
+	_generation(1),
+	_nodesCount(0),
+	_capacity(0),
+	_reallocationsCount(0),
+	_states(nullptr),
+	_allocator(nullptr) {
+}
+
+inline CompactSearchContext::~CompactSearchContext() {
+	if (_states) {
+		Deallocate(_allocator, _states);
+	}
+}
+
+inline void CompactSearchContext::Init(IAllocator* allocator) {
+	assert(!_allocator);
+	_allocator = allocator;
+	_openList.Init(allocator);
+}
+
+inline void CompactSearchContext::Begin(int nodesCount) {
+	assert(nodesCount >= 0);
+
+	if (nodesCount > _capacity) {
+		Reallocate(nodesCount);
+	}
+	else if (_generation >= MAX_GENERATION) {
+		ClearStates();
+	}
+	else {
+		++_generation;
+	}
+
+	_nodesCount = nodesCount;
+	_openList.Clear();
+}
+
+inline bool CompactSearchContext::IsClosed(int node) const {
+	assert(node >= 0 && node < _nodesCount);
+	// Generation and closed bit at once
+	return (_states[node] >> 2) == ((_generation << 1) | 1);
+}
+
+inline int CompactSearchContext::ParentDirection(int node) const {
+	assert(IsClosed(node));
+	return _states[node] & DIRECTION_MASK;
+}
+
+inline void CompactSearchContext::Close(int node, int parentDirection) {
+	assert(node >= 0 && node < _nodesCount);
+	assert(parentDirection >= 0 && parentDirection < DIRECTIONS_COUNT);
+	_states[node] = static_cast<unsigned char>((_generation << GENERATION_SHIFT) | CLOSED_BIT | parentDirection);
+}
+
+inline int CompactSearchContext::NodesCount() const {
+	return _nodesCount;
+}
+
+inline MinPriorityQueue<int>& CompactSearchContext::OpenList() {
+	return _openList;
+}
+
+inline unsigned int CompactSearchContext::ReallocationsCount() const {
+	return _reallocationsCount;
+}
+
+inline void CompactSearchContext::Reallocate(int newCapacity) {
+	assert(_allocator);
+
+	// States dont have to be copied, reallocation happens only in Begin
+	if (_states) {
+		Deallocate(_allocator, _states);
+	}
+
+	_states = static_cast<unsigned char*>(Allocate(_allocator, newCapacity, 1));
+	_capacity = newCapacity;
+	++_reallocationsCount;
+
+	ClearStates();
+}
+
+inline void CompactSearchContext::ClearStates() {
+	MemSet(_states, 0, _capacity);
+	_generation = 1;
+}
@@ -0,0 +1,486 @@
+#include "ComponentMap.h"
+
+#include <cassert>
+
+#include "AStar.h"
+#include "SearchContext.h"
+#include "SearchStats.h"
+
+#include "../Utility/Memory.h"
+#include "../Utility/Timer.h"
+
+
+namespace {
+	const int FIRST_LABELS_CAPACITY = 256;
+	const int MAX_NEIGHBOURS = 4;
+}
+
+
+// Union find root with path halving (build only)
+static int FindRoot(int* parents, int label) {
+	while (parents[label] != label) {
+		parents[label] = parents[parents[label]];
+		label = parents[label];
+	}
+	return label;
+}
+
+
+ComponentMap::ComponentMap() :
+	_map(nullptr),
+	_width(0),
+	_height(0),
+	_labels(nullptr),
+	_cellsCapacity(0),
+	_sizes(nullptr),
+	_freeLabels(nullptr),
+	_freeLabelsCount(0),
+	_labelsCount(0),
+	_labelsCapacity(0),
+	_componentsCount(0),
+	_allocator(nullptr) {
+}
+
+ComponentMap::~ComponentMap() {
+	if (_labels)
+		Deallocate(_allocator, _labels);
+	if (_sizes)
+		Deallocate(_allocator, _sizes);
+	if (_freeLabels)
+		Deallocate(_allocator, _freeLabels);
+}
+
+void ComponentMap::Init(IAllocator* allocator) {
+	assert(!_allocator);
+	_allocator = allocator;
+}
+
+void ComponentMap::Build(const unsigned char* pMap, const int nMapWidth, const int nMapHeight) {
+	assert(_allocator);
+	assert(pMap);
+
+	PROFILE_START(componentMapBuild)
+
+	int cellsCount = nMapWidth * nMapHeight;
+	if (cellsCount > _cellsCapacity) {
+		if (_labels)
+			Deallocate(_allocator, _labels);
+
+		_labels = static_cast<int*>(Allocate(_allocator, cellsCount * sizeof(int), alignof(int)));
+		_cellsCapacity = cellsCount;
+	}
+
+	_map = pMap;
+	_width = nMapWidth;
+	_height = nMapHeight;
+
+	// First pass gives provisional labels (from left and up neighbour), equal labels are joined in union find
+	// Row start or cell after blocked cell can start new label -> at most (cells + 1) / 2 + rows labels
+	int maxLabels = (cellsCount + 1) / 2 + nMapHeight + 1;
+	int* parents = static_cast<int*>(Allocate(_allocator, maxLabels * sizeof(int), alignof(int)));
+	int provisionalCount = 1;
+
+	for (int y = 0; y < nMapHeight; ++y) {
+		for (int x = 0; x < nMapWidth; ++x) {
+			int cell = x + y * nMapWidth;
+			if (!pMap[cell]) {
+				_labels[cell] = 0;
+				continue;
+			}
+
+			int left = x > 0 ? _labels[cell - 1] : 0;
+			int up = y > 0 ? _labels[cell - nMapWidth] : 0;
+
+			if (!left && !up) {
+				assert(provisionalCount < maxLabels);
+				parents[provisionalCount] = provisionalCount;
+				_labels[cell] = provisionalCount++;
+			}
+			else if (left && up && left != up) {
+				int leftRoot = FindRoot(parents, left);
+				int upRoot = FindRoot(parents, up);
+				if (leftRoot < upRoot)
+					parents[upRoot] = leftRoot;
+				else
+					parents[leftRoot] = upRoot;
+
+				_labels[cell] = left;
+			}
+			else {
+				_labels[cell] = left ? left : up;
+			}
+		}
+	}
+
+	// Roots get final labels 1..n in scan order, parents of roots are reused for mapping
+	_componentsCount = 0;
+	for (int i = 1; i < provisionalCount; ++i) {
+		if (parents[i] == i)
+			parents[i] = -(++_componentsCount);
+	}
+
+	for (int i = 1; i < provisionalCount; ++i) {
+		if (parents[i] >= 0) {
+			int root = i;
+			while (parents[root] >= 0)
+				root = parents[root];
+
+			parents[i] = parents[root];
+		}
+	}
+
+	ReallocateLabels(_componentsCount + 1);
+	_labelsCount = _componentsCount + 1;
+	_freeLabelsCount = 0;
+
+	for (int i = 0; i < _labelsCount; ++i)
+		_sizes[i] = 0;
+
+	for (int i = 0; i < cellsCount; ++i) {
+		if (_labels[i]) {
+			_labels[i] = -parents[_labels[i]];
+			++_sizes[_labels[i]];
+		}
+	}
+
+	Deallocate(_allocator, parents);
+
+	PROFILE_END_LOG(componentMapBuild);
+}
+
+void ComponentMap::UpdateCells(SearchContext* context, const int* cells, int cellsCount) {
+	assert(_map);
+	assert(context);
+
+	for (int i = 0; i < cellsCount; ++i) {
+		int cell = cells[i];
+		assert(cell >= 0 && cell < _width * _height);
+
+		// Cell can be reported more times, or changed back
+		if (_map[cell] && !_labels[cell])
+			OpenCell(context, cell);
+		else if (!_map[cell] && _labels[cell])
+			BlockCell(context, cell);
+	}
+}
+
+bool ComponentMap::Connected(int cell, int otherCell) const {
+	assert(cell >= 0 && cell < _width * _height);
+	assert(otherCell >= 0 && otherCell < _width * _height);
+	return _labels[cell] && _labels[cell] == _labels[otherCell];
+}
+
+int ComponentMap::Label(int cell) const {
+	assert(cell >= 0 && cell < _width * _height);
+	return _labels[cell];
+}
+
+int ComponentMap::ComponentsCount() const {
+	return _componentsCount;
+}
+
+void ComponentMap::OpenCell(SearchContext* context, int cell) {
+	int neighbours[MAX_NEIGHBOURS];
+	int count = Neighbours(cell, neighbours);
+
+	// Biggest neighbour component keeps its label, others are relabelled to it
+	int biggest = 0;
+	for (int i = 0; i < count; ++i) {
+		int label = _labels[neighbours[i]];
+		if (label && (!biggest || _sizes[label] > _sizes[biggest]))
+			biggest = label;
+	}
+
+	if (!biggest) {
+		_labels[cell] = NewLabel();
+		_sizes[_labels[cell]] = 1;
+		return;
+	}
+
+	_labels[cell] = biggest;
+	++_sizes[biggest];
+
+	for (int i = 0; i < count; ++i) {
+		int label = _labels[neighbours[i]];
+		if (!label || label == biggest)
+			continue;
+
+		int relabelled = Relabel(context, neighbours[i], label, biggest);
+		assert(relabelled == _sizes[label]);
+		_sizes[biggest] += relabelled;
+		_sizes[label] = 0;
+		FreeLabel(label);
+	}
+}
+
+void ComponentMap::BlockCell(SearchContext* context, int cell) {
+	int label = _labels[cell];
+	_labels[cell] = 0;
+	--_sizes[label];
+
+	int neighbours[MAX_NEIGHBOURS];
+	int count = Neighbours(cell, neighbours);
+
+	int seeds[MAX_NEIGHBOURS];
+	int seedsCount = 0;
+	for (int i = 0; i < count; ++i) {
+		if (_labels[neighbours[i]] == label)
+			seeds[seedsCount++] = neighbours[i];
+	}
+
+	if (seedsCount == 0) {
+		FreeLabel(label);
+		return;
+	}
+
+	if (seedsCount == 1)
+		return;
+
+	// Breadth first search from every seed, weight is depth * MAX_NEIGHBOURS + seed -> searches advance together
+	// Node cost is index of seed which reached it, searches which meet are joined into group
+	context->Begin(_width * _height);
+	MinPriorityQueue<int>& queue = context->OpenList();
+
+	int groups[MAX_NEIGHBOURS];
+	int pending[MAX_NEIGHBOURS];  // nodes in open list
+	int reached[MAX_NEIGHBOURS];
+	for (int i = 0; i < seedsCount; ++i) {
+		groups[i] = i;
+		pending[i] = 1;
+		reached[i] = 1;
+		context->Reach(seeds[i], i, seeds[i]);
+		queue.Add(seeds[i], i);
+	}
+
+	int groupsCount = seedsCount;
+	int activeCount = seedsCount;
+
+	while (groupsCount > 1 && activeCount > 1) {
+		assert(!queue.Empty());
+
+		int node = queue.First();
+		int depth = queue.FirstWeight() / MAX_NEIGHBOURS;
+		queue.PopFirst();
+
+		int seed = context->Cost(node);
+		--pending[seed];
+
+		int nodeNeighbours[MAX_NEIGHBOURS];
+		int nodeNeighboursCount = Neighbours(node, nodeNeighbours);
+		for (int i = 0; i < nodeNeighboursCount; ++i) {
+			int nb = nodeNeighbours[i];
+			if (_labels[nb] != label)
+				continue;
+
+			if (!context->IsReached(nb)) {
+				context->Reach(nb, seed, node);
+				queue.Add(nb, (depth + 1) * MAX_NEIGHBOURS + seed);
+				++pending[seed];
+				++reached[seed];
+				continue;
+			}
+
+			int group = groups[seed];
+			int otherGroup = groups[context->Cost(nb)];
+			if (group != otherGroup) {
+				for (int j = 0; j < seedsCount; ++j) {
+					if (groups[j] == otherGroup)
+						groups[j] = group;
+				}
+				--groupsCount;
+			}
+		}
+
+		// Group is active while any of its searches has nodes in open list
+		activeCount = 0;
+		for (int g = 0; g < seedsCount; ++g) {
+			int groupPending = 0;
+			for (int j = 0; j < seedsCount; ++j) {
+				if (groups[j] == g)
+					groupPending += pending[j];
+			}
+
+			if (groupPending > 0)
+				++activeCount;
+		}
+	}
+
+	queue.Clear();
+
+	if (groupsCount == 1)
+		return;
+
+	// Group still searching is the rest of component and keeps label (it is not fully known)
+	// If all groups finished, the biggest keeps it
+	int keptGroup = -1;
+	int keptReached = -1;
+	for (int g = 0; g < seedsCount; ++g) {
+		int groupPending = 0;
+		int groupReached = 0;
+		bool isGroup = false;
+		for (int j = 0; j < seedsCount; ++j) {
+			if (groups[j] == g) {
+				isGroup = true;
+				groupPending += pending[j];
+				groupReached += reached[j];
+			}
+		}
+
+		if (!isGroup)
+			continue;
+
+		if (groupPending > 0) {
+			keptGroup = g;
+			break;
+		}
+
+		if (groupReached > keptReached) {
+			keptGroup = g;
+			keptReached = groupReached;
+		}
+	}
+
+	for (int g = 0; g < seedsCount; ++g) {
+		if (g == keptGroup)
+			continue;
+
+		int newLabel = 0;
+		for (int j = 0; j < seedsCount; ++j) {
+			if (groups[j] != g)
+				continue;
+
+			// Other seeds of group are relabelled with the first one
+			if (!newLabel)
+				newLabel = NewLabel();
+
+			int relabelled = Relabel(context, seeds[j], label, newLabel);
+			_sizes[newLabel] += relabelled;
+			_sizes[label] -= relabelled;
+		}
+	}
+
+	assert(_sizes[label] > 0);
+}
+
+int ComponentMap::Relabel(SearchContext* context, int seed, int from, int to) {
+	if (_labels[seed] != from)
+		return 0;
+
+	// Label itself marks visited cells, open list is only stack of cells (same weight)
+	MinPriorityQueue<int>& queue = context->OpenList();
+	queue.Clear();
+
+	_labels[seed] = to;
+	queue.Add(seed, 0);
+
+	int count = 0;
+	while (!queue.Empty()) {
+		int cell = queue.First();
+		queue.PopFirst();
+		++count;
+
+		int neighbours[MAX_NEIGHBOURS];
+		int neighboursCount = Neighbours(cell, neighbours);
+		for (int i = 0; i < neighboursCount; ++i) {
+			int nb = neighbours[i];
+			if (_labels[nb] == from) {
+				_labels[nb] = to;
+				queue.Add(nb, 0);
+			}
+		}
+	}
+
+	return count;
+}
+
+int ComponentMap::NewLabel() {
+	++_componentsCount;
+
+	int label;
+	if (_freeLabelsCount > 0) {
+		label = _freeLabels[--_freeLabelsCount];
+	}
+	else {
+		if (_labelsCount == _labelsCapacity)
+			ReallocateLabels(_labelsCapacity * 2);
+
+		label = _labelsCount++;
+	}
+
+	_sizes[label] = 0;
+	return label;
+}
+
+void ComponentMap::FreeLabel(int label) {
+	assert(label > 0 && _sizes[label] == 0);
+	assert(_freeLabelsCount < _labelsCapacity);
+
+	--_componentsCount;
+	_freeLabels[_freeLabelsCount++] = label;
+}
+
+inline int ComponentMap::Neighbours(int cell, int* outNeighbours) const {
+	int x = cell % _width;
+	int y = cell / _width;
+
+	int count = 0;
+	if (x > 0)
+		outNeighbours[count++] = cell - 1;
+	if (x < _width - 1)
+		outNeighbours[count++] = cell + 1;
+	if (y > 0)
+		outNeighbours[count++] = cell - _width;
+	if (y < _height - 1)
+		outNeighbours[count++] = cell + _width;
+
+	return count;
+}
+
+void ComponentMap::ReallocateLabels(int newCapacity) {
+	if (newCapacity < FIRST_LABELS_CAPACITY)
+		newCapacity = FIRST_LABELS_CAPACITY;
+
+	if (newCapacity <= _labelsCapacity)
+		return;
+
+	int* sizes = static_cast<int*>(Allocate(_allocator, newCapacity * sizeof(int), alignof(int)));
+	int* freeLabels = static_cast<int*>(Allocate(_allocator, newCapacity * sizeof(int), alignof(int)));
+
+	if (_sizes) {
+		MemCopy(sizes, _sizes, _labelsCapacity * sizeof(int));
+		MemCopy(freeLabels, _freeLabels, _labelsCapacity * sizeof(int));
+		Deallocate(_allocator, _sizes);
+		Deallocate(_allocator, _freeLabels);
+	}
+
+	_sizes = sizes;
+	_freeLabels = freeLabels;
+	_labelsCapacity = newCapacity;
+}
+
+
+int FindPathConnected(SearchContext* context, const ComponentMap* components, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats) {
+
+	assert(components);
+
+	int start = nStartX + nStartY * nMapWidth;
+	int target = nTargetX + nTargetY * nMapWidth;
+
+	if (!components->Connected(start, target)) {
+		if (outStats) {
+			outStats->expandedCount = 0;
+			outStats->pushedCount = 0;
+			outStats->peakOpenCount = 0;
+			outStats->openReallocationsCount = 0;
+			outStats->allocationsCount = 0;
+			outStats->cycles = 0;
+		}
+
+		return SearchContext::INFINITE_COST;
+	}
+
+	return FindPath(context, nStartX, nStartY, nTargetX, nTargetY, pMap, nMapWidth, nMapHeight, pOutBuffer, nOutBufferSize, outStats);
+}
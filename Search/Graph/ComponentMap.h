@@ -0,0 +1,83 @@
+#pragma once
+
+#include "../Allocator/IAllocator.h"
+
+class SearchContext;
+struct SearchStats;
+
+//  ComponentMap
+//    Connected components of map (4 connected passable cells), every cell has label of its component (0 is blocked)
+//    Two cells are connected if they have the same label, query is O(1)
+//    Build labels whole map (scanline with union find), UpdateCells repairs labels after cells were changed
+//    Map memory is not copied, caller changes it and reports changed cells
+//
+//    Other INTERNAL implementation details:
+//      Labels are always final (no union find after build), every label has count of its cells
+//      Opened cell joins components of its neighbours, smaller components are relabelled to the biggest one
+//      Blocked cell can split component, searches from its neighbours run together (breadth first, interleaved)
+//      until they meet or until all of them except one run out of cells, those are relabelled to new labels
+//      -> update costs are proportional to smaller part of split / merge, not to map size
+//      Labels of removed components are reused
+
+class ComponentMap {
+public:
+	ComponentMap();
+	~ComponentMap();
+
+	ComponentMap(const ComponentMap& oth) = delete;
+	ComponentMap& operator=(const ComponentMap& rhs) = delete;
+
+	void Init(IAllocator* allocator);
+
+	void Build(const unsigned char* pMap, const int nMapWidth, const int nMapHeight);
+
+	// Cells (x + y * width) which passability was changed in map since last call
+	// Context is used as scratch memory for searches
+	void UpdateCells(SearchContext* context, const int* cells, int cellsCount);
+
+	// Blocked cells are not connected to anything
+	bool Connected(int cell, int otherCell) const;
+
+	// 0 for blocked cell
+	int Label(int cell) const;
+
+	int ComponentsCount() const;
+
+private:
+	void OpenCell(SearchContext* context, int cell);
+	void BlockCell(SearchContext* context, int cell);
+
+	// Labels all cells with label from connected with seed to label to, returns count of relabelled cells
+	int Relabel(SearchContext* context, int seed, int from, int to);
+
+	int NewLabel();
+	void FreeLabel(int label);
+
+	int Neighbours(int cell, int* outNeighbours) const;
+
+	void ReallocateLabels(int newCapacity);
+
+private:
+	const unsigned char* _map;
+	int _width;
+	int _height;
+
+	int* _labels;            // per cell
+	int _cellsCapacity;
+
+	int* _sizes;             // cells count per label, 0 for unused label
+	int* _freeLabels;
+	int _freeLabelsCount;
+	int _labelsCount;        // labels used so far (with free ones)
+	int _labelsCapacity;
+
+	int _componentsCount;
+
+	IAllocator* _allocator;
+};
+
+// FindPath, which returns SearchContext::INFINITE_COST without search if start and target are in different components (or blocked)
+int FindPathConnected(SearchContext* context, const ComponentMap* components, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats = nullptr);
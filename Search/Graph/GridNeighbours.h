@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cassert>
+#include <cstdlib>
+
+#include "../Config.h"
+
+#if SIMD_GRID_EXPAND
+#include <smmintrin.h>
+#endif
+
+//  GridNeighbours
+//    Four neighbours of grid cell evaluated at once (up, right, down, left), one lane per neighbour
+//    Kernel computes neighbour nodes, packed coordinates and Manhattan heuristics to target,
+//    bounds are tested for all lanes together, map is read only for neighbours inside of map
+//    Returned mask has bit i set for passable neighbour i inside of map
+//
+//    Coordinates are packed as x | y << 16 (searches keep them in open list, node doesnt have to be divided by width)
+//    -> packed only for map width up to 65536 and height up to 32768, GridCoder keeps node of bigger maps instead
+//
+//    SSE4 version is used only when SIMD_GRID_EXPAND is set (opt in by SEARCH_SSE4, Config.h), scalar version is default
+//    Both versions give the same result, scalar one is always compiled (tests)
+
+const int GRID_MAX_PACKED_WIDTH = 1 << 16;
+const int GRID_MAX_PACKED_HEIGHT = 1 << 15;
+
+struct GridNeighbours {
+	alignas(16) int nodes[4];
+	alignas(16) int coords[4];     // x | y << 16
+	alignas(16) int heuristics[4]; // Manhattan distance to target
+};
+
+inline int GridPackCoords(int x, int y) {
+	assert(x >= 0 && x < GRID_MAX_PACKED_WIDTH);
+	assert(y >= 0 && y < GRID_MAX_PACKED_HEIGHT);
+	return x | (y << 16);
+}
+
+inline int GridUnpackX(int coords) {
+	return coords & 0xFFFF;
+}
+
+inline int GridUnpackY(int coords) {
+	return coords >> 16;
+}
+
+// Open list entry of cell: packed coordinates if map fits them, node otherwise (divided by width when decoded)
+struct GridCoder {
+	int width;
+	bool packed;
+};
+
+GridCoder GridCoderMake(int width, int height);
+
+int GridEncode(const GridCoder* coder, int x, int y);
+
+// Entry of neighbour i evaluated by GridExpand
+int GridEncodeNeighbour(const GridCoder* coder, const GridNeighbours* neighbours, int i);
+
+void GridDecode(const GridCoder* coder, int entry, int* outX, int* outY);
+
+unsigned int GridExpandScalar(int x, int y, int node, int targetX, int targetY,
+	const unsigned char* pMap, int width, int height, GridNeighbours* out);
+
+unsigned int GridExpand(int x, int y, int node, int targetX, int targetY,
+	const unsigned char* pMap, int width, int height, GridNeighbours* out);
+
+
+
+
+
+
+
+
+inline GridCoder GridCoderMake(int width, int height) {
+	return GridCoder{width, width <= GRID_MAX_PACKED_WIDTH && height <= GRID_MAX_PACKED_HEIGHT};
+}
+
+inline int GridEncode(const GridCoder* coder, int x, int y) {
+	return coder->packed ? GridPackCoords(x, y) : x + y * coder->width;
+}
+
+inline int GridEncodeNeighbour(const GridCoder* coder, const GridNeighbours* neighbours, int i) {
+	return coder->packed ? neighbours->coords[i] : neighbours->nodes[i];
+}
+
+inline void GridDecode(const GridCoder* coder, int entry, int* outX, int* outY) {
+	if (coder->packed) {
+		*outX = GridUnpackX(entry);
+		*outY = GridUnpackY(entry);
+	}
+	else {
+		*outX = entry % coder->width;
+		*outY = entry / coder->width;
+	}
+}
+
+inline unsigned int GridExpandScalar(int x, int y, int node, int targetX, int targetY,
+	const unsigned char* pMap, int width, int height, GridNeighbours* out) {
+
+	const int dx[4] = {0, 1, 0, -1};
+	const int dy[4] = {-1, 0, 1, 0};
+
+	unsigned int mask = 0;
+	for (int i = 0; i < 4; ++i) {
+		int nbx = x + dx[i];
+		int nby = y + dy[i];
+
+		out->nodes[i] = node + dx[i] + dy[i] * width;
+		out->coords[i] = nbx | (int) ((unsigned int) nby << 16);
+		out->heuristics[i] = abs(targetX - nbx) + abs(targetY - nby);
+
+		if (nbx >= 0 && nbx < width && nby >= 0 && nby < height && pMap[out->nodes[i]])
+			mask |= 1u << i;
+	}
+
+	return mask;
+}
+
+#if SIMD_GRID_EXPAND
+
+inline unsigned int GridExpand(int x, int y, int node, int targetX, int targetY,
+	const unsigned char* pMap, int width, int height, GridNeighbours* out) {
+
+	const __m128i dx = _mm_setr_epi32(0, 1, 0, -1);
+	const __m128i dy = _mm_setr_epi32(-1, 0, 1, 0);
+
+	__m128i nbx = _mm_add_epi32(_mm_set1_epi32(x), dx);
+	__m128i nby = _mm_add_epi32(_mm_set1_epi32(y), dy);
+
+	__m128i nodes = _mm_add_epi32(_mm_set1_epi32(node), _mm_add_epi32(dx, _mm_mullo_epi32(dy, _mm_set1_epi32(width))));
+	__m128i coords = _mm_or_si128(nbx, _mm_slli_epi32(nby, 16));
+	__m128i heuristics = _mm_add_epi32(
+		_mm_abs_epi32(_mm_sub_epi32(_mm_set1_epi32(targetX), nbx)),
+		_mm_abs_epi32(_mm_sub_epi32(_mm_set1_epi32(targetY), nby)));
+
+	// -1 < nb < size for both coordinates
+	const __m128i minusOne = _mm_set1_epi32(-1);
+	__m128i inside = _mm_and_si128(
+		_mm_and_si128(_mm_cmpgt_epi32(nbx, minusOne), _mm_cmpgt_epi32(_mm_set1_epi32(width), nbx)),
+		_mm_and_si128(_mm_cmpgt_epi32(nby, minusOne), _mm_cmpgt_epi32(_mm_set1_epi32(height), nby)));
+
+	_mm_store_si128(reinterpret_cast<__m128i*>(out->nodes), nodes);
+	_mm_store_si128(reinterpret_cast<__m128i*>(out->coords), coords);
+	_mm_store_si128(reinterpret_cast<__m128i*>(out->heuristics), heuristics);
+
+	unsigned int insideMask = (unsigned int) _mm_movemask_ps(_mm_castsi128_ps(inside));
+
+	// Bytes of map cant be gathered, only lanes inside of map are loaded
+	unsigned int mask = 0;
+	for (int i = 0; i < 4; ++i) {
+		if (((insideMask >> i) & 1) && pMap[out->nodes[i]])
+			mask |= 1u << i;
+	}
+
+	return mask;
+}
+
+#else
+
+inline unsigned int GridExpand(int x, int y, int node, int targetX, int targetY,
+	const unsigned char* pMap, int width, int height, GridNeighbours* out) {
+	return GridExpandScalar(x, y, node, targetX, targetY, pMap, width, height, out);
+}
+
+#endif
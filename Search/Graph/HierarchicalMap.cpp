@@ -0,0 +1,470 @@
+#include "HierarchicalMap.h"
+
+#include <cassert>
+#include <cstdlib>
+
+#include "AStar.h"
+#include "SearchContext.h"
+#include "SearchStats.h"
+
+#include "../Utility/Memory.h"
+
+
+namespace {
+	const int LONG_ENTRANCE = 6; // Entrances of this length and longer get transitions on both ends
+
+	// Border has at most clusterSize / 2 + 1 transitions (runs are separated by blocked cell)
+	const int MAX_CLUSTER_NODES = 4 * HierarchicalMap::MAX_CLUSTER_SIZE;
+
+	struct ClusterRect {
+		int x0;
+		int y0;
+		int x1; // included
+		int y1; // included
+	};
+}
+
+
+template<typename T>
+static void Reserve(IAllocator* allocator, T** data, int* capacity, int count) {
+	if (count <= *capacity)
+		return;
+
+	int newCapacity = *capacity ? *capacity * 2 : 256;
+	while (newCapacity < count)
+		newCapacity *= 2;
+
+	T* newData = static_cast<T*>(Allocate(allocator, newCapacity * sizeof(T), alignof(T)));
+	if (*data) {
+		MemCopy(newData, *data, *capacity * sizeof(T));
+		Deallocate(allocator, *data);
+	}
+
+	*data = newData;
+	*capacity = newCapacity;
+}
+
+static ClusterRect MakeClusterRect(int cluster, int clustersX, int clusterSize, int width, int height) {
+	ClusterRect rect;
+	rect.x0 = (cluster % clustersX) * clusterSize;
+	rect.y0 = (cluster / clustersX) * clusterSize;
+	rect.x1 = (rect.x0 + clusterSize < width ? rect.x0 + clusterSize : width) - 1;
+	rect.y1 = (rect.y0 + clusterSize < height ? rect.y0 + clusterSize : height) - 1;
+	return rect;
+}
+
+// Transitions of one border, cells inside of cluster are firstCell + i * step (i < length), cells outside are inside + across
+// Both clusters of border get the same transitions (runs dont depend on side)
+template<typename Callback>
+static void ForEachBorderTransition(const unsigned char* pMap, int firstCell, int step, int across, int length, Callback callback) {
+	int runStart = -1;
+	for (int i = 0; i <= length; ++i) {
+		int cell = firstCell + i * step;
+		if (i < length && pMap[cell] && pMap[cell + across]) {
+			if (runStart < 0)
+				runStart = i;
+			continue;
+		}
+
+		if (runStart < 0)
+			continue;
+
+		int runLength = i - runStart;
+		if (runLength < LONG_ENTRANCE) {
+			callback(firstCell + (runStart + runLength / 2) * step, across);
+		}
+		else {
+			callback(firstCell + runStart * step, across);
+			callback(firstCell + (i - 1) * step, across);
+		}
+
+		runStart = -1;
+	}
+}
+
+// callback(insideCell, across) for transitions on all borders of cluster
+template<typename Callback>
+static void ForEachTransition(const unsigned char* pMap, int width, const ClusterRect& rect, int clustersX, int clustersY, int cluster, Callback callback) {
+	int cx = cluster % clustersX;
+	int cy = cluster / clustersX;
+	int rectWidth = rect.x1 - rect.x0 + 1;
+	int rectHeight = rect.y1 - rect.y0 + 1;
+
+	if (cx > 0)
+		ForEachBorderTransition(pMap, rect.x0 + rect.y0 * width, width, -1, rectHeight, callback);
+	if (cx < clustersX - 1)
+		ForEachBorderTransition(pMap, rect.x1 + rect.y0 * width, width, 1, rectHeight, callback);
+	if (cy > 0)
+		ForEachBorderTransition(pMap, rect.x0 + rect.y0 * width, 1, -width, rectWidth, callback);
+	if (cy < clustersY - 1)
+		ForEachBorderTransition(pMap, rect.x0 + rect.y1 * width, 1, width, rectWidth, callback);
+}
+
+// Shortest distances from cell to given cells with paths inside of rect, SearchContext::INFINITE_COST if cell cant be reached
+// Returns count of expanded cells
+static int ClusterDistances(SearchContext* context, const unsigned char* pMap, int width, int height, const ClusterRect& rect,
+	int fromCell, const int* cells, int cellsCount, int* outDistances) {
+
+	context->Begin(width * height);
+
+	// Uniform cost, cell is reached first time with its shortest distance
+	MinPriorityQueue<int>& queue = context->OpenList();
+	queue.Add(fromCell, 0);
+	context->Reach(fromCell, 0, fromCell);
+
+	int expandedCount = 0;
+	while (!queue.Empty()) {
+		int node = queue.First();
+		queue.PopFirst();
+
+		context->Close(node);
+		++expandedCount;
+
+		int x = node % width;
+		int y = node / width;
+		int cost = context->Cost(node) + 1;
+
+		int neighbours[4];
+		int count = 0;
+		if (x > rect.x0)
+			neighbours[count++] = node - 1;
+		if (x < rect.x1)
+			neighbours[count++] = node + 1;
+		if (y > rect.y0)
+			neighbours[count++] = node - width;
+		if (y < rect.y1)
+			neighbours[count++] = node + width;
+
+		for (int i = 0; i < count; ++i) {
+			int nb = neighbours[i];
+			if (!pMap[nb] || context->IsReached(nb))
+				continue;
+
+			queue.Add(nb, cost);
+			context->Reach(nb, cost, node);
+		}
+	}
+
+	for (int i = 0; i < cellsCount; ++i)
+		outDistances[i] = context->Cost(cells[i]);
+
+	return expandedCount;
+}
+
+
+HierarchicalMap::HierarchicalMap() :
+	_width(0),
+	_height(0),
+	_clusterSize(0),
+	_clustersX(0),
+	_clustersY(0),
+	_nodesCount(0),
+	_edgesCount(0),
+	_clusterFirstNode(nullptr),
+	_nodeCells(nullptr),
+	_nodeFirstEdge(nullptr),
+	_edges(nullptr),
+	_allocator(nullptr) {
+}
+
+HierarchicalMap::~HierarchicalMap() {
+	Free();
+}
+
+void HierarchicalMap::Init(IAllocator* allocator) {
+	assert(!_allocator);
+	_allocator = allocator;
+}
+
+void HierarchicalMap::Free() {
+	if (_clusterFirstNode)
+		Deallocate(_allocator, _clusterFirstNode);
+	if (_nodeCells)
+		Deallocate(_allocator, _nodeCells);
+	if (_nodeFirstEdge)
+		Deallocate(_allocator, _nodeFirstEdge);
+	if (_edges)
+		Deallocate(_allocator, _edges);
+
+	_clusterFirstNode = nullptr;
+	_nodeCells = nullptr;
+	_nodeFirstEdge = nullptr;
+	_edges = nullptr;
+	_nodesCount = 0;
+	_edgesCount = 0;
+}
+
+void HierarchicalMap::Build(SearchContext* context, const unsigned char* pMap, const int nMapWidth, const int nMapHeight, int clusterSize) {
+	assert(_allocator);
+	assert(context);
+	assert(pMap);
+	assert(clusterSize >= 2 && clusterSize <= MAX_CLUSTER_SIZE);
+
+	Free();
+
+	_width = nMapWidth;
+	_height = nMapHeight;
+	_clusterSize = clusterSize;
+	_clustersX = (nMapWidth + clusterSize - 1) / clusterSize;
+	_clustersY = (nMapHeight + clusterSize - 1) / clusterSize;
+
+	int clustersCount = _clustersX * _clustersY;
+	_clusterFirstNode = static_cast<int*>(Allocate(_allocator, (clustersCount + 1) * sizeof(int), alignof(int)));
+
+	// Nodes, transition cell can be on two borders (corner of cluster)
+	int nodesCapacity = 0;
+	for (int cluster = 0; cluster < clustersCount; ++cluster) {
+		int first = _nodesCount;
+		_clusterFirstNode[cluster] = first;
+
+		ClusterRect rect = MakeClusterRect(cluster, _clustersX, _clusterSize, _width, _height);
+		ForEachTransition(pMap, _width, rect, _clustersX, _clustersY, cluster, [&](int cell, int) {
+			for (int i = first; i < _nodesCount; ++i) {
+				if (_nodeCells[i] == cell)
+					return;
+			}
+
+			Reserve(_allocator, &_nodeCells, &nodesCapacity, _nodesCount + 1);
+			_nodeCells[_nodesCount++] = cell;
+		});
+
+		assert(_nodesCount - first <= MAX_CLUSTER_NODES);
+	}
+	_clusterFirstNode[clustersCount] = _nodesCount;
+
+	// Edges across borders and inside of clusters
+	_nodeFirstEdge = static_cast<int*>(Allocate(_allocator, (_nodesCount + 1) * sizeof(int), alignof(int)));
+
+	int edgesCapacity = 0;
+	int distances[MAX_CLUSTER_NODES];
+
+	for (int cluster = 0; cluster < clustersCount; ++cluster) {
+		int first = _clusterFirstNode[cluster];
+		int count = _clusterFirstNode[cluster + 1] - first;
+
+		ClusterRect rect = MakeClusterRect(cluster, _clustersX, _clusterSize, _width, _height);
+
+		for (int i = first; i < first + count; ++i) {
+			_nodeFirstEdge[i] = _edgesCount;
+			int cell = _nodeCells[i];
+
+			ForEachTransition(pMap, _width, rect, _clustersX, _clustersY, cluster, [&](int inside, int across) {
+				if (inside != cell)
+					return;
+
+				int outside = inside + across;
+				int outsideCluster = Cluster(outside);
+				int nb = _clusterFirstNode[outsideCluster];
+				while (_nodeCells[nb] != outside)
+					++nb;
+
+				assert(nb < _clusterFirstNode[outsideCluster + 1]);
+
+				Reserve(_allocator, &_edges, &edgesCapacity, _edgesCount + 1);
+				_edges[_edgesCount++] = {nb, 1};
+			});
+
+			ClusterDistances(context, pMap, _width, _height, rect, cell, _nodeCells + first, count, distances);
+			for (int j = 0; j < count; ++j) {
+				if (first + j == i || distances[j] == SearchContext::INFINITE_COST)
+					continue;
+
+				Reserve(_allocator, &_edges, &edgesCapacity, _edgesCount + 1);
+				_edges[_edgesCount++] = {first + j, distances[j]};
+			}
+		}
+	}
+	_nodeFirstEdge[_nodesCount] = _edgesCount;
+}
+
+int HierarchicalMap::NodesCount() const {
+	return _nodesCount;
+}
+
+int HierarchicalMap::EdgesCount() const {
+	return _edgesCount;
+}
+
+int HierarchicalMap::Cluster(int cell) const {
+	return (cell % _width) / _clusterSize + ((cell / _width) / _clusterSize) * _clustersX;
+}
+
+int HierarchicalMap::SearchAbstract(SearchContext* abstractContext, SearchContext* context, int start, int target, const unsigned char* pMap, int* outExpandedCount) const {
+	int startNode = _nodesCount;
+	int targetNode = _nodesCount + 1;
+
+	int startCluster = Cluster(start);
+	int targetCluster = Cluster(target);
+	assert(startCluster != targetCluster);
+
+	int startFirst = _clusterFirstNode[startCluster];
+	int startCount = _clusterFirstNode[startCluster + 1] - startFirst;
+	int targetFirst = _clusterFirstNode[targetCluster];
+	int targetCount = _clusterFirstNode[targetCluster + 1] - targetFirst;
+
+	int startDistances[MAX_CLUSTER_NODES];
+	int targetDistances[MAX_CLUSTER_NODES];
+
+	int expandedCount = 0;
+	expandedCount += ClusterDistances(context, pMap, _width, _height, MakeClusterRect(startCluster, _clustersX, _clusterSize, _width, _height),
+		start, _nodeCells + startFirst, startCount, startDistances);
+	expandedCount += ClusterDistances(context, pMap, _width, _height, MakeClusterRect(targetCluster, _clustersX, _clusterSize, _width, _height),
+		target, _nodeCells + targetFirst, targetCount, targetDistances);
+
+	abstractContext->Begin(_nodesCount + 2);
+	MinPriorityQueue<int>& queue = abstractContext->OpenList();
+
+	int targetX = target % _width;
+	int targetY = target / _width;
+
+	// Edge costs are not uniform, node can be in open list multiple times, closed ones are skipped when popped
+	auto relax = [&](int node, int cost, int fromNode) {
+		if (abstractContext->IsClosed(node) || cost >= abstractContext->Cost(node))
+			return;
+
+		int cell = node == targetNode ? target : _nodeCells[node];
+		int heur = abs(targetX - cell % _width) + abs(targetY - cell / _width);
+
+		queue.Add(node, cost + heur);
+		abstractContext->Reach(node, cost, fromNode);
+	};
+
+	abstractContext->Reach(startNode, 0, startNode);
+	abstractContext->Close(startNode);
+
+	for (int i = 0; i < startCount; ++i) {
+		if (startDistances[i] != SearchContext::INFINITE_COST)
+			relax(startFirst + i, startDistances[i], startNode);
+	}
+
+	while (!queue.Empty()) {
+		int node = queue.First();
+		queue.PopFirst();
+
+		if (node == targetNode)
+			break;
+
+		if (abstractContext->IsClosed(node))
+			continue;
+
+		abstractContext->Close(node);
+		++expandedCount;
+
+		int cost = abstractContext->Cost(node);
+
+		for (int i = _nodeFirstEdge[node]; i < _nodeFirstEdge[node + 1]; ++i)
+			relax(_edges[i].node, cost + _edges[i].cost, node);
+
+		if (node >= targetFirst && node < targetFirst + targetCount && targetDistances[node - targetFirst] != SearchContext::INFINITE_COST)
+			relax(targetNode, cost + targetDistances[node - targetFirst], node);
+	}
+
+	*outExpandedCount = expandedCount;
+	return abstractContext->Cost(targetNode);
+}
+
+
+int FindAbstractPath(const HierarchicalMap* map, SearchContext* abstractContext, SearchContext* context,
+	const int nStartX, const int nStartY, const int nTargetX, const int nTargetY, const unsigned char* pMap,
+	int* pOutWaypoints, const int nOutWaypointsSize, int* outWaypointsCount) {
+
+	assert(map);
+	assert(abstractContext);
+	assert(context);
+	assert(outWaypointsCount);
+
+	int start = nStartX + nStartY * map->_width;
+	int target = nTargetX + nTargetY * map->_width;
+
+	// Inside of one cluster, there are no waypoints between start and target
+	if (map->Cluster(start) == map->Cluster(target)) {
+		int cost = FindPath(context, nStartX, nStartY, nTargetX, nTargetY, pMap, map->_width, map->_height, nullptr, 0);
+		*outWaypointsCount = cost == SearchContext::INFINITE_COST ? 0 : 2;
+
+		if (*outWaypointsCount <= nOutWaypointsSize && *outWaypointsCount == 2) {
+			pOutWaypoints[0] = start;
+			pOutWaypoints[1] = target;
+		}
+		return cost;
+	}
+
+	int expandedCount;
+	int cost = map->SearchAbstract(abstractContext, context, start, target, pMap, &expandedCount);
+	if (cost == SearchContext::INFINITE_COST) {
+		*outWaypointsCount = 0;
+		return cost;
+	}
+
+	int startNode = map->_nodesCount;
+	int targetNode = map->_nodesCount + 1;
+
+	int count = 1;
+	for (int node = targetNode; node != startNode; node = abstractContext->FromNode(node))
+		++count;
+
+	*outWaypointsCount = count;
+	if (count <= nOutWaypointsSize) {
+		int node = targetNode;
+		for (int i = count - 1; i >= 0; --i) {
+			pOutWaypoints[i] = node == targetNode ? target : (node == startNode ? start : map->_nodeCells[node]);
+			if (node != startNode)
+				node = abstractContext->FromNode(node);
+		}
+	}
+
+	return cost;
+}
+
+int FindPathHierarchical(const HierarchicalMap* map, SearchContext* abstractContext, SearchContext* context,
+	const int nStartX, const int nStartY, const int nTargetX, const int nTargetY, const unsigned char* pMap,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats) {
+
+	assert(map);
+	assert(abstractContext);
+	assert(context);
+
+	int start = nStartX + nStartY * map->_width;
+	int target = nTargetX + nTargetY * map->_width;
+
+	if (map->Cluster(start) == map->Cluster(target))
+		return FindPath(context, nStartX, nStartY, nTargetX, nTargetY, pMap, map->_width, map->_height, pOutBuffer, nOutBufferSize, outStats);
+
+	// Allocations of abstract search are counted too
+	SearchCounters counters = SearchCountersBegin(abstractContext->OpenList().ReallocationsCount() + context->OpenList().ReallocationsCount(),
+		abstractContext->ReallocationsCount() + context->ReallocationsCount(), 0);
+
+	int pathCost = map->SearchAbstract(abstractContext, context, start, target, pMap, &counters.expandedCount);
+
+	if (pathCost != SearchContext::INFINITE_COST) {
+		int startNode = map->_nodesCount;
+		int targetNode = map->_nodesCount + 1;
+
+		// Segments from target back to start, FindPath writes segment from its end back to its start -> path is in FindPath order
+		pathCost = 0;
+		for (int node = targetNode; node != startNode; ) {
+			int fromNode = abstractContext->FromNode(node);
+			int from = fromNode == startNode ? start : map->_nodeCells[fromNode];
+			int to = node == targetNode ? target : map->_nodeCells[node];
+
+			bool fits = pathCost < nOutBufferSize;
+
+			SearchStats segmentStats;
+			int segmentCost = FindPath(context, from % map->_width, from / map->_width, to % map->_width, to / map->_width,
+				pMap, map->_width, map->_height, fits ? pOutBuffer + pathCost : nullptr, fits ? nOutBufferSize - pathCost : 0, &segmentStats);
+
+			assert(segmentCost != SearchContext::INFINITE_COST);
+			pathCost += segmentCost;
+
+			counters.expandedCount += segmentStats.expandedCount;
+			counters.pushedCount += segmentStats.pushedCount;
+			SearchCountersOpen(&counters, static_cast<unsigned int>(segmentStats.peakOpenCount));
+
+			node = fromNode;
+		}
+	}
+
+	SearchCountersWrite(&counters, abstractContext->OpenList().ReallocationsCount() + context->OpenList().ReallocationsCount(),
+		abstractContext->ReallocationsCount() + context->ReallocationsCount(), outStats);
+
+	return pathCost;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "../Allocator/IAllocator.h"
+
+class SearchContext;
+struct SearchStats;
+
+//  HierarchicalMap (HPA*)
+//    Abstraction of grid map, map is split into clusters (clusterSize x clusterSize cells)
+//    Entrance is run of cells passable on both sides of border between two clusters
+//    Entrance gets one transition in its middle (two on its ends, if entrance is long), transition cells are abstract nodes
+//    Abstract edges connect nodes of the same cluster (shortest path inside of cluster) and transitions across border (cost 1)
+//
+//    Build is done once for map (rebuilt when passability changes), map is read only after that
+//    Queries from more threads are fine, every thread needs its own contexts
+//    Paths are near optimal (they go through transitions), usually few percent longer than shortest path
+//
+//    Other INTERNAL implementation details:
+//      Nodes of cluster are stored together (_clusterFirstNode), edges of node are stored together (_nodeFirstEdge)
+//      Query adds start and target as temporary nodes (NodesCount(), NodesCount() + 1), they are connected by search in their clusters
+
+class HierarchicalMap {
+public:
+	static const int MAX_CLUSTER_SIZE = 64;
+
+private:
+	struct Edge {
+		int node;
+		int cost;
+	};
+
+public:
+	HierarchicalMap();
+	~HierarchicalMap();
+
+	HierarchicalMap(const HierarchicalMap& oth) = delete;
+	HierarchicalMap& operator=(const HierarchicalMap& rhs) = delete;
+
+	void Init(IAllocator* allocator);
+
+	// Context is used for searches inside of clusters
+	void Build(SearchContext* context, const unsigned char* pMap, const int nMapWidth, const int nMapHeight, int clusterSize);
+
+	int NodesCount() const;
+	int EdgesCount() const;
+
+private:
+	friend int FindAbstractPath(const HierarchicalMap* map, SearchContext* abstractContext, SearchContext* context,
+		const int nStartX, const int nStartY, const int nTargetX, const int nTargetY, const unsigned char* pMap,
+		int* pOutWaypoints, const int nOutWaypointsSize, int* outWaypointsCount);
+
+	friend int FindPathHierarchical(const HierarchicalMap* map, SearchContext* abstractContext, SearchContext* context,
+		const int nStartX, const int nStartY, const int nTargetX, const int nTargetY, const unsigned char* pMap,
+		int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats);
+
+	int Cluster(int cell) const;
+
+	// Abstract search from start to target, path is left in abstract context (from nodes)
+	int SearchAbstract(SearchContext* abstractContext, SearchContext* context, int start, int target, const unsigned char* pMap, int* outExpandedCount) const;
+
+	void Free();
+
+private:
+	int _width;
+	int _height;
+	int _clusterSize;
+	int _clustersX;
+	int _clustersY;
+
+	int _nodesCount;
+	int _edgesCount;
+
+	int* _clusterFirstNode; // clusters count + 1
+	int* _nodeCells;
+	int* _nodeFirstEdge;    // nodes count + 1
+	Edge* _edges;
+
+	IAllocator* _allocator;
+};
+
+// Abstract path without refinement, waypoints are cells (x + y * width) from start to target (both included)
+// Consecutive waypoints are in the same cluster or next to each other
+// Returns cost of abstract path, SearchContext::INFINITE_COST if target is unreachable
+// Waypoints are written only if all of them fit into buffer, their count is always written
+int FindAbstractPath(const HierarchicalMap* map, SearchContext* abstractContext, SearchContext* context,
+	const int nStartX, const int nStartY, const int nTargetX, const int nTargetY, const unsigned char* pMap,
+	int* pOutWaypoints, const int nOutWaypointsSize, int* outWaypointsCount);
+
+// Abstract path refined by FindPath between waypoints, same output as FindPath (cost of path is not always the lowest)
+int FindPathHierarchical(const HierarchicalMap* map, SearchContext* abstractContext, SearchContext* context,
+	const int nStartX, const int nStartY, const int nTargetX, const int nTargetY, const unsigned char* pMap,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats = nullptr);
@@ -0,0 +1,302 @@
+#include "IncrementalSearch.h"
+
+#include <cassert>
+#include <cstdlib>
+
+#include "SearchStats.h"
+
+#include "../Utility/Timer.h"
+
+
+namespace {
+	const unsigned int FIRST_STAMP = 1;
+}
+
+
+IncrementalSearch::IncrementalSearch() :
+	_map(nullptr),
+	_width(0),
+	_height(0),
+	_target(0),
+	_start(0),
+	_lastStart(0),
+	_keyModifier(0),
+	_stamp(FIRST_STAMP),
+	_capacity(0),
+	_nodes(nullptr),
+	_counters(),
+	_allocator(nullptr) {
+}
+
+IncrementalSearch::~IncrementalSearch() {
+	if (_nodes) {
+		Deallocate(_allocator, _nodes);
+	}
+}
+
+void IncrementalSearch::Init(IAllocator* allocator) {
+	assert(!_allocator);
+	_allocator = allocator;
+	_openList.Init(allocator);
+}
+
+void IncrementalSearch::Begin(const unsigned char* pMap, const int nMapWidth, const int nMapHeight, const int nTargetX, const int nTargetY) {
+	assert(_allocator);
+	assert(pMap);
+
+	int nodesCount = nMapWidth * nMapHeight;
+	if (nodesCount > _capacity) {
+		Reallocate(nodesCount);
+	}
+	else if (_stamp == 0xFFffFFffu) {
+		ClearStamps();
+	}
+	else {
+		++_stamp;
+	}
+
+	_map = pMap;
+	_width = nMapWidth;
+	_height = nMapHeight;
+
+	_target = nTargetX + nTargetY * nMapWidth;
+	_start = _target;
+	_lastStart = _target;
+	_keyModifier = 0;
+
+	_openList.Clear();
+
+	State(_target).rhs = 0;
+	_openList.Add(_target, Key(_target));
+}
+
+void IncrementalSearch::UpdateCells(const int* cells, int cellsCount) {
+	assert(_map);
+
+	// Edges to changed cell and from it have changed
+	for (int i = 0; i < cellsCount; ++i) {
+		int node = cells[i];
+		assert(node >= 0 && node < _width * _height);
+
+		int x = node % _width;
+		int y = node / _width;
+
+		UpdateNode(node);
+		if (x > 0)
+			UpdateNode(node - 1);
+		if (x < _width - 1)
+			UpdateNode(node + 1);
+		if (y > 0)
+			UpdateNode(node - _width);
+		if (y < _height - 1)
+			UpdateNode(node + _width);
+	}
+}
+
+int IncrementalSearch::FindPath(const int nStartX, const int nStartY, int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats) {
+	assert(_map);
+
+	// Nodes left in open list from last call were pushed by it, they count only to peak
+	_counters = SearchCountersBegin(_openList.ReallocationsCount(), 0, 0);
+	SearchCountersOpen(&_counters, _openList.Count());
+
+	// Keys in open list were computed from last start, they stay lower bounds with bigger modifier
+	_start = nStartX + nStartY * _width;
+	_keyModifier += Heuristic(_lastStart, _start);
+	_lastStart = _start;
+
+	// Blocked start never becomes consistent (rhs stays INFINITE_COST), search would expand whole region of target
+	bool passable = _map[_start] && _map[_target];
+
+	if (passable) {
+		PROFILE_START(incrementalSearch)
+
+		ComputeShortestPath();
+
+		PROFILE_END_LOG(incrementalSearch);
+	}
+
+	int pathCost = passable ? G(_start) : INFINITE_COST;
+
+	if (pathCost != INFINITE_COST && pathCost < nOutBufferSize) {
+		// Path goes down the g values, written from target back to start
+		int node = _start;
+		for (int i = pathCost - 1; i >= 0; --i) {
+			int x = node % _width;
+			int y = node / _width;
+
+			int neighbours[4];
+			int count = 0;
+			if (x > 0)
+				neighbours[count++] = node - 1;
+			if (x < _width - 1)
+				neighbours[count++] = node + 1;
+			if (y > 0)
+				neighbours[count++] = node - _width;
+			if (y < _height - 1)
+				neighbours[count++] = node + _width;
+
+			int next = -1;
+			for (int j = 0; j < count; ++j) {
+				int nb = neighbours[j];
+				if (_map[nb] && G(nb) == G(node) - 1) {
+					next = nb;
+					break;
+				}
+			}
+
+			assert(next >= 0);
+			pOutBuffer[i] = next;
+			node = next;
+		}
+		assert(node == _target);
+	}
+
+	SearchCountersWrite(&_counters, _openList.ReallocationsCount(), 0, outStats);
+
+	return pathCost;
+}
+
+inline IncrementalSearch::NodeState& IncrementalSearch::State(int node) {
+	assert(node >= 0 && node < _width * _height);
+	NodeState& state = _nodes[node];
+	if (state.stamp != _stamp) {
+		state.stamp = _stamp;
+		state.g = INFINITE_COST;
+		state.rhs = INFINITE_COST;
+	}
+	return state;
+}
+
+inline int IncrementalSearch::G(int node) const {
+	assert(node >= 0 && node < _width * _height);
+	return _nodes[node].stamp == _stamp ? _nodes[node].g : INFINITE_COST;
+}
+
+inline int IncrementalSearch::Rhs(int node) const {
+	assert(node >= 0 && node < _width * _height);
+	return _nodes[node].stamp == _stamp ? _nodes[node].rhs : INFINITE_COST;
+}
+
+inline unsigned int IncrementalSearch::Key(int node) const {
+	int g = G(node);
+	int rhs = Rhs(node);
+	int cost = g < rhs ? g : rhs;
+	assert(cost != INFINITE_COST);
+	return cost + Heuristic(_start, node) + _keyModifier;
+}
+
+inline int IncrementalSearch::Heuristic(int from, int to) const {
+	return abs(from % _width - to % _width) + abs(from / _width - to / _width);
+}
+
+void IncrementalSearch::UpdateNode(int node) {
+	if (node == _target)
+		return;
+
+	int rhs = INFINITE_COST;
+	if (_map[node]) {
+		int x = node % _width;
+		int y = node / _width;
+
+		if (x > 0 && _map[node - 1] && G(node - 1) < rhs)
+			rhs = G(node - 1);
+		if (x < _width - 1 && _map[node + 1] && G(node + 1) < rhs)
+			rhs = G(node + 1);
+		if (y > 0 && _map[node - _width] && G(node - _width) < rhs)
+			rhs = G(node - _width);
+		if (y < _height - 1 && _map[node + _width] && G(node + _width) < rhs)
+			rhs = G(node + _width);
+
+		if (rhs != INFINITE_COST)
+			++rhs;
+	}
+
+	// Inconsistent node with unchanged rhs is already in open list
+	if (rhs == Rhs(node))
+		return;
+
+	State(node).rhs = rhs;
+
+	// Consistent nodes can stay in open list, they are skipped when popped
+	if (G(node) != rhs)
+		AddOpen(node);
+}
+
+void IncrementalSearch::AddOpen(int node) {
+	_openList.Add(node, Key(node));
+	++_counters.pushedCount;
+	SearchCountersOpen(&_counters, _openList.Count());
+}
+
+void IncrementalSearch::ComputeShortestPath() {
+	while (!_openList.Empty()) {
+		int node = _openList.First();
+		unsigned int oldKey = _openList.FirstWeight();
+
+		// Keys in open list are lower bounds, nodes with keys up to start key can still change start
+		// Equal keys are expanded too (open list has no second key to break ties)
+		int startCost = G(_start) < Rhs(_start) ? G(_start) : Rhs(_start);
+		if (startCost != INFINITE_COST && G(_start) == Rhs(_start) && oldKey > (unsigned int) (startCost + _keyModifier))
+			break;
+
+		_openList.PopFirst();
+
+		int g = G(node);
+		int rhs = Rhs(node);
+		if (g == rhs)
+			continue;
+
+		unsigned int key = Key(node);
+		if (oldKey != key) {
+			// Lower key is from older start (node is added again), higher key was already added again
+			if (oldKey < key)
+				AddOpen(node);
+			continue;
+		}
+
+		++_counters.expandedCount;
+
+		NodeState& state = State(node);
+		if (g > rhs) {
+			state.g = rhs;
+		}
+		else {
+			// Node is underconsistent, its rhs doesnt depend on its g
+			state.g = INFINITE_COST;
+			if (rhs != INFINITE_COST)
+				AddOpen(node);
+		}
+
+		int x = node % _width;
+		int y = node / _width;
+
+		if (x > 0)
+			UpdateNode(node - 1);
+		if (x < _width - 1)
+			UpdateNode(node + 1);
+		if (y > 0)
+			UpdateNode(node - _width);
+		if (y < _height - 1)
+			UpdateNode(node + _width);
+	}
+}
+
+void IncrementalSearch::Reallocate(int newCapacity) {
+	if (_nodes) {
+		Deallocate(_allocator, _nodes);
+	}
+
+	_nodes = static_cast<NodeState*>(Allocate(_allocator, newCapacity * sizeof(NodeState), alignof(NodeState)));
+	_capacity = newCapacity;
+
+	ClearStamps();
+}
+
+void IncrementalSearch::ClearStamps() {
+	for (int i = 0; i < _capacity; ++i) {
+		_nodes[i].stamp = 0;
+	}
+
+	_stamp = FIRST_STAMP;
+}
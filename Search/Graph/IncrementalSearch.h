@@ -0,0 +1,86 @@
+#pragma once
+
+#include "../Allocator/IAllocator.h"
+#include "../Collection/MinPriorityQueue.h"
+
+#include "SearchStats.h"
+
+
+//  IncrementalSearch (D* Lite)
+//    Search to one target, which keeps its state between FindPath calls
+//    After cells of map are changed (UpdateCells), only affected part of search is repaired
+//    Start can move between calls (agent walks along its path), search is done from target to start
+//    Map memory is not copied, caller changes it and reports changed cells
+//    Not thread safe, one search per agent (target) and thread
+//
+//    Other INTERNAL implementation details:
+//      g is distance to target, rhs is one step lookahead (min of neighbours g + 1), node is consistent when g == rhs
+//      Open list keys are min(g, rhs) + h(start, node) + _keyModifier, key modifier grows when start moves (old keys stay lower bounds)
+//      Open list doesnt support key updates, node is added again with new key, old entries are skipped when popped
+//      Node states are stamped with generation (same as SearchContext), Begin doesnt have to clear them
+
+class IncrementalSearch {
+public:
+	static const int INFINITE_COST = 0x7fffffff;
+
+private:
+	struct NodeState {
+		unsigned int stamp;
+		int g;
+		int rhs;
+	};
+
+public:
+	IncrementalSearch();
+	~IncrementalSearch();
+
+	IncrementalSearch(const IncrementalSearch& oth) = delete;
+	IncrementalSearch& operator=(const IncrementalSearch& rhs) = delete;
+
+	void Init(IAllocator* allocator);
+
+	// Starts new search to target, previous state is dropped
+	void Begin(const unsigned char* pMap, const int nMapWidth, const int nMapHeight, const int nTargetX, const int nTargetY);
+
+	// Cells (x + y * width) which passability was changed in map since last call
+	void UpdateCells(const int* cells, int cellsCount);
+
+	// Same output as FindPath, INFINITE_COST if target is unreachable (or start or target is blocked)
+	int FindPath(const int nStartX, const int nStartY, int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats = nullptr);
+
+private:
+	NodeState& State(int node);
+	int G(int node) const;
+	int Rhs(int node) const;
+	unsigned int Key(int node) const;
+	int Heuristic(int from, int to) const;
+
+	// Recomputes rhs of node, adds it to open list if it becomes inconsistent
+	void UpdateNode(int node);
+	void AddOpen(int node);
+	void ComputeShortestPath();
+
+	void Reallocate(int newCapacity);
+	void ClearStamps();
+
+private:
+	const unsigned char* _map;
+	int _width;
+	int _height;
+
+	int _target;
+	int _start;
+	int _lastStart;
+	int _keyModifier;
+
+	unsigned int _stamp;
+	int _capacity;
+	NodeState* _nodes;
+
+	MinPriorityQueue<int> _openList;
+
+	// Counters of current FindPath call
+	SearchCounters _counters;
+
+	IAllocator* _allocator;
+};
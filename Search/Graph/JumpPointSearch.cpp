@@ -0,0 +1,260 @@
+#include "JumpPointSearch.h"
+
+#include <cassert>
+#include <cstdlib>
+
+#include "SearchContext.h"
+#include "PassabilityMap.h"
+#include "SearchStats.h"
+
+#include "../Utility/Util.h"
+
+#include "../Utility/Timer.h"
+
+
+struct JumpGrid {
+	const unsigned char* map;
+	int width;
+	int height;
+	int targetX;
+	int targetY;
+};
+
+// Same grid in bits, horizontal jumps scan 64 cells at once
+struct BitJumpGrid {
+	const PassabilityMap* map;
+	int width;
+	int height;
+	int targetX;
+	int targetY;
+};
+
+static inline bool IsPassable(const JumpGrid* grid, int x, int y) {
+	return x >= 0 && x < grid->width && y >= 0 && y < grid->height && grid->map[x + y * grid->width] != 0;
+}
+
+static inline bool IsPassable(const BitJumpGrid* grid, int x, int y) {
+	return PassabilityMapIs(grid->map, x, y);
+}
+
+// Returns x of jump point in row y, or -1 if there is none
+static int JumpHorizontal(const JumpGrid* grid, int x, int y, int dx) {
+	for (;;) {
+		x += dx;
+
+		if (!IsPassable(grid, x, y))
+			return -1;
+
+		if (x == grid->targetX && y == grid->targetY)
+			return x;
+
+		// Cell above or below became reachable only around obstacle
+		if ((IsPassable(grid, x, y - 1) && !IsPassable(grid, x - dx, y - 1)) ||
+			(IsPassable(grid, x, y + 1) && !IsPassable(grid, x - dx, y + 1)))
+			return x;
+	}
+}
+
+// Same as JumpHorizontal on bytes, blocked cells, forced neighbours and target are found as bit masks of 64 cells
+static int JumpHorizontal(const BitJumpGrid* grid, int x, int y, int dx) {
+	const PassabilityMap* map = grid->map;
+
+	if (dx > 0) {
+		// Window of cells [p, p + 63], bit 0 is p
+		for (int p = x + 1; ; p += 64) {
+			unsigned long long blocked = ~PassabilityMapRowBits(map, p, y);
+			unsigned long long up = PassabilityMapRowBits(map, p, y - 1);
+			unsigned long long down = PassabilityMapRowBits(map, p, y + 1);
+			unsigned long long forced = (up & ~PassabilityMapRowBits(map, p - 1, y - 1)) | (down & ~PassabilityMapRowBits(map, p - 1, y + 1));
+
+			unsigned long long stop = blocked | forced;
+			if (y == grid->targetY && grid->targetX >= p && grid->targetX - p < 64)
+				stop |= 1ull << (grid->targetX - p);
+
+			if (stop) {
+				int bit = CountTrailingZeros64(stop);
+				return ((blocked >> bit) & 1) ? -1 : p + bit;
+			}
+		}
+	}
+	else {
+		// Window of cells [p - 63, p], bit 63 is p
+		for (int p = x - 1; ; p -= 64) {
+			int first = p - 63;
+			unsigned long long blocked = ~PassabilityMapRowBits(map, first, y);
+			unsigned long long up = PassabilityMapRowBits(map, first, y - 1);
+			unsigned long long down = PassabilityMapRowBits(map, first, y + 1);
+			unsigned long long forced = (up & ~PassabilityMapRowBits(map, first + 1, y - 1)) | (down & ~PassabilityMapRowBits(map, first + 1, y + 1));
+
+			unsigned long long stop = blocked | forced;
+			if (y == grid->targetY && grid->targetX <= p && p - grid->targetX < 64)
+				stop |= 1ull << (grid->targetX - first);
+
+			if (stop) {
+				int bit = 63 - CountLeadingZeros64(stop);
+				return ((blocked >> bit) & 1) ? -1 : first + bit;
+			}
+		}
+	}
+}
+
+// Returns y of jump point in column x, or -1 if there is none
+template<typename Grid>
+static int JumpVertical(const Grid* grid, int x, int y, int dy) {
+	for (;;) {
+		y += dy;
+
+		if (!IsPassable(grid, x, y))
+			return -1;
+
+		if (x == grid->targetX && y == grid->targetY)
+			return y;
+
+		if (JumpHorizontal(grid, x, y, 1) >= 0 || JumpHorizontal(grid, x, y, -1) >= 0)
+			return y;
+	}
+}
+
+static inline int Sign(int x) {
+	return (x > 0) - (x < 0);
+}
+
+template<typename Grid>
+static bool AddSuccessor(SearchContext* context, const Grid* grid, int node, int cost, int x, int y, int nbx, int nby) {
+	int nb = nbx + nby * grid->width;
+	if (context->IsClosed(nb))
+		return false;
+
+	int nbCost = cost + abs(nbx - x) + abs(nby - y);
+	if (nbCost >= context->Cost(nb))
+		return false;
+
+	int heur = abs(grid->targetX - nbx) + abs(grid->targetY - nby);
+
+	// Jumps have different lengths, node can be in open list multiple times, closed ones are skipped when popped
+	context->OpenList().Add(nb, nbCost + heur);
+	context->Reach(nb, nbCost, node);
+	return true;
+}
+
+template<typename Grid>
+static int JumpPointSearch(SearchContext* context, const Grid* grid, const int nStartX, const int nStartY,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats) {
+
+	assert(context);
+
+	SearchCounters counters = SearchCountersBegin(context->OpenList().ReallocationsCount(), context->ReallocationsCount(), 1);
+
+	const int nMapWidth = grid->width;
+
+	int nodesCount = grid->width * grid->height;
+	int start = nStartX + nStartY * nMapWidth;
+	int target = grid->targetX + grid->targetY * nMapWidth;
+	context->Begin(nodesCount);
+
+	MinPriorityQueue<int>& queue = context->OpenList();
+	queue.Add(start, 0);
+
+	context->Reach(start, 0, start);
+
+	bool found = false;
+
+	PROFILE_START(jumpPointSearch)
+
+	while (!queue.Empty()) {
+		int node = queue.First();
+
+		queue.PopFirst();
+
+		if (node == target) {
+			found = true;
+			break;
+		}
+
+		if (context->IsClosed(node))
+			continue;
+
+		context->Close(node);
+		++counters.expandedCount;
+
+		int y = node / nMapWidth;
+		int x = node % nMapWidth;
+
+		int cost = context->Cost(node);
+
+		int from = context->FromNode(node);
+		int dx = Sign(x - from % nMapWidth);
+		int dy = Sign(y - from / nMapWidth);
+
+		bool vertical = dx == 0; // Start node has all directions, same as after vertical move
+		bool up = vertical ? dy <= 0 : IsPassable(grid, x, y - 1) && !IsPassable(grid, x - dx, y - 1);
+		bool down = vertical ? dy >= 0 : IsPassable(grid, x, y + 1) && !IsPassable(grid, x - dx, y + 1);
+
+		if (up) {
+			int jy = JumpVertical(grid, x, y, -1);
+			if (jy >= 0)
+				counters.pushedCount += AddSuccessor(context, grid, node, cost, x, y, x, jy);
+		}
+
+		if (down) {
+			int jy = JumpVertical(grid, x, y, 1);
+			if (jy >= 0)
+				counters.pushedCount += AddSuccessor(context, grid, node, cost, x, y, x, jy);
+		}
+
+		if (vertical || dx > 0) {
+			int jx = JumpHorizontal(grid, x, y, 1);
+			if (jx >= 0)
+				counters.pushedCount += AddSuccessor(context, grid, node, cost, x, y, jx, y);
+		}
+
+		if (vertical || dx < 0) {
+			int jx = JumpHorizontal(grid, x, y, -1);
+			if (jx >= 0)
+				counters.pushedCount += AddSuccessor(context, grid, node, cost, x, y, jx, y);
+		}
+
+		SearchCountersOpen(&counters, queue.Count());
+	}
+
+	PROFILE_END_LOG(jumpPointSearch);
+
+	int pathCost = context->Cost(target);
+
+	if (found && pathCost < nOutBufferSize) {
+		// Jump points are connected by straight lines, cells between them are added
+		int node = target;
+		int i = 0;
+		while (node != start) {
+			int from = context->FromNode(node);
+			int step = from > node ? (from - node < nMapWidth ? 1 : nMapWidth) : (node - from < nMapWidth ? -1 : -nMapWidth);
+
+			for (; node != from; node += step)
+				pOutBuffer[i++] = node;
+		}
+		assert(i == pathCost);
+	}
+
+	SearchCountersWrite(&counters, queue.ReallocationsCount(), context->ReallocationsCount(), outStats);
+
+	return pathCost;
+}
+
+
+int FindPathJPS(SearchContext* context, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats) {
+
+	JumpGrid grid = {pMap, nMapWidth, nMapHeight, nTargetX, nTargetY};
+	return JumpPointSearch(context, &grid, nStartX, nStartY, pOutBuffer, nOutBufferSize, outStats);
+}
+
+int FindPathJPS(SearchContext* context, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const PassabilityMap* map,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats) {
+
+	BitJumpGrid grid = {map, map->width, map->height, nTargetX, nTargetY};
+	return JumpPointSearch(context, &grid, nStartX, nStartY, pOutBuffer, nOutBufferSize, outStats);
+}
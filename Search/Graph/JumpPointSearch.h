@@ -0,0 +1,27 @@
+#pragma once
+
+class SearchContext;
+struct SearchStats;
+struct PassabilityMap;
+
+//  FindPathJPS
+//    Jump point search on uniform cost 4way grid, same inputs and outputs as FindPath
+//    Only jump points are pushed into open list, path cost is the same as A* path cost
+//    Writes path from target (inclusive) to start (exclusive) into pOutBuffer, if it fits (every cell, not only jump points)
+//    Returns path cost, SearchContext::INFINITE_COST if target is unreachable
+//
+//    Canonical paths are vertical first, horizontal moves turn vertical only around obstacles (forced neighbours)
+//    Vertical jump stops on cells from which horizontal jump finds jump point
+//
+//    Version with PassabilityMap does horizontal jumps on 64 cells at once
+//    Counters of the search are written into outStats, if given (expanded nodes are jump points)
+
+int FindPathJPS(SearchContext* context, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats = nullptr);
+
+int FindPathJPS(SearchContext* context, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const PassabilityMap* map,
+	int* pOutBuffer, const int nOutBufferSize, SearchStats* outStats = nullptr);
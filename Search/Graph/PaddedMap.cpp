@@ -0,0 +1,38 @@
+#include "PaddedMap.h"
+
+#include "../Utility/Memory.h"
+
+
+static int StrideShift(int width) {
+	int shift = 0;
+	while ((1 << shift) < width + 2)
+		++shift;
+	return shift;
+}
+
+
+size_t PaddedMapMemorySize(int width, int height) {
+	return ((size_t) 1 << StrideShift(width)) * (height + 2);
+}
+
+PaddedMap PaddedMapMake(void* mem, int width, int height) {
+	PaddedMap res;
+	res.width = width;
+	res.height = height;
+	res.strideShift = StrideShift(width);
+	res.stride = 1 << res.strideShift;
+	res.cells = static_cast<unsigned char*>(mem);
+	return res;
+}
+
+void PaddedMapBuild(PaddedMap* map, const unsigned char* pMap) {
+	// Border and stride padding are blocked, rows are copied into place
+	MemSet(map->cells, 0, PaddedMapMemorySize(map->width, map->height));
+
+	for (int y = 0; y < map->height; ++y) {
+		unsigned char* row = map->cells + PaddedMapIndex(map, 0, y);
+		const unsigned char* srcRow = pMap + y * map->width;
+		for (int x = 0; x < map->width; ++x)
+			row[x] = srcRow[x] ? 1 : 0;
+	}
+}
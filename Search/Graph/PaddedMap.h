@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+
+//  PaddedMap
+//    Copy of byte map with one cell blocked border around it, rows have power of two stride (width + 2 rounded up)
+//    Cell x, y of map is index (x + 1) + (y + 1) * stride, neighbours are index -1, +1, -stride, +stride
+//    -> searches dont test bounds (border is blocked), coordinates of index are mask and shift (no division)
+//    Index of search has to be translated back to caller's node (x + y * width), PaddedMapNode
+//    Memory is given by caller (PaddedMapMemorySize bytes), map doesnt own it
+
+struct PaddedMap {
+	int width;
+	int height;
+	int stride;      // power of two, at least width + 2
+	int strideShift; // log2 of stride
+	unsigned char* cells;
+};
+
+size_t PaddedMapMemorySize(int width, int height);
+
+PaddedMap PaddedMapMake(void* mem, int width, int height);
+
+// Copies byte map (0 is blocked, anything else is passable) into the padded layout, border is blocked
+void PaddedMapBuild(PaddedMap* map, const unsigned char* pMap);
+
+// Count of indices (border included), searches on padded map need context with this many nodes
+int PaddedMapIndicesCount(const PaddedMap* map);
+
+int PaddedMapIndex(const PaddedMap* map, int x, int y);
+
+// Coordinates in caller's map
+int PaddedMapX(const PaddedMap* map, int index);
+int PaddedMapY(const PaddedMap* map, int index);
+
+// Caller's node (x + y * width) of index
+int PaddedMapNode(const PaddedMap* map, int index);
+
+
+
+
+
+
+
+
+inline int PaddedMapIndicesCount(const PaddedMap* map) {
+	return map->stride * (map->height + 2);
+}
+
+inline int PaddedMapIndex(const PaddedMap* map, int x, int y) {
+	assert(x >= -1 && x <= map->width && y >= -1 && y <= map->height);
+	return (x + 1) + ((y + 1) << map->strideShift);
+}
+
+inline int PaddedMapX(const PaddedMap* map, int index) {
+	return (index & (map->stride - 1)) - 1;
+}
+
+inline int PaddedMapY(const PaddedMap* map, int index) {
+	return (index >> map->strideShift) - 1;
+}
+
+inline int PaddedMapNode(const PaddedMap* map, int index) {
+	return PaddedMapX(map, index) + PaddedMapY(map, index) * map->width;
+}
@@ -0,0 +1,143 @@
+#include "PassabilityMap.h"
+
+#include <cassert>
+
+#include "../Utility/Util.h"
+
+
+// Bits [bit, bit + 64) of words [first, first + count), words outside are 0
+static inline unsigned long long ReadBits64(const BitArray* arr, int first, int count, int bit) {
+	int word = bit >= 0 ? bit >> 6 : -((-bit + 63) >> 6);
+	int shift = bit - word * 64;
+
+	unsigned long long lo = (word >= 0 && word < count) ? BitArrayWord64(arr, first + word) : 0;
+	unsigned long long hi = (word + 1 >= 0 && word + 1 < count) ? BitArrayWord64(arr, first + word + 1) : 0;
+
+	return shift == 0 ? lo : (lo >> shift) | (hi << (64 - shift));
+}
+
+static inline int WordsCount(int bits) {
+	return (int) (((long long) bits + 63) >> 6);
+}
+
+
+size_t PassabilityMapMemorySize(int width, int height) {
+	return ((size_t) WordsCount(width) * height + (size_t) WordsCount(height) * width) * sizeof(unsigned long long);
+}
+
+PassabilityMap PassabilityMapMake(void* mem, int width, int height) {
+	assert(((size_t) mem & 7) == 0);
+
+	PassabilityMap res;
+	res.width = width;
+	res.height = height;
+	res.rowStride = WordsCount(width);
+	res.columnStride = WordsCount(height);
+
+	size_t rowsSize = (size_t) res.rowStride * height * sizeof(unsigned long long);
+	size_t columnsSize = (size_t) res.columnStride * width * sizeof(unsigned long long);
+
+	// Bits are indexed by int
+	assert(rowsSize * 8 <= 0x7fffffff && columnsSize * 8 <= 0x7fffffff);
+
+	res.rows = BitArrayMake(static_cast<char*>(mem), (int) rowsSize);
+	res.columns = BitArrayMake(static_cast<char*>(mem) + rowsSize, (int) columnsSize);
+	return res;
+}
+
+void PassabilityMapBuild(PassabilityMap* map, const unsigned char* pMap) {
+	BitArrayClear(&map->rows);
+	BitArrayClear(&map->columns);
+
+	int node = 0;
+	for (int y = 0; y < map->height; ++y) {
+		for (int x = 0; x < map->width; ++x, ++node) {
+			if (pMap[node] == 0)
+				continue;
+
+			BitArraySet(&map->rows, (y * map->rowStride << 6) + x);
+			BitArraySet(&map->columns, (x * map->columnStride << 6) + y);
+		}
+	}
+}
+
+bool PassabilityMapIs(const PassabilityMap* map, int x, int y) {
+	if (x < 0 || x >= map->width || y < 0 || y >= map->height)
+		return false;
+
+	return (BitArrayWord64(&map->rows, y * map->rowStride + (x >> 6)) >> (x & 63)) & 1;
+}
+
+unsigned long long PassabilityMapRowBits(const PassabilityMap* map, int x, int y) {
+	if (y < 0 || y >= map->height)
+		return 0;
+
+	return ReadBits64(&map->rows, y * map->rowStride, map->rowStride, x);
+}
+
+unsigned long long PassabilityMapColumnBits(const PassabilityMap* map, int x, int y) {
+	if (x < 0 || x >= map->width)
+		return 0;
+
+	return ReadBits64(&map->columns, x * map->columnStride, map->columnStride, y);
+}
+
+int PassabilityMapNextBlockedInRow(const PassabilityMap* map, int x, int y) {
+	assert(y >= 0 && y < map->height);
+
+	// Bits after width are 0, scan always ends
+	for (; x < map->width; x += 64) {
+		unsigned long long blocked = ~PassabilityMapRowBits(map, x, y);
+		if (blocked) {
+			int res = x + CountTrailingZeros64(blocked);
+			return res < map->width ? res : map->width;
+		}
+	}
+	return map->width;
+}
+
+int PassabilityMapPrevBlockedInRow(const PassabilityMap* map, int x, int y) {
+	assert(y >= 0 && y < map->height);
+
+	if (x >= map->width)
+		return x;
+
+	// Bits before 0 are 0, scan always ends
+	for (; x >= 0; x -= 64) {
+		unsigned long long blocked = ~PassabilityMapRowBits(map, x - 63, y);
+		if (blocked) {
+			int res = x - CountLeadingZeros64(blocked);
+			return res >= 0 ? res : -1;
+		}
+	}
+	return -1;
+}
+
+int PassabilityMapNextBlockedInColumn(const PassabilityMap* map, int x, int y) {
+	assert(x >= 0 && x < map->width);
+
+	for (; y < map->height; y += 64) {
+		unsigned long long blocked = ~PassabilityMapColumnBits(map, x, y);
+		if (blocked) {
+			int res = y + CountTrailingZeros64(blocked);
+			return res < map->height ? res : map->height;
+		}
+	}
+	return map->height;
+}
+
+int PassabilityMapPrevBlockedInColumn(const PassabilityMap* map, int x, int y) {
+	assert(x >= 0 && x < map->width);
+
+	if (y >= map->height)
+		return y;
+
+	for (; y >= 0; y -= 64) {
+		unsigned long long blocked = ~PassabilityMapColumnBits(map, x, y - 63);
+		if (blocked) {
+			int res = y - CountLeadingZeros64(blocked);
+			return res >= 0 ? res : -1;
+		}
+	}
+	return -1;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "../Collection/BitArray.h"
+
+//  PassabilityMap
+//    Bit packed map, 1 bit per cell, set bit is passable cell
+//    Rows are stored twice, row major and transposed (column major) for vertical scans
+//    Every row (column) starts on 64 bit word, bits after width (height) are 0 (blocked)
+//    Scans read whole 64 bit words, they skip 64 cells per step
+//    Memory is given by caller (PassabilityMapMemorySize bytes, aligned to 8), map doesnt own it
+
+struct PassabilityMap {
+	int width;
+	int height;
+	int rowStride;    // in 64 bit words
+	int columnStride; // in 64 bit words
+	BitArray rows;
+	BitArray columns;
+};
+
+size_t PassabilityMapMemorySize(int width, int height);
+
+PassabilityMap PassabilityMapMake(void* mem, int width, int height);
+
+// Fills map from byte map (0 is blocked, anything else is passable)
+void PassabilityMapBuild(PassabilityMap* map, const unsigned char* pMap);
+
+bool PassabilityMapIs(const PassabilityMap* map, int x, int y);
+
+// 64 cells of row y starting at x (bit 0 is cell x), cells outside of map are 0
+// Works for any x and y, also outside of map
+unsigned long long PassabilityMapRowBits(const PassabilityMap* map, int x, int y);
+
+// 64 cells of column x starting at y (bit 0 is cell y), cells outside of map are 0
+unsigned long long PassabilityMapColumnBits(const PassabilityMap* map, int x, int y);
+
+// First blocked cell in row y at x or after it, width if there is none
+int PassabilityMapNextBlockedInRow(const PassabilityMap* map, int x, int y);
+
+// Last blocked cell in row y at x or before it, -1 if there is none
+int PassabilityMapPrevBlockedInRow(const PassabilityMap* map, int x, int y);
+
+// First blocked cell in column x at y or after it, height if there is none
+int PassabilityMapNextBlockedInColumn(const PassabilityMap* map, int x, int y);
+
+// Last blocked cell in column x at y or before it, -1 if there is none
+int PassabilityMapPrevBlockedInColumn(const PassabilityMap* map, int x, int y);
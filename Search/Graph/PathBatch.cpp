@@ -0,0 +1,102 @@
+#include "PathBatch.h"
+
+#include <atomic>
+#include <cassert>
+#include <new>
+
+#include "AStar.h"
+
+
+struct PathBatchJob {
+	PathBatchWorkers* workers;
+
+	const unsigned char* map;
+	int width;
+	int height;
+
+	PathQuery* queries;
+	int queriesCount;
+
+	std::atomic<int> nextQuery;
+};
+
+
+PathBatchWorkers::PathBatchWorkers() :
+	_workersCount(0),
+	_allocators(nullptr),
+	_workers(nullptr),
+	_allocator(nullptr) {
+}
+
+PathBatchWorkers::~PathBatchWorkers() {
+	if (!_workers)
+		return;
+
+	// Workers memory is returned to their allocators, before allocators are destructed
+	for (int i = 0; i < _workersCount; ++i) {
+		_workers[i].~Worker();
+		AllocatorDestruct(&_allocators[i]);
+	}
+
+	Deallocate(_allocator, _workers);
+	Deallocate(_allocator, _allocators);
+}
+
+void PathBatchWorkers::Init(IAllocator* allocator, int workersCount) {
+	assert(!_allocator);
+	assert(workersCount > 0);
+
+	_allocator = allocator;
+	_workersCount = workersCount;
+
+	_allocators = static_cast<HeapAllocator*>(Allocate(allocator, workersCount * sizeof(HeapAllocator), alignof(HeapAllocator)));
+	_workers = static_cast<Worker*>(Allocate(allocator, workersCount * sizeof(Worker), alignof(Worker)));
+
+	for (int i = 0; i < workersCount; ++i) {
+		IAllocator* workerAllocator = InitHeapAllocator(&_allocators[i]);
+
+		Worker* worker = new (&_workers[i]) Worker();
+		worker->context.Init(workerAllocator);
+		worker->openList.Init(workerAllocator);
+	}
+
+	_pool.Init(allocator, workersCount);
+}
+
+int PathBatchWorkers::WorkersCount() const {
+	return _workersCount;
+}
+
+void PathBatchWorkers::RunJob(void* data, int workerIndex) {
+	PathBatchJob* job = static_cast<PathBatchJob*>(data);
+	Worker* worker = &job->workers->_workers[workerIndex];
+
+	for (;;) {
+		int index = job->nextQuery.fetch_add(1, std::memory_order_relaxed);
+		if (index >= job->queriesCount)
+			break;
+
+		PathQuery* query = &job->queries[index];
+		query->pathCost = FindPath(&worker->context, &worker->openList, query->startX, query->startY, query->targetX, query->targetY,
+			job->map, job->width, job->height, query->outBuffer, query->outBufferSize);
+	}
+}
+
+
+void FindPathBatch(PathBatchWorkers* workers,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	PathQuery* queries, const int queriesCount) {
+
+	assert(workers && workers->_workers);
+
+	PathBatchJob job;
+	job.workers = workers;
+	job.map = pMap;
+	job.width = nMapWidth;
+	job.height = nMapHeight;
+	job.queries = queries;
+	job.queriesCount = queriesCount;
+	job.nextQuery.store(0, std::memory_order_relaxed);
+
+	workers->_pool.Run(PathBatchWorkers::RunJob, &job);
+}
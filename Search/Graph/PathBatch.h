@@ -0,0 +1,67 @@
+#pragma once
+
+#include "../Allocator/HeapAllocator.h"
+#include "../Collection/BucketQueue.h"
+#include "../Parallel/WorkerPool.h"
+
+#include "SearchContext.h"
+
+//  FindPathBatch
+//    Runs independent FindPath queries on worker threads, map is shared and read only
+//    Results are written into the queries (pathCost) and their out buffers, same format as FindPath
+//    Every worker has its own allocator, search context and open list, they are kept between batches
+//    After the first batch on given map size, searches dont allocate (except open list growth)
+//    Queries are taken one by one from atomic counter, workers with short queries take more of them
+
+struct PathQuery {
+	int startX;
+	int startY;
+	int targetX;
+	int targetY;
+
+	int* outBuffer;
+	int outBufferSize;
+
+	// Output, SearchContext::INFINITE_COST if target is unreachable
+	int pathCost;
+};
+
+class PathBatchWorkers {
+private:
+	// Own cache line, workers dont share written memory
+	struct alignas(64) Worker {
+		SearchContext context;
+		BucketQueue<int> openList;
+	};
+
+public:
+	PathBatchWorkers();
+	~PathBatchWorkers();
+
+	PathBatchWorkers(const PathBatchWorkers& oth) = delete;
+	PathBatchWorkers& operator=(const PathBatchWorkers& rhs) = delete;
+
+	void Init(IAllocator* allocator, int workersCount);
+
+	int WorkersCount() const;
+
+private:
+	friend void FindPathBatch(PathBatchWorkers* workers,
+		const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+		PathQuery* queries, const int queriesCount);
+
+	static void RunJob(void* data, int workerIndex);
+
+private:
+	int _workersCount;
+	HeapAllocator* _allocators;
+	Worker* _workers;
+
+	WorkerPool _pool;
+
+	IAllocator* _allocator;
+};
+
+void FindPathBatch(PathBatchWorkers* workers,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	PathQuery* queries, const int queriesCount);
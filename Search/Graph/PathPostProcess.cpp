@@ -0,0 +1,182 @@
+#include "PathPostProcess.h"
+
+#include <cassert>
+#include <cstdlib>
+
+
+// Node k of path in moving order (0 is start, pathLength is target)
+static inline int PathNode(const int* pPath, int pathLength, int start, int k) {
+	return k == 0 ? start : pPath[pathLength - k];
+}
+
+// Vertical first, map with width 1 has +1 as down move
+static inline int StepDirection(int from, int to, int width) {
+	int diff = to - from;
+	if (diff == -width)
+		return 0;
+	if (diff == width)
+		return 2;
+
+	assert(diff == 1 || diff == -1);
+	return diff == 1 ? 1 : 3;
+}
+
+static inline bool IsPassable(const unsigned char* pMap, int width, int height, int x, int y) {
+	return x >= 0 && x < width && y >= 0 && y < height && pMap[x + y * width];
+}
+
+
+int PathToSegments(const int* pPath, int pathLength, int start, int width, PathSegment* pOutSegments, int outSize) {
+	assert(pathLength == 0 || pPath);
+
+	int count = 0;
+	int lastDirection = -1;
+	int prev = start;
+	for (int k = 1; k <= pathLength; ++k) {
+		int node = PathNode(pPath, pathLength, start, k);
+		int direction = StepDirection(prev, node, width);
+
+		// New segment on first step and on every turn
+		if (direction != lastDirection) {
+			if (count < outSize) {
+				pOutSegments[count].direction = direction;
+				pOutSegments[count].length = 1;
+			}
+			++count;
+			lastDirection = direction;
+		}
+		else if (count <= outSize) {
+			pOutSegments[count - 1].length = pOutSegments[count - 1].length + 1;
+		}
+
+		prev = node;
+	}
+
+	return count;
+}
+
+int PathFromSegments(const PathSegment* pSegments, int segmentsCount, int start, int width, int* pOutPath, int outSize) {
+	const int offsets[4] = {-width, 1, width, -1};
+
+	int pathLength = 0;
+	for (int i = 0; i < segmentsCount; ++i)
+		pathLength += pSegments[i].length;
+
+	// Path is written from the end (target is first in FindPath order)
+	int node = start;
+	int k = 0;
+	for (int i = 0; i < segmentsCount; ++i) {
+		for (unsigned int j = 0; j < pSegments[i].length; ++j) {
+			node += offsets[pSegments[i].direction];
+			++k;
+
+			int index = pathLength - k;
+			if (index < outSize)
+				pOutPath[index] = node;
+		}
+	}
+
+	return pathLength;
+}
+
+int PathToWaypoints(const int* pPath, int pathLength, int start, int width, int* pOutWaypoints, int outSize) {
+	assert(pathLength == 0 || pPath);
+
+	int count = 0;
+	int prev = start;
+	for (int k = 1; k <= pathLength; ++k) {
+		int node = PathNode(pPath, pathLength, start, k);
+
+		bool last = k == pathLength;
+		if (last || StepDirection(prev, node, width) != StepDirection(node, PathNode(pPath, pathLength, start, k + 1), width)) {
+			if (count < outSize)
+				pOutWaypoints[count] = node;
+			++count;
+		}
+
+		prev = node;
+	}
+
+	return count;
+}
+
+int PathSmooth(const int* pPath, int pathLength, int start, const unsigned char* pMap, int width, int height,
+	int* pOutWaypoints, int outSize) {
+
+	assert(pathLength == 0 || pPath);
+	assert(pMap);
+
+	if (pathLength == 0)
+		return 0;
+
+	// Candidates are turning nodes and target, anchor sees previous candidate (straight run or tested sight)
+	int count = 0;
+	int anchor = start;
+	int candidate = start;
+	int prev = start;
+	for (int k = 1; k <= pathLength; ++k) {
+		int node = PathNode(pPath, pathLength, start, k);
+
+		bool last = k == pathLength;
+		if (last || StepDirection(prev, node, width) != StepDirection(node, PathNode(pPath, pathLength, start, k + 1), width)) {
+			if (candidate != anchor && !PathLineOfSight(pMap, width, height, anchor, node)) {
+				if (count < outSize)
+					pOutWaypoints[count] = candidate;
+				++count;
+				anchor = candidate;
+			}
+
+			candidate = node;
+		}
+
+		prev = node;
+	}
+
+	if (count < outSize)
+		pOutWaypoints[count] = candidate;
+	return count + 1;
+}
+
+bool PathLineOfSight(const unsigned char* pMap, int width, int height, int from, int to) {
+	assert(pMap);
+
+	int x = from % width, y = from / width;
+	int toX = to % width, toY = to / width;
+
+	int dx = abs(toX - x);
+	int dy = abs(toY - y);
+	int sx = toX > x ? 1 : -1;
+	int sy = toY > y ? 1 : -1;
+
+	// Supercover line, every cell the segment passes through is tested
+	// error is (horizontal - vertical) distance to next cell border, both scaled by 2 * dx * dy
+	int error = dx - dy;
+	dx *= 2;
+	dy *= 2;
+
+	for (int n = 1 + (dx + dy) / 2; n > 0; --n) {
+		if (!IsPassable(pMap, width, height, x, y))
+			return false;
+
+		if (error > 0) {
+			x += sx;
+			error -= dy;
+		}
+		else if (error < 0) {
+			y += sy;
+			error += dx;
+		}
+		else {
+			// Exactly through corner, both side cells have to be passable (agent cant squeeze between blocked cells)
+			if (n > 1 && (!IsPassable(pMap, width, height, x + sx, y) || !IsPassable(pMap, width, height, x, y + sy)))
+				return false;
+
+			x += sx;
+			y += sy;
+			error += dx - dy;
+			--n;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+//  PathPostProcess
+//    Compact outputs of path found by FindPath (or any search with the same output)
+//    Input is FindPath output: pPath has pathLength nodes from target (inclusive) to start (exclusive), start is given
+//    Outputs go from start (exclusive) to target (inclusive), the order agent moves in
+//
+//    Segments:  direction and run length of straight parts, 4 bytes per segment (raw path is 4 bytes per cell)
+//    Waypoints: nodes where path turns and target, moving straight between them is the same path
+//    Smooth:    any angle waypoints (string pulling), consecutive waypoints see each other over passable cells,
+//               path is not longer than raw path (euclidean), agent moves straight between waypoints
+//
+//    Functions return count of outputs, only first outSize are written (count > outSize means output is incomplete)
+//
+//    Other INTERNAL implementation details:
+//      Direction is 0 up, 1 right, 2 down, 3 left (same as neighbours in searches)
+//      Smoothing tests line of sight only from last waypoint to turning nodes -> O(turns * length of sight line)
+
+struct PathSegment {
+	unsigned int direction : 2;
+	unsigned int length : 30;
+};
+
+int PathToSegments(const int* pPath, int pathLength, int start, int width, PathSegment* pOutSegments, int outSize);
+
+// Inverse of PathToSegments, path is in FindPath output order (target first), returns path length
+int PathFromSegments(const PathSegment* pSegments, int segmentsCount, int start, int width, int* pOutPath, int outSize);
+
+int PathToWaypoints(const int* pPath, int pathLength, int start, int width, int* pOutWaypoints, int outSize);
+
+int PathSmooth(const int* pPath, int pathLength, int start, const unsigned char* pMap, int width, int height,
+	int* pOutWaypoints, int outSize);
+
+// Segment between centers of cells doesnt touch blocked cell (passing exactly through corner needs both side cells)
+bool PathLineOfSight(const unsigned char* pMap, int width, int height, int from, int to);
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cassert>
+
+#include "../Allocator/IAllocator.h"
+#include "../Collection/MinPriorityQueue.h"
+#include "../Utility/Memory.h"
+
+//  SearchContext
+//    Scratch memory for grid searches (node costs, from nodes, closed flags and open list)
+//    Reused between searches, memory is reallocated only when bigger map is searched
+//    Not thread safe, one context per thread
+//
+//    Other INTERNAL implementation details:
+//      Node states are stamped with generation (epoch), Begin only moves the generation -> new search is O(nodes touched)
+//      stamp == _openStamp        -> node was reached, cost and from node are valid
+//      stamp == _openStamp + 1    -> node was reached and closed
+//      other                      -> node was not touched by current search
+//      When generation overflows, all stamps are cleared (once per 2^31 searches)
+
+
+class SearchContext {
+public:
+	static const int INFINITE_COST = 0x7fffffff;
+
+private:
+	static const unsigned int FIRST_STAMP = 2;
+
+	struct NodeState {
+		unsigned int stamp;
+		int cost;
+		int fromNode;
+	};
+
+public:
+	SearchContext();
+	~SearchContext();
+
+	SearchContext(const SearchContext& oth) = delete;
+	SearchContext& operator=(const SearchContext& rhs) = delete;
+
+	void Init(IAllocator* allocator);
+
+	// Starts new search on graph with nodesCount nodes, invalidates all node states and clears open list
+	void Begin(int nodesCount);
+
+	bool IsReached(int node) const;
+	bool IsClosed(int node) const;
+
+	// INFINITE_COST if node was not reached
+	int Cost(int node) const;
+	int FromNode(int node) const;
+
+	void Reach(int node, int cost, int fromNode);
+	void Close(int node);
+
+	int NodesCount() const;
+
+	MinPriorityQueue<int>& OpenList();
+
+	// Count of node states reallocations since Init (for statistics)
+	unsigned int ReallocationsCount() const;
+
+private:
+	void Reallocate(int newCapacity);
+	void ClearStamps();
+
+private:
+	unsigned int _openStamp;
+
+	int _nodesCount;
+	int _capacity;
+	unsigned int _reallocationsCount;
+
+	NodeState* _nodes;
+
+	MinPriorityQueue<int> _openList;
+
+	IAllocator* _allocator;
+};
+
+
+
+
+
+
+
+
+inline SearchContext::SearchContext() :
+	_openStamp(FIRST_STAMP),
+	_nodesCount(0),
+	_capacity(0),
+	_reallocationsCount(0),
+	_nodes(nullptr),
+	_allocator(nullptr) {
+}
+
+inline SearchContext::~SearchContext() {
+	if (_nodes) {
+		Deallocate(_allocator, _nodes);
+	}
+}
+
+inline void SearchContext::Init(IAllocator* allocator) {
+	assert(!_allocator);
+	_allocator = allocator;
+	_openList.Init(allocator);
+}
+
+inline void SearchContext::Begin(int nodesCount) {
+	assert(nodesCount >= 0);
+
+	if (nodesCount > _capacity) {
+		Reallocate(nodesCount);
+	}
+	else if (_openStamp >= 0xFFffFFffu - 2) {
+		ClearStamps();
+	}
+	else {
+		_openStamp += 2;
+	}
+
+	_nodesCount = nodesCount;
+	_openList.Clear();
+}
+
+inline bool SearchContext::IsReached(int node) const {
+	assert(node >= 0 && node < _nodesCount);
+	return _nodes[node].stamp - _openStamp <= 1; // open or closed
+}
+
+inline bool SearchContext::IsClosed(int node) const {
+	assert(node >= 0 && node < _nodesCount);
+	return _nodes[node].stamp == _openStamp + 1;
+}
+
+inline int SearchContext::Cost(int node) const {
+	return IsReached(node) ? _nodes[node].cost : INFINITE_COST;
+}
+
+inline int SearchContext::FromNode(int node) const {
+	assert(IsReached(node));
+	return _nodes[node].fromNode;
+}
+
+inline void SearchContext::Reach(int node, int cost, int fromNode) {
+	assert(node >= 0 && node < _nodesCount);
+	NodeState& state = _nodes[node];
+	if (state.stamp != _openStamp + 1)
+		state.stamp = _openStamp;
+
+	state.cost = cost;
+	state.fromNode = fromNode;
+}
+
+inline void SearchContext::Close(int node) {
+	assert(IsReached(node));
+	_nodes[node].stamp = _openStamp + 1;
+}
+
+inline int SearchContext::NodesCount() const {
+	return _nodesCount;
+}
+
+inline MinPriorityQueue<int>& SearchContext::OpenList() {
+	return _openList;
+}
+
+inline unsigned int SearchContext::ReallocationsCount() const {
+	return _reallocationsCount;
+}
+
+inline void SearchContext::Reallocate(int newCapacity) {
+	assert(_allocator);
+
+	// States dont have to be copied, reallocation happens only in Begin
+	if (_nodes) {
+		Deallocate(_allocator, _nodes);
+	}
+
+	_nodes = static_cast<NodeState*>(Allocate(_allocator, newCapacity * sizeof(NodeState), alignof(NodeState)));
+	_capacity = newCapacity;
+	++_reallocationsCount;
+
+	ClearStamps();
+}
+
+inline void SearchContext::ClearStamps() {
+	for (int i = 0; i < _capacity; ++i) {
+		_nodes[i].stamp = 0;
+	}
+
+	_openStamp = FIRST_STAMP;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "../Utility/Timer.h"
+
+//  SearchStats
+//    Counters of one search, filled by searches when pointer to stats is given
+//    Counting is always on (few increments per node), no debug build is needed
+//
+//  SearchCounters
+//    Counters of running search, searches keep them and write them into SearchStats at the end (SearchCountersWrite)
+//    Reallocation counts of open lists and contexts are taken at begin, stats have reallocations done during search
+//    Search with more open lists or contexts passes sums of their counts (same ones at begin and at write)
+
+struct SearchStats {
+	int expandedCount;          // Nodes taken from open list and expanded
+	int pushedCount;            // Nodes added to open list
+	int peakOpenCount;          // Max count of nodes in open list
+	int openReallocationsCount; // Open list memory reallocations
+	int allocationsCount;       // Allocator calls (open list and context reallocations)
+	long long int cycles;       // Elapsed cycles (QueryCycles)
+};
+
+struct SearchCounters {
+	long long int startCycles;
+	unsigned int openReallocations;    // Open lists reallocations count at begin
+	unsigned int contextReallocations; // Contexts reallocations count at begin
+	int expandedCount;
+	int pushedCount;
+	unsigned int peakOpenCount;
+};
+
+// Starts cycle count, openCount is count of nodes already in open list (pushed and peak start with it)
+SearchCounters SearchCountersBegin(unsigned int openReallocations, unsigned int contextReallocations, int openCount);
+
+// Peak is updated with current count of nodes in open list
+void SearchCountersOpen(SearchCounters* counters, unsigned int openCount);
+
+// Writes counters into outStats, if given, reallocation counts are current counts of the same lists and contexts as at begin
+void SearchCountersWrite(const SearchCounters* counters, unsigned int openReallocations, unsigned int contextReallocations,
+	SearchStats* outStats);
+
+
+
+
+
+
+
+
+inline SearchCounters SearchCountersBegin(unsigned int openReallocations, unsigned int contextReallocations, int openCount) {
+	SearchCounters counters;
+	counters.startCycles = QueryCycles();
+	counters.openReallocations = openReallocations;
+	counters.contextReallocations = contextReallocations;
+	counters.expandedCount = 0;
+	counters.pushedCount = openCount;
+	counters.peakOpenCount = static_cast<unsigned int>(openCount);
+	return counters;
+}
+
+inline void SearchCountersOpen(SearchCounters* counters, unsigned int openCount) {
+	if (openCount > counters->peakOpenCount)
+		counters->peakOpenCount = openCount;
+}
+
+inline void SearchCountersWrite(const SearchCounters* counters, unsigned int openReallocations, unsigned int contextReallocations,
+	SearchStats* outStats) {
+
+	if (!outStats)
+		return;
+
+	outStats->expandedCount = counters->expandedCount;
+	outStats->pushedCount = counters->pushedCount;
+	outStats->peakOpenCount = static_cast<int>(counters->peakOpenCount);
+	outStats->openReallocationsCount = static_cast<int>(openReallocations - counters->openReallocations);
+	outStats->allocationsCount = outStats->openReallocationsCount + static_cast<int>(contextReallocations - counters->contextReallocations);
+	outStats->cycles = QueryCycles() - counters->startCycles;
+}
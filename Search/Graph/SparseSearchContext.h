@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cassert>
+
+#include "../Allocator/IAllocator.h"
+#include "../Collection/MinPriorityQueue.h"
+#include "../Collection/UIntMap.h"
+
+//  SparseSearchContext
+//    Scratch memory for grid searches with node states in hash map, only reached nodes have state
+//    Memory scales with nodes touched by search, not with map size (SearchContext has 12 bytes per map node)
+//    Made for huge maps where searches touch tiny part of map, dense SearchContext is faster otherwise
+//    Reused between searches, map memory is kept (Begin clears it)
+//    Not thread safe, one context per thread
+
+
+class SparseSearchContext {
+public:
+	struct NodeState {
+		int cost;
+		int fromNode;
+		bool closed;
+	};
+
+public:
+	SparseSearchContext();
+
+	SparseSearchContext(const SparseSearchContext& oth) = delete;
+	SparseSearchContext& operator=(const SparseSearchContext& rhs) = delete;
+
+	void Init(IAllocator* allocator);
+
+	// Starts new search, forgets all node states and clears open list
+	void Begin();
+
+	// nullptr if node was not reached
+	const NodeState* State(int node) const;
+
+	// State of node, new state (outReached false) has to be filled by caller
+	NodeState* Reach(int node, bool* outReached);
+
+	unsigned int ReachedCount() const;
+
+	MinPriorityQueue<int>& OpenList();
+
+	// Bytes of node states (for statistics)
+	size_t MemorySize() const;
+
+	// Count of node states reallocations since Init (for statistics)
+	unsigned int ReallocationsCount() const;
+
+private:
+	UIntMap<NodeState> _states;
+
+	MinPriorityQueue<int> _openList;
+};
+
+
+
+
+
+
+
+
+inline SparseSearchContext::SparseSearchContext() {
+}
+
+inline void SparseSearchContext::Init(IAllocator* allocator) {
+	_states.Init(allocator);
+	_openList.Init(allocator);
+}
+
+inline void SparseSearchContext::Begin() {
+	_states.Clear();
+	_openList.Clear();
+}
+
+inline const SparseSearchContext::NodeState* SparseSearchContext::State(int node) const {
+	assert(node >= 0);
+	return _states.Find(static_cast<unsigned int>(node));
+}
+
+inline SparseSearchContext::NodeState* SparseSearchContext::Reach(int node, bool* outReached) {
+	assert(node >= 0);
+	assert(outReached);
+
+	bool inserted;
+	NodeState* state = _states.Insert(static_cast<unsigned int>(node), &inserted);
+	*outReached = !inserted;
+	return state;
+}
+
+inline unsigned int SparseSearchContext::ReachedCount() const {
+	return _states.Count();
+}
+
+inline MinPriorityQueue<int>& SparseSearchContext::OpenList() {
+	return _openList;
+}
+
+inline size_t SparseSearchContext::MemorySize() const {
+	return _states.MemorySize();
+}
+
+inline unsigned int SparseSearchContext::ReallocationsCount() const {
+	return _states.ReallocationsCount();
+}
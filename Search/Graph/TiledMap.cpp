@@ -0,0 +1,34 @@
+#include "TiledMap.h"
+
+#include "../Utility/Memory.h"
+
+
+static int TilesCount(int cells) {
+	return (cells + TILED_MAP_TILE_SIZE - 1) >> TILED_MAP_TILE_SHIFT;
+}
+
+
+size_t TiledMapMemorySize(int width, int height) {
+	return (size_t) TilesCount(width) * TilesCount(height) * TILED_MAP_TILE_SIZE * TILED_MAP_TILE_SIZE;
+}
+
+TiledMap TiledMapMake(void* mem, int width, int height) {
+	TiledMap res;
+	res.width = width;
+	res.height = height;
+	res.tilesX = TilesCount(width);
+	res.tilesY = TilesCount(height);
+	res.cells = static_cast<unsigned char*>(mem);
+	return res;
+}
+
+void TiledMapBuild(TiledMap* map, const unsigned char* pMap) {
+	// Padding of edge tiles is blocked, rows of tile are runs of 8 cells
+	MemSet(map->cells, 0, TiledMapMemorySize(map->width, map->height));
+
+	for (int y = 0; y < map->height; ++y) {
+		const unsigned char* srcRow = pMap + y * map->width;
+		for (int x = 0; x < map->width; ++x)
+			map->cells[TiledMapIndex(map, x, y)] = srcRow[x] ? 1 : 0;
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+
+//  TiledMap
+//    Copy of byte map stored in 8x8 tiles, cells of tile are together (64 bytes), tiles are row major
+//    Search on tiled map indexes its context by tiled index -> node states of tile are together too
+//    Vertical neighbour is in the same tile 7 times of 8 (row major map and states touch other row, far in memory)
+//    Tiles on right and bottom edge are padded with blocked cells
+//    Memory is given by caller (TiledMapMemorySize bytes), map doesnt own it
+//
+//    Other INTERNAL implementation details:
+//      index = (tileY * tilesX + tileX) * 64 + (y % 8) * 8 + x % 8
+
+const int TILED_MAP_TILE_SHIFT = 3;
+const int TILED_MAP_TILE_SIZE = 1 << TILED_MAP_TILE_SHIFT;
+
+struct TiledMap {
+	int width;
+	int height;
+	int tilesX;
+	int tilesY;
+	unsigned char* cells;
+};
+
+size_t TiledMapMemorySize(int width, int height);
+
+TiledMap TiledMapMake(void* mem, int width, int height);
+
+// Copies byte map (0 is blocked, anything else is passable) into tiles
+void TiledMapBuild(TiledMap* map, const unsigned char* pMap);
+
+// Count of indices (padding included), searches on tiled map need context with this many nodes
+int TiledMapIndicesCount(const TiledMap* map);
+
+int TiledMapIndex(const TiledMap* map, int x, int y);
+
+// Caller's node (x + y * width) of index
+int TiledMapNode(const TiledMap* map, int index);
+
+
+
+
+
+
+
+
+inline int TiledMapIndicesCount(const TiledMap* map) {
+	return map->tilesX * map->tilesY * TILED_MAP_TILE_SIZE * TILED_MAP_TILE_SIZE;
+}
+
+inline int TiledMapIndex(const TiledMap* map, int x, int y) {
+	assert(x >= 0 && x < map->width && y >= 0 && y < map->height);
+
+	const int mask = TILED_MAP_TILE_SIZE - 1;
+	int tile = (y >> TILED_MAP_TILE_SHIFT) * map->tilesX + (x >> TILED_MAP_TILE_SHIFT);
+	return (tile << (2 * TILED_MAP_TILE_SHIFT)) | ((y & mask) << TILED_MAP_TILE_SHIFT) | (x & mask);
+}
+
+inline int TiledMapNode(const TiledMap* map, int index) {
+	const int mask = TILED_MAP_TILE_SIZE - 1;
+	int tile = index >> (2 * TILED_MAP_TILE_SHIFT);
+	int x = ((tile % map->tilesX) << TILED_MAP_TILE_SHIFT) | (index & mask);
+	int y = ((tile / map->tilesX) << TILED_MAP_TILE_SHIFT) | ((index >> TILED_MAP_TILE_SHIFT) & mask);
+	return x + y * map->width;
+}
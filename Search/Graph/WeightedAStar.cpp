@@ -0,0 +1,139 @@
+#include "WeightedAStar.h"
+
+#include <cassert>
+
+#include "GridNeighbours.h"
+#include "SearchContext.h"
+#include "SearchStats.h"
+
+#include "../Collection/IndexedPriorityQueue.h"
+
+#include "../Utility/Util.h"
+
+
+// Cheaper way to open node: indexed queue moves the node up, duplicate insert adds it once more
+static inline void OpenNode(IndexedPriorityQueue* queue, int node, unsigned int weight) {
+	queue->AddOrDecreaseKey(node, weight);
+}
+
+static inline void OpenNode(MinPriorityQueue<int>* queue, int node, unsigned int weight) {
+	queue->Add(node, weight);
+}
+
+static inline void BeginQueue(IndexedPriorityQueue* queue, int nodesCount) {
+	queue->Begin(nodesCount);
+}
+
+static inline void BeginQueue(MinPriorityQueue<int>* queue, int) {
+	queue->Clear();
+}
+
+template<typename OpenList>
+static int WeightedAStar(SearchContext* context, OpenList* openList, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, int* outPathLength, SearchStats* outStats) {
+
+	assert(context);
+	assert(openList);
+
+	SearchCounters counters = SearchCountersBegin(openList->ReallocationsCount(), context->ReallocationsCount(), 1);
+
+	int nodesCount = nMapWidth * nMapHeight;
+	int start = nStartX + nStartY * nMapWidth;
+	int target = nTargetX + nTargetY * nMapWidth;
+
+	context->Begin(nodesCount);
+
+	OpenList& queue = *openList;
+	BeginQueue(openList, nodesCount);
+	queue.Add(start, 0);
+
+	context->Reach(start, 0, start);
+
+	bool found = false;
+
+	while (!queue.Empty()) {
+		int node = queue.First();
+		queue.PopFirst();
+
+		// Stale duplicate of node expanded with cheaper cost (only with duplicate insert)
+		if (context->IsClosed(node))
+			continue;
+
+		if (node == target) {
+			found = true;
+			break;
+		}
+
+		++counters.expandedCount;
+
+		// Open list keeps nodes (position map is indexed by node), coordinates need division
+		int x = node % nMapWidth;
+		int y = node / nMapWidth;
+		int cost = context->Cost(node);
+
+		context->Close(node);
+
+		GridNeighbours neighbours;
+		unsigned int mask = GridExpand(x, y, node, nTargetX, nTargetY, pMap, nMapWidth, nMapHeight, &neighbours);
+
+		for (; mask; mask &= mask - 1) {
+			int i = CountTrailingZeros64(mask);
+			int nb = neighbours.nodes[i];
+
+			if (context->IsClosed(nb))
+				continue;
+
+			int nbCost = cost + pMap[nb];
+			if (nbCost >= context->Cost(nb))
+				continue;
+
+			OpenNode(openList, nb, (unsigned int) (nbCost + neighbours.heuristics[i]));
+			context->Reach(nb, nbCost, node);
+			++counters.pushedCount;
+		}
+
+		SearchCountersOpen(&counters, queue.Count());
+	}
+
+	int pathCost = found ? context->Cost(target) : SearchContext::INFINITE_COST;
+
+	int pathLength = 0;
+	if (found) {
+		for (int node = target; node != start; node = context->FromNode(node))
+			++pathLength;
+
+		if (pathLength <= nOutBufferSize) {
+			int i = 0;
+			for (int node = target; node != start; node = context->FromNode(node))
+				pOutBuffer[i++] = node;
+		}
+	}
+
+	if (outPathLength)
+		*outPathLength = pathLength;
+
+	SearchCountersWrite(&counters, openList->ReallocationsCount(), context->ReallocationsCount(), outStats);
+
+	return pathCost;
+}
+
+
+int FindPathWeighted(SearchContext* context, IndexedPriorityQueue* openList, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, int* outPathLength, SearchStats* outStats) {
+
+	return WeightedAStar(context, openList, nStartX, nStartY, nTargetX, nTargetY, pMap, nMapWidth, nMapHeight,
+		pOutBuffer, nOutBufferSize, outPathLength, outStats);
+}
+
+int FindPathWeighted(SearchContext* context, MinPriorityQueue<int>* openList, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, int* outPathLength, SearchStats* outStats) {
+
+	return WeightedAStar(context, openList, nStartX, nStartY, nTargetX, nTargetY, pMap, nMapWidth, nMapHeight,
+		pOutBuffer, nOutBufferSize, outPathLength, outStats);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "../Collection/MinPriorityQueue.h"
+
+class SearchContext;
+class IndexedPriorityQueue;
+struct SearchStats;
+
+//  FindPathWeighted
+//    A* on weighted 4way grid, map cell 0 is blocked, other values are cost of entering the cell (1 .. 255)
+//    Writes path from target (inclusive) to start (exclusive) into pOutBuffer, if it fits, its length into outPathLength
+//    Returns path cost, SearchContext::INFINITE_COST if target is unreachable
+//    Heuristic is Manhattan distance (cheapest cell costs 1) -> path cost is optimal
+//
+//    Version with IndexedPriorityQueue decreases weight of open node when cheaper way to it is found,
+//    open list has every open node once
+//    Version with MinPriorityQueue adds node again with smaller weight (duplicate insert), older entries stay
+//    in open list and are skipped when popped (node is already closed)
+//    Both versions return the same cost, paths can differ in ties
+//    Counters of the search are written into outStats, if given
+
+int FindPathWeighted(SearchContext* context, IndexedPriorityQueue* openList, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, int* outPathLength, SearchStats* outStats = nullptr);
+
+int FindPathWeighted(SearchContext* context, MinPriorityQueue<int>* openList, const int nStartX, const int nStartY,
+	const int nTargetX, const int nTargetY,
+	const unsigned char* pMap, const int nMapWidth, const int nMapHeight,
+	int* pOutBuffer, const int nOutBufferSize, int* outPathLength, SearchStats* outStats = nullptr);
@@ -0,0 +1,262 @@
+#include "MapFile.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+#include "../Config.h"
+#include "../Allocator/IAllocator.h"
+#include "../Utility/Memory.h"
+
+#if WINDOWS
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(MapFileHeader) == 64, "MapFileHeader is part of file format");
+
+static const char MAGIC[4] = {'G', 'R', 'I', 'D'};
+static const unsigned long long DATA_OFFSET = sizeof(MapFileHeader);
+
+
+static unsigned long long DataSize(MapFileEncoding encoding, int width, int height) {
+	if (encoding == MapFileEncoding::Bits)
+		return PassabilityMapMemorySize(width, height);
+	return (unsigned long long) width * height;
+}
+
+static unsigned int Stride(MapFileEncoding encoding, int width) {
+	if (encoding == MapFileEncoding::Bits)
+		return (unsigned int) ((((unsigned long long) width + 63) >> 6) * 8);
+	return width;
+}
+
+static bool IsValidHeader(const MapFileHeader* header, size_t fileSize) {
+	if (fileSize < sizeof(MapFileHeader) || memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0)
+		return false;
+
+	if (header->version != MAP_FILE_VERSION)
+		return false;
+
+	if (header->encoding != MapFileEncoding::Bytes && header->encoding != MapFileEncoding::Bits)
+		return false;
+
+	// Searches index nodes by int
+	if (header->width == 0 || header->height == 0 ||
+		(unsigned long long) header->width * header->height > 0x7fffffffull)
+		return false;
+
+	int width = (int) header->width;
+	int height = (int) header->height;
+
+	// Bits of rows and columns are indexed by int too (rows are padded to 64 bits)
+	if (header->encoding == MapFileEncoding::Bits &&
+		((((unsigned long long) width + 63) >> 6) * height * 64 > 0x7fffffffull ||
+		(((unsigned long long) height + 63) >> 6) * width * 64 > 0x7fffffffull))
+		return false;
+
+	if (header->stride != Stride(header->encoding, width) || header->dataSize != DataSize(header->encoding, width, height))
+		return false;
+
+	return (header->dataOffset & 7) == 0 && header->dataOffset >= sizeof(MapFileHeader) &&
+		header->dataOffset <= fileSize && header->dataSize <= fileSize - header->dataOffset;
+}
+
+static FILE* OpenFile(const char* path, const char* mode) {
+	FILE* file = nullptr;
+#if MSVC
+	if (fopen_s(&file, path, mode) != 0)
+		file = nullptr;
+#else
+	file = fopen(path, mode);
+#endif
+	return file;
+}
+
+
+bool MapFileWrite(IAllocator* allocator, const char* path, const unsigned char* pMap, int width, int height, MapFileEncoding encoding) {
+	assert(pMap);
+	assert(width > 0 && height > 0);
+
+	MapFileHeader header;
+	MemSet(&header, 0, sizeof(header));
+	memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = MAP_FILE_VERSION;
+	header.encoding = encoding;
+	header.width = width;
+	header.height = height;
+	header.stride = Stride(encoding, width);
+	header.dataOffset = DATA_OFFSET;
+	header.dataSize = DataSize(encoding, width, height);
+
+	FILE* file = OpenFile(path, "wb");
+	if (!file)
+		return false;
+
+	bool res = fwrite(&header, sizeof(header), 1, file) == 1;
+
+	if (encoding == MapFileEncoding::Bits) {
+		void* bitsMem = Allocate(allocator, (size_t) header.dataSize, 8);
+		PassabilityMap bits = PassabilityMapMake(bitsMem, width, height);
+		PassabilityMapBuild(&bits, pMap);
+
+		res = res && fwrite(bitsMem, 1, (size_t) header.dataSize, file) == header.dataSize;
+
+		Deallocate(allocator, bitsMem);
+	}
+	else {
+		// Cells are normalized to 0 and 1 row by row (no copy of whole map)
+		unsigned char row[4096];
+		for (int y = 0; res && y < height; ++y) {
+			const unsigned char* srcRow = pMap + (size_t) y * width;
+			for (int x = 0; res && x < width; x += (int) sizeof(row)) {
+				int count = width - x < (int) sizeof(row) ? width - x : (int) sizeof(row);
+				for (int i = 0; i < count; ++i)
+					row[i] = srcRow[x + i] ? 1 : 0;
+
+				res = fwrite(row, 1, count, file) == (size_t) count;
+			}
+		}
+	}
+
+	if (fclose(file) != 0)
+		res = false;
+
+	return res;
+}
+
+bool MapFileConvertRaw(IAllocator* allocator, const char* rawPath, int width, int height, const char* path, MapFileEncoding encoding) {
+	if (width <= 0 || height <= 0)
+		return false;
+
+	FILE* file = OpenFile(rawPath, "rb");
+	if (!file)
+		return false;
+
+	size_t size = (size_t) width * height;
+	unsigned char* map = static_cast<unsigned char*>(Allocate(allocator, size, alignof(unsigned char)));
+
+	// Raw file has to have exactly width * height bytes
+	bool res = fread(map, 1, size, file) == size && fgetc(file) == EOF;
+	fclose(file);
+
+	res = res && MapFileWrite(allocator, path, map, width, height, encoding);
+
+	Deallocate(allocator, map);
+	return res;
+}
+
+#if WINDOWS
+
+bool MapFileOpen(const char* path, MapFile* outFile) {
+	assert(outFile);
+
+	HANDLE fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || (unsigned long long) fileSize.QuadPart < sizeof(MapFileHeader)) {
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mappingHandle) {
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	void* view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	const MapFileHeader* header = static_cast<const MapFileHeader*>(view);
+	if (!view || !IsValidHeader(header, (size_t) fileSize.QuadPart)) {
+		if (view)
+			UnmapViewOfFile(view);
+		CloseHandle(mappingHandle);
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	outFile->width = (int) header->width;
+	outFile->height = (int) header->height;
+	outFile->encoding = header->encoding;
+	outFile->cells = static_cast<const unsigned char*>(view) + header->dataOffset;
+	outFile->view = view;
+	outFile->viewSize = (size_t) fileSize.QuadPart;
+	outFile->fileHandle = fileHandle;
+	outFile->mappingHandle = mappingHandle;
+	return true;
+}
+
+void MapFileClose(MapFile* file) {
+	assert(file && file->view);
+
+	UnmapViewOfFile(file->view);
+	CloseHandle(file->mappingHandle);
+	CloseHandle(file->fileHandle);
+	file->view = nullptr;
+	file->cells = nullptr;
+}
+
+#else
+
+bool MapFileOpen(const char* path, MapFile* outFile) {
+	assert(outFile);
+
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(MapFileHeader)) {
+		close(fd);
+		return false;
+	}
+
+	// Mapping keeps the file, descriptor isnt needed after mmap
+	size_t fileSize = (size_t) info.st_size;
+	void* view = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (view == MAP_FAILED)
+		return false;
+
+	const MapFileHeader* header = static_cast<const MapFileHeader*>(view);
+	if (!IsValidHeader(header, fileSize)) {
+		munmap(view, fileSize);
+		return false;
+	}
+
+	outFile->width = (int) header->width;
+	outFile->height = (int) header->height;
+	outFile->encoding = header->encoding;
+	outFile->cells = static_cast<const unsigned char*>(view) + header->dataOffset;
+	outFile->view = view;
+	outFile->viewSize = fileSize;
+	return true;
+}
+
+void MapFileClose(MapFile* file) {
+	assert(file && file->view);
+
+	munmap(file->view, file->viewSize);
+	file->view = nullptr;
+	file->cells = nullptr;
+}
+
+#endif
+
+const unsigned char* MapFileBytes(const MapFile* file) {
+	assert(file->encoding == MapFileEncoding::Bytes);
+	return file->cells;
+}
+
+PassabilityMap MapFilePassabilityMap(const MapFile* file) {
+	assert(file->encoding == MapFileEncoding::Bits);
+	// Searches only read the map, memory of mapping is read only
+	return PassabilityMapMake(const_cast<unsigned char*>(file->cells), file->width, file->height);
+}
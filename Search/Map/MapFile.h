@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+
+#include "../Config.h"
+#include "../Graph/PassabilityMap.h"
+
+struct IAllocator;
+
+//  MapFile
+//    Versioned binary map file, mapped read only into memory (mmap, MapViewOfFile), cells are used in place (no copy)
+//    One opened file can be shared by all search threads, pages of the same file are shared by processes too
+//    Cells are loaded by OS on first touch -> opening of multi gigabyte map is O(1), untouched parts are never read
+//
+//    Encoding Bytes: width * height bytes row major (0 blocked, 1 passable), cells are pMap for FindPath
+//    Encoding Bits:  PassabilityMap memory (rows and transposed columns, 1 bit per cell), map for FindPathJPS
+//
+//    MapFileWrite is the converter from byte array (map of FindPath), MapFileConvertRaw the same for raw file
+//    MapFileOpen returns false for missing file, unknown version, bad header or short file, nothing is mapped then
+//    Maps with more nodes than int can index (or bits of rows / columns over int for Bits) are refused as bad header
+//
+//    Other INTERNAL implementation details:
+//      File is MapFileHeader (64 bytes) followed by cells at dataOffset (8 aligned, PassabilityMap needs it)
+//      Values are little endian (same as every supported platform, they are read in place)
+//      stride is bytes of row (width for bytes, 8 * PassabilityMap rowStride for bits)
+
+const unsigned int MAP_FILE_VERSION = 1;
+
+enum class MapFileEncoding : unsigned int {
+	Bytes = 0,
+	Bits = 1
+};
+
+struct MapFileHeader {
+	char magic[4]; // "GRID"
+	unsigned int version;
+	MapFileEncoding encoding;
+	unsigned int width;
+	unsigned int height;
+	unsigned int stride;
+	unsigned long long dataOffset;
+	unsigned long long dataSize;
+	unsigned char reserved[24];
+};
+
+struct MapFile {
+	int width;
+	int height;
+	MapFileEncoding encoding;
+	const unsigned char* cells; // mapped data (read only)
+
+	void* view;
+	size_t viewSize;
+#if WINDOWS
+	void* fileHandle;
+	void* mappingHandle;
+#endif
+};
+
+// Writes byte map (0 is blocked, anything else is passable) into file in given encoding
+// Bits are built in temporary memory of allocator
+bool MapFileWrite(IAllocator* allocator, const char* path, const unsigned char* pMap, int width, int height, MapFileEncoding encoding);
+
+// Converts raw file (width * height bytes, FindPath map) into map file
+bool MapFileConvertRaw(IAllocator* allocator, const char* rawPath, int width, int height, const char* path, MapFileEncoding encoding);
+
+bool MapFileOpen(const char* path, MapFile* outFile);
+
+void MapFileClose(MapFile* file);
+
+// Bytes encoding, map for FindPath (width and height of file)
+const unsigned char* MapFileBytes(const MapFile* file);
+
+// Bits encoding, map for searches on PassabilityMap, it points into the file and must not be built
+PassabilityMap MapFilePassabilityMap(const MapFile* file);
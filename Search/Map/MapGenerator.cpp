@@ -0,0 +1,198 @@
+#include "MapGenerator.h"
+
+#include <cassert>
+
+#include "../Allocator/IAllocator.h"
+#include "../Utility/Memory.h"
+
+
+// Xorshift, state is never 0
+static unsigned int NextRandom(unsigned int* state) {
+	unsigned int x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+static unsigned int SeedRandom(unsigned int seed) {
+	unsigned int state = seed * 2654435761u ^ 0x9E3779B9u;
+	return state ? state : 1;
+}
+
+static int RandomRange(unsigned int* state, int count) {
+	assert(count > 0);
+	return (int) (NextRandom(state) % (unsigned int) count);
+}
+
+// Random spanning tree of cellsX x cellsY grid (depth first with backtracking)
+// connect(cell, neighbour) is called for every tree edge
+template<typename Connect>
+static void RandomSpanningTree(IAllocator* allocator, int cellsX, int cellsY, unsigned int* random, Connect connect) {
+	int cellsCount = cellsX * cellsY;
+	if (cellsCount == 0)
+		return;
+
+	int* stack = static_cast<int*>(Allocate(allocator, cellsCount * sizeof(int), alignof(int)));
+	unsigned char* visited = static_cast<unsigned char*>(Allocate(allocator, cellsCount, alignof(unsigned char)));
+	MemSet(visited, 0, cellsCount);
+
+	int stackCount = 0;
+	int first = RandomRange(random, cellsCount);
+	stack[stackCount++] = first;
+	visited[first] = 1;
+
+	while (stackCount > 0) {
+		int cell = stack[stackCount - 1];
+		int x = cell % cellsX;
+		int y = cell / cellsX;
+
+		int neighbours[4];
+		int count = 0;
+		if (x > 0 && !visited[cell - 1])
+			neighbours[count++] = cell - 1;
+		if (x < cellsX - 1 && !visited[cell + 1])
+			neighbours[count++] = cell + 1;
+		if (y > 0 && !visited[cell - cellsX])
+			neighbours[count++] = cell - cellsX;
+		if (y < cellsY - 1 && !visited[cell + cellsX])
+			neighbours[count++] = cell + cellsX;
+
+		if (count == 0) {
+			--stackCount;
+			continue;
+		}
+
+		int nb = neighbours[RandomRange(random, count)];
+		visited[nb] = 1;
+		connect(cell, nb);
+		stack[stackCount++] = nb;
+	}
+
+	Deallocate(allocator, visited);
+	Deallocate(allocator, stack);
+}
+
+static void FillRect(unsigned char* map, int width, int x0, int y0, int x1, int y1, unsigned char value) {
+	for (int y = y0; y <= y1; ++y) {
+		for (int x = x0; x <= x1; ++x)
+			map[x + y * width] = value;
+	}
+}
+
+
+void GenerateRandomMap(unsigned char* map, int width, int height, int density, unsigned int seed) {
+	assert(map);
+	assert(density >= 0 && density <= 100);
+
+	unsigned int random = SeedRandom(seed);
+	for (int i = 0; i < width * height; ++i)
+		map[i] = RandomRange(&random, 100) < density ? 0 : 1;
+}
+
+void GenerateOpenMap(unsigned char* map, int width, int height, unsigned int seed) {
+	assert(map);
+
+	const int MAX_OBSTACLE_SIZE = 4;
+
+	MemSet(map, 1, width * height);
+
+	// Obstacles cover ~2.5% of map
+	unsigned int random = SeedRandom(seed);
+	int obstaclesCount = width * height / 256;
+	for (int i = 0; i < obstaclesCount; ++i) {
+		int x0 = RandomRange(&random, width);
+		int y0 = RandomRange(&random, height);
+		int x1 = x0 + RandomRange(&random, MAX_OBSTACLE_SIZE);
+		int y1 = y0 + RandomRange(&random, MAX_OBSTACLE_SIZE);
+
+		FillRect(map, width, x0, y0, x1 < width ? x1 : width - 1, y1 < height ? y1 : height - 1, 0);
+	}
+}
+
+void GenerateMazeMap(IAllocator* allocator, unsigned char* map, int width, int height, unsigned int seed) {
+	assert(allocator);
+	assert(map);
+
+	// Maze cells are on even coordinates, odd coordinates are walls or passages between cells
+	int cellsX = (width + 1) / 2;
+	int cellsY = (height + 1) / 2;
+
+	MemSet(map, 0, width * height);
+	for (int y = 0; y < height; y += 2) {
+		for (int x = 0; x < width; x += 2)
+			map[x + y * width] = 1;
+	}
+
+	unsigned int random = SeedRandom(seed);
+	RandomSpanningTree(allocator, cellsX, cellsY, &random, [=](int cell, int nb) {
+		int x = (cell % cellsX) + (nb % cellsX);
+		int y = (cell / cellsX) + (nb / cellsX);
+		map[x + y * width] = 1;
+	});
+}
+
+void GenerateRoomsMap(IAllocator* allocator, unsigned char* map, int width, int height, int roomSize, unsigned int seed) {
+	assert(allocator);
+	assert(map);
+	assert(roomSize >= 4);
+
+	const int EXTRA_CORRIDOR_CHANCE = 8; // 1 of 8 not connected neighbours get corridor (loops)
+
+	int cellsX = width / roomSize;
+	int cellsY = height / roomSize;
+
+	MemSet(map, 0, width * height);
+
+	// Room of random size inside of every cell, at least 1 cell of wall around it
+	unsigned int random = SeedRandom(seed);
+	for (int cy = 0; cy < cellsY; ++cy) {
+		for (int cx = 0; cx < cellsX; ++cx) {
+			int roomWidth = roomSize / 2 + RandomRange(&random, roomSize / 2 - 1);
+			int roomHeight = roomSize / 2 + RandomRange(&random, roomSize / 2 - 1);
+			int x0 = cx * roomSize + 1 + RandomRange(&random, roomSize - roomWidth - 1);
+			int y0 = cy * roomSize + 1 + RandomRange(&random, roomSize - roomHeight - 1);
+
+			FillRect(map, width, x0, y0, x0 + roomWidth - 1, y0 + roomHeight - 1, 1);
+		}
+	}
+
+	// L shaped corridor between centers of cells, centers are always inside of rooms
+	auto connect = [=](int cell, int nb) {
+		int ax = (cell % cellsX) * roomSize + roomSize / 2;
+		int ay = (cell / cellsX) * roomSize + roomSize / 2;
+		int bx = (nb % cellsX) * roomSize + roomSize / 2;
+		int by = (nb / cellsX) * roomSize + roomSize / 2;
+
+		FillRect(map, width, ax < bx ? ax : bx, ay, ax < bx ? bx : ax, ay, 1);
+		FillRect(map, width, bx, ay < by ? ay : by, bx, ay < by ? by : ay, 1);
+	};
+
+	RandomSpanningTree(allocator, cellsX, cellsY, &random, connect);
+
+	for (int cy = 0; cy < cellsY; ++cy) {
+		for (int cx = 0; cx < cellsX; ++cx) {
+			int cell = cx + cy * cellsX;
+			if (cx < cellsX - 1 && RandomRange(&random, EXTRA_CORRIDOR_CHANCE) == 0)
+				connect(cell, cell + 1);
+			if (cy < cellsY - 1 && RandomRange(&random, EXTRA_CORRIDOR_CHANCE) == 0)
+				connect(cell, cell + cellsX);
+		}
+	}
+}
+
+int RandomPassableCell(const unsigned char* map, int width, int height, unsigned int* random) {
+	assert(map);
+	assert(random);
+
+	if (*random == 0)
+		*random = SeedRandom(0);
+
+	int cell;
+	do {
+		cell = RandomRange(random, width * height);
+	} while (map[cell] == 0);
+
+	return cell;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+struct IAllocator;
+
+//  MapGenerator
+//    Seeded generators of byte maps (0 is blocked, 1 is passable) for benchmarks and tests
+//    Same seed gives the same map on every platform (own random generator, not rand)
+//    Map memory (width * height bytes) is given by caller, allocator is used only for temporary memory
+//
+//    Random  - random blocked cells, density in percent
+//    Open    - open field with few small obstacles
+//    Maze    - perfect maze with 1 cell corridors and walls (only one path between two cells)
+//    Rooms   - rooms in grid of roomSize cells connected by 1 cell corridors, some corridors make loops
+
+void GenerateRandomMap(unsigned char* map, int width, int height, int density, unsigned int seed);
+
+void GenerateOpenMap(unsigned char* map, int width, int height, unsigned int seed);
+
+void GenerateMazeMap(IAllocator* allocator, unsigned char* map, int width, int height, unsigned int seed);
+
+void GenerateRoomsMap(IAllocator* allocator, unsigned char* map, int width, int height, int roomSize, unsigned int seed);
+
+// Random passable cell (x + y * width), map has to have at least one passable cell
+// random is state of generator (start with any seed), it is updated by every call
+int RandomPassableCell(const unsigned char* map, int width, int height, unsigned int* random);
@@ -0,0 +1,243 @@
+#include "MovingAI.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "../Config.h"
+#include "../Allocator/IAllocator.h"
+
+
+static bool IsSpace(char c) {
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static const char* SkipSpaces(const char* text) {
+	while (IsSpace(*text))
+		++text;
+	return text;
+}
+
+// Compares word at text with given word, returns position after it or nullptr
+static const char* ReadWord(const char* text, const char* word) {
+	text = SkipSpaces(text);
+	size_t length = strlen(word);
+	if (strncmp(text, word, length) != 0 || (text[length] && !IsSpace(text[length])))
+		return nullptr;
+	return text + length;
+}
+
+static const char* SkipWord(const char* text) {
+	text = SkipSpaces(text);
+	if (!*text)
+		return nullptr;
+
+	while (*text && !IsSpace(*text))
+		++text;
+	return text;
+}
+
+static const char* ReadInt(const char* text, int* outValue) {
+	char* end;
+	long value = strtol(text, &end, 10);
+	if (end == text)
+		return nullptr;
+
+	*outValue = (int) value;
+	return end;
+}
+
+static bool IsPassableTerrain(char c) {
+	return c == '.' || c == 'G' || c == 'S';
+}
+
+// Whole file with null terminator, nullptr if file cant be read
+static char* ReadFile(IAllocator* allocator, const char* path) {
+	FILE* file = nullptr;
+#if MSVC
+	if (fopen_s(&file, path, "rb") != 0)
+		file = nullptr;
+#else
+	file = fopen(path, "rb");
+#endif
+	if (!file)
+		return nullptr;
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	char* text = nullptr;
+	if (size >= 0) {
+		text = static_cast<char*>(Allocate(allocator, size + 1, alignof(char)));
+		if (fread(text, 1, size, file) == (size_t) size) {
+			text[size] = 0;
+		}
+		else {
+			Deallocate(allocator, text);
+			text = nullptr;
+		}
+	}
+
+	fclose(file);
+	return text;
+}
+
+
+bool MovingAIParseMap(IAllocator* allocator, const char* text, MovingAIMap* outMap) {
+	assert(allocator);
+	assert(text);
+	assert(outMap);
+
+	int width = -1;
+	int height = -1;
+
+	// Header lines in any order until "map"
+	for (;;) {
+		const char* next;
+		if ((next = ReadWord(text, "type"))) {
+			text = SkipWord(next);
+		}
+		else if ((next = ReadWord(text, "height"))) {
+			text = ReadInt(next, &height);
+		}
+		else if ((next = ReadWord(text, "width"))) {
+			text = ReadInt(next, &width);
+		}
+		else if ((next = ReadWord(text, "map"))) {
+			text = next;
+			break;
+		}
+		else {
+			return false;
+		}
+
+		if (!text)
+			return false;
+	}
+
+	if (width <= 0 || height <= 0)
+		return false;
+
+	unsigned char* map = static_cast<unsigned char*>(Allocate(allocator, width * height, alignof(unsigned char)));
+
+	for (int y = 0; y < height; ++y) {
+		text = SkipSpaces(text);
+		for (int x = 0; x < width; ++x, ++text) {
+			if (!*text || IsSpace(*text)) {
+				Deallocate(allocator, map);
+				return false;
+			}
+
+			map[x + y * width] = IsPassableTerrain(*text) ? 1 : 0;
+		}
+	}
+
+	outMap->map = map;
+	outMap->width = width;
+	outMap->height = height;
+	return true;
+}
+
+bool MovingAIParseScenario(IAllocator* allocator, const char* text, MovingAIScenario* outScenario) {
+	assert(allocator);
+	assert(text);
+	assert(outScenario);
+
+	// Version number is not checked, all versions have the same columns
+	text = ReadWord(text, "version");
+	if (!text)
+		return false;
+
+	text = SkipWord(text);
+	if (!text)
+		return false;
+
+	// Every query is on its own line, lines are upper bound of queries count
+	int linesCount = 0;
+	for (const char* c = text; *c; ++c) {
+		if (*c == '\n')
+			++linesCount;
+	}
+	++linesCount;
+
+	MovingAIQuery* queries = static_cast<MovingAIQuery*>(Allocate(allocator, linesCount * sizeof(MovingAIQuery), alignof(MovingAIQuery)));
+	int queriesCount = 0;
+
+	// bucket map mapWidth mapHeight startX startY targetX targetY optimalLength
+	for (;;) {
+		text = SkipSpaces(text);
+		if (!*text)
+			break;
+
+		MovingAIQuery query;
+		int bucket, mapWidth, mapHeight;
+		char* end;
+
+		bool ok = (text = ReadInt(text, &bucket)) &&
+			(text = SkipWord(text)) &&
+			(text = ReadInt(text, &mapWidth)) &&
+			(text = ReadInt(text, &mapHeight)) &&
+			(text = ReadInt(text, &query.startX)) &&
+			(text = ReadInt(text, &query.startY)) &&
+			(text = ReadInt(text, &query.targetX)) &&
+			(text = ReadInt(text, &query.targetY));
+
+		if (ok) {
+			query.optimalLength = strtod(text, &end);
+			ok = end != text;
+			text = end;
+		}
+
+		if (!ok || queriesCount == linesCount) {
+			Deallocate(allocator, queries);
+			return false;
+		}
+
+		queries[queriesCount++] = query;
+	}
+
+	outScenario->queries = queries;
+	outScenario->queriesCount = queriesCount;
+	return true;
+}
+
+bool MovingAILoadMap(IAllocator* allocator, const char* path, MovingAIMap* outMap) {
+	char* text = ReadFile(allocator, path);
+	if (!text)
+		return false;
+
+	bool res = MovingAIParseMap(allocator, text, outMap);
+	Deallocate(allocator, text);
+	return res;
+}
+
+bool MovingAILoadScenario(IAllocator* allocator, const char* path, MovingAIScenario* outScenario) {
+	char* text = ReadFile(allocator, path);
+	if (!text)
+		return false;
+
+	bool res = MovingAIParseScenario(allocator, text, outScenario);
+	Deallocate(allocator, text);
+	return res;
+}
+
+void MovingAIFreeMap(IAllocator* allocator, MovingAIMap* map) {
+	assert(map);
+	if (map->map)
+		Deallocate(allocator, map->map);
+
+	map->map = nullptr;
+	map->width = 0;
+	map->height = 0;
+}
+
+void MovingAIFreeScenario(IAllocator* allocator, MovingAIScenario* scenario) {
+	assert(scenario);
+	if (scenario->queries)
+		Deallocate(allocator, scenario->queries);
+
+	scenario->queries = nullptr;
+	scenario->queriesCount = 0;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+
+struct IAllocator;
+
+//  MovingAI
+//    Loader of MovingAI benchmark maps (.map) and scenarios (.scen), format from movingai.com/benchmarks/formats.html
+//    Map cells '.', 'G' and 'S' are passable (1), others ('@', 'O', 'T', 'W') are blocked (0)
+//    Optimal lengths in scenarios are octile (8 connected), searches in this project are 4 connected
+//
+//    Parse functions read null terminated text, Load functions read whole file and parse it
+//    Return false for missing file or bad format, nothing is allocated then
+//    Memory of results is allocated by given allocator, freed by MovingAIFree functions
+
+struct MovingAIMap {
+	unsigned char* map;
+	int width;
+	int height;
+};
+
+struct MovingAIQuery {
+	int startX;
+	int startY;
+	int targetX;
+	int targetY;
+	double optimalLength;
+};
+
+struct MovingAIScenario {
+	MovingAIQuery* queries;
+	int queriesCount;
+};
+
+bool MovingAIParseMap(IAllocator* allocator, const char* text, MovingAIMap* outMap);
+
+bool MovingAIParseScenario(IAllocator* allocator, const char* text, MovingAIScenario* outScenario);
+
+bool MovingAILoadMap(IAllocator* allocator, const char* path, MovingAIMap* outMap);
+
+bool MovingAILoadScenario(IAllocator* allocator, const char* path, MovingAIScenario* outScenario);
+
+void MovingAIFreeMap(IAllocator* allocator, MovingAIMap* map);
+
+void MovingAIFreeScenario(IAllocator* allocator, MovingAIScenario* scenario);
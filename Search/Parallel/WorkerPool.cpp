@@ -0,0 +1,100 @@
+#include "WorkerPool.h"
+
+#include <cassert>
+#include <new>
+
+#include "../Allocator/IAllocator.h"
+
+
+WorkerPool::WorkerPool() :
+	_workersCount(0),
+	_threads(nullptr),
+	_generation(0),
+	_runningCount(0),
+	_quit(false),
+	_job(nullptr),
+	_data(nullptr),
+	_allocator(nullptr) {
+}
+
+WorkerPool::~WorkerPool() {
+	if (!_threads)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_wakeCondition.notify_all();
+
+	for (int i = 0; i < _workersCount; ++i) {
+		_threads[i].join();
+		_threads[i].~thread();
+	}
+
+	Deallocate(_allocator, _threads);
+}
+
+void WorkerPool::Init(IAllocator* allocator, int workersCount) {
+	assert(!_allocator);
+	assert(workersCount > 0);
+
+	_allocator = allocator;
+	_workersCount = workersCount;
+
+	_threads = static_cast<std::thread*>(Allocate(_allocator, workersCount * sizeof(std::thread), alignof(std::thread)));
+	for (int i = 0; i < workersCount; ++i)
+		new (&_threads[i]) std::thread(WorkerLoop, this, i);
+}
+
+void WorkerPool::Run(Job job, void* data) {
+	assert(_threads);
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		assert(_runningCount == 0);
+		_job = job;
+		_data = data;
+		_runningCount = _workersCount;
+		++_generation;
+	}
+	_wakeCondition.notify_all();
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_doneCondition.wait(lock, [this] { return _runningCount == 0; });
+}
+
+int WorkerPool::WorkersCount() const {
+	return _workersCount;
+}
+
+void WorkerPool::WorkerLoop(WorkerPool* pool, int workerIndex) {
+	unsigned int generation = 0;
+
+	for (;;) {
+		Job job;
+		void* data;
+		{
+			std::unique_lock<std::mutex> lock(pool->_mutex);
+			pool->_wakeCondition.wait(lock, [pool, generation] { return pool->_quit || pool->_generation != generation; });
+
+			if (pool->_quit)
+				return;
+
+			generation = pool->_generation;
+			job = pool->_job;
+			data = pool->_data;
+		}
+
+		job(data, workerIndex);
+
+		bool last;
+		{
+			std::lock_guard<std::mutex> lock(pool->_mutex);
+			last = --pool->_runningCount == 0;
+		}
+
+		if (last)
+			pool->_doneCondition.notify_one();
+	}
+}
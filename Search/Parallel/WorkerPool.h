@@ -0,0 +1,50 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+struct IAllocator;
+
+//  WorkerPool
+//    Fixed count of threads sleeping until job is run
+//    Run calls the job once on every worker (with worker index) and waits until all of them finish
+//    Job itself distributes the work (atomic counter), pool only wakes and joins the workers
+
+class WorkerPool {
+public:
+	typedef void (*Job)(void* data, int workerIndex);
+
+public:
+	WorkerPool();
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool& oth) = delete;
+	WorkerPool& operator=(const WorkerPool& rhs) = delete;
+
+	void Init(IAllocator* allocator, int workersCount);
+
+	void Run(Job job, void* data);
+
+	int WorkersCount() const;
+
+private:
+	static void WorkerLoop(WorkerPool* pool, int workerIndex);
+
+private:
+	int _workersCount;
+	std::thread* _threads;
+
+	std::mutex _mutex;
+	std::condition_variable _wakeCondition;
+	std::condition_variable _doneCondition;
+
+	// Guarded by _mutex
+	unsigned int _generation;
+	int _runningCount;
+	bool _quit;
+	Job _job;
+	void* _data;
+
+	IAllocator* _allocator;
+};
@@ -1,15 +1,47 @@
 #include "Tests.h"
 
+#include "Config.h"
+
 #include "Collection/UIntSet.h"
+#include "Collection/UIntMap.h"
 #include "Collection/MinPriorityQueue.h"
+#include "Collection/BucketQueue.h"
+#include "Collection/IndexedPriorityQueue.h"
 
 #include "Allocator/IAllocator.h"
 #include "Allocator/HeapAllocator.h"
+#include "Allocator/LinearAllocator.h"
+#include "Allocator/PoolAllocator.h"
+
+#include "Graph/SearchContext.h"
+#include "Graph/CompactSearchContext.h"
+#include "Graph/SparseSearchContext.h"
+#include "Graph/AStar.h"
+#include "Graph/GridNeighbours.h"
+#include "Graph/BidirectionalAStar.h"
+#include "Graph/JumpPointSearch.h"
+#include "Graph/PassabilityMap.h"
+#include "Graph/PaddedMap.h"
+#include "Graph/TiledMap.h"
+#include "Graph/PathBatch.h"
+#include "Graph/PathPostProcess.h"
+#include "Graph/SearchStats.h"
+#include "Graph/HierarchicalMap.h"
+#include "Graph/IncrementalSearch.h"
+#include "Graph/ComponentMap.h"
+#include "Graph/WeightedAStar.h"
 
+#include "Map/MapGenerator.h"
+#include "Map/MovingAI.h"
+#include "Map/MapFile.h"
+
+#include <cmath>
 #include <cstdio>
+#include <cstring>
 
 #include <time.h>
 #include <algorithm>
+#include <thread>
 
 
 static void TestAssert(bool res, const char* msg) {
@@ -20,6 +52,227 @@ static void TestAssert(bool res, const char* msg) {
 }
 
 
+static void TestHeapAllocator() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	{
+		// Every thread keeps some allocations alive and frees the rest, count has to stay exact
+		const int THREADS = 8;
+		const int ITERATIONS = 20000;
+		const int KEPT = 100;
+
+		void* kept[THREADS][KEPT];
+
+		std::thread threads[THREADS];
+		for (int i = 0; i < THREADS; ++i) {
+			threads[i] = std::thread([&allocator, &kept, i] {
+				void* live[16] = {};
+				unsigned int seed = 1234 + i;
+
+				for (int j = 0; j < ITERATIONS; ++j) {
+					seed = seed * 1103515245u + 12345u;
+					int slot = (seed >> 16) & 15;
+					size_t size = 1 + ((seed >> 8) & 1023) * ((seed & 1) ? 1 : 100);
+					size_t alignment = (size_t) 1 << ((seed >> 4) & 6);
+
+					if (live[slot]) {
+						TestAssert(*static_cast<int*>(live[slot]) == i, "HeapAllocator memory was overwritten by another allocation");
+						Deallocate(&allocator, live[slot]);
+					}
+
+					live[slot] = Allocate(&allocator, size, alignment);
+					TestAssert((size_t) live[slot] % alignment == 0, "HeapAllocator should return aligned memory");
+					*static_cast<int*>(live[slot]) = i;
+				}
+
+				for (int j = 0; j < 16; ++j)
+					Deallocate(&allocator, live[j]);
+
+				for (int j = 0; j < KEPT; ++j)
+					kept[i][j] = Allocate(&allocator, 64, 8);
+			});
+		}
+
+		for (int i = 0; i < THREADS; ++i)
+			threads[i].join();
+
+		TestAssert(HeapAllocatorAllocationsCount(&allocator) == THREADS * KEPT, "HeapAllocator count should be exact after concurrent use");
+		TestAssert(HeapAllocatorAllocatedSize(&allocator) == THREADS * KEPT * 64, "HeapAllocator size should be exact after concurrent use");
+
+		for (int i = 0; i < THREADS; ++i) {
+			for (int j = 0; j < KEPT; ++j)
+				Deallocate(&allocator, kept[i][j]);
+		}
+
+		TestAssert(HeapAllocatorAllocationsCount(&allocator) == 0, "HeapAllocator count should be zero after all deallocations");
+	}
+
+	{
+		// Peak is high-water mark of requested sizes
+		HeapAllocatorResetPeak(&allocator);
+		TestAssert(HeapAllocatorPeakAllocatedSize(&allocator) == 0, "HeapAllocator peak should start from allocated size");
+
+		void* a = Allocate(&allocator, 1000, 8);
+		void* b = Allocate(&allocator, 500, 64);
+		Deallocate(&allocator, a);
+		void* c = Allocate(&allocator, 100, 1);
+
+		TestAssert(HeapAllocatorAllocatedSize(&allocator) == 600, "HeapAllocator size should count requested sizes");
+		TestAssert(HeapAllocatorPeakAllocatedSize(&allocator) == 1500, "HeapAllocator peak should be max of allocated size");
+
+		HeapAllocatorResetPeak(&allocator);
+		TestAssert(HeapAllocatorPeakAllocatedSize(&allocator) == 600, "HeapAllocator peak should be reset to allocated size");
+
+		Deallocate(&allocator, b);
+		Deallocate(&allocator, c);
+	}
+
+	AllocatorDestruct(&allocator);
+}
+
+
+static void TestLinearAllocator() {
+	HeapAllocator heap;
+	InitHeapAllocator(&heap);
+
+	{
+		LinearAllocator allocator;
+		InitLinearAllocator(&allocator, &heap, 8192);
+
+		void* a = Allocate(&allocator, 10, 1);
+		void* b = Allocate(&allocator, 100, 64);
+		TestAssert((size_t) b % 64 == 0, "LinearAllocator should return aligned memory");
+		TestAssert(static_cast<char*>(b) >= static_cast<char*>(a) + 10, "LinearAllocator allocations should not overlap");
+
+		// Last allocation is returned, others stay until reset
+		size_t used = LinearAllocatorUsed(&allocator);
+		void* c = Allocate(&allocator, 200, 8);
+		Deallocate(&allocator, c);
+		TestAssert(LinearAllocatorUsed(&allocator) == used, "LinearAllocator should free last allocation");
+
+		LinearAllocatorMark mark = LinearAllocatorGetMark(&allocator);
+		for (int i = 0; i < 10; ++i)
+			Allocate(&allocator, 100, 4);
+		LinearAllocatorReset(&allocator, &mark);
+		TestAssert(LinearAllocatorUsed(&allocator) == used, "LinearAllocator reset should free everything after mark");
+
+		// Stack order deallocation frees all
+		Deallocate(&allocator, b);
+		Deallocate(&allocator, a);
+		TestAssert(LinearAllocatorUsed(&allocator) == 0, "LinearAllocator should free allocations in stack order");
+
+		{
+			// Nested arena and containers in it
+			LinearAllocator nested;
+			InitLinearAllocator(&nested, &allocator, 4096);
+
+			UIntSet set;
+			set.Init(&nested);
+			for (unsigned int i = 0; i < 50; ++i)
+				set.Add(i * 7);
+
+			MinPriorityQueue<int> q;
+			q.Init(&nested);
+			for (int i = 0; i < 20; ++i)
+				q.Add(i, 20 - i);
+
+			TestAssert(set.Count() == 50 && set.Find(49 * 7), "UIntSet in LinearAllocator should work");
+			TestAssert(q.First() == 19, "PriorityQueue in LinearAllocator should work");
+		}
+		TestAssert(LinearAllocatorUsed(&allocator) > 0, "Nested LinearAllocator memory should be kept by parent until reset");
+
+		LinearAllocatorReset(&allocator);
+		AllocatorDestruct(&allocator);
+	}
+
+	AllocatorDestruct(&heap);
+}
+
+static void TestPoolAllocator() {
+	HeapAllocator heap;
+	InitHeapAllocator(&heap);
+
+	{
+		PoolAllocator allocator;
+		InitPoolAllocator(&allocator, &heap, 24, 16, 8);
+
+		const int COUNT = 100;
+		void* blocks[COUNT];
+
+		for (int i = 0; i < COUNT; ++i) {
+			blocks[i] = Allocate(&allocator, 24, 16);
+			TestAssert((size_t) blocks[i] % 16 == 0, "PoolAllocator should return aligned memory");
+			MemSet(blocks[i], i, 24);
+		}
+
+		for (int i = 0; i < COUNT; ++i)
+			TestAssert(static_cast<unsigned char*>(blocks[i])[23] == i, "PoolAllocator blocks should not overlap");
+
+		// Freed blocks are reused before new chunk is allocated
+		size_t heapCount = HeapAllocatorAllocationsCount(&heap);
+		for (int i = 0; i < COUNT; i += 2)
+			Deallocate(&allocator, blocks[i]);
+		for (int i = 0; i < COUNT; i += 2)
+			blocks[i] = Allocate(&allocator, 16, 8);
+		TestAssert(HeapAllocatorAllocationsCount(&heap) == heapCount, "PoolAllocator should reuse freed blocks");
+
+		for (int i = 0; i < COUNT; ++i)
+			Deallocate(&allocator, blocks[i]);
+
+		AllocatorDestruct(&allocator);
+	}
+
+	AllocatorDestruct(&heap);
+}
+
+// Random adds, range adds and pops against array of weights (max weights test padding of d-ary heap)
+template<unsigned int Arity>
+static bool PriorityQueueMatchesReference(IAllocator* allocator) {
+	const int MAX_VALS = 1000;
+	unsigned int reference[MAX_VALS];
+	unsigned int range[MAX_VALS];
+	int referenceCount = 0;
+
+	MinPriorityQueue<unsigned int, Arity> q;
+	q.Init(allocator);
+
+	bool same = true;
+	for (int i = 0; i < 5000; ++i) {
+		int operation = rand() % 8;
+		if (operation < 3 && referenceCount < MAX_VALS) {
+			unsigned int weight = rand() % 16 ? (unsigned int) (rand() % 100) : 0xFFffFFffu;
+			q.Add(weight, weight);
+			reference[referenceCount++] = weight;
+		}
+		else if (operation == 3 && referenceCount < MAX_VALS - 50) {
+			int count = rand() % 50;
+			for (int j = 0; j < count; ++j) {
+				range[j] = (unsigned int) (rand() % 100);
+				reference[referenceCount++] = range[j];
+			}
+			q.AddRange(range, range, count);
+		}
+		else if (operation == 4 && rand() % 50 == 0) {
+			q.Clear();
+			referenceCount = 0;
+		}
+		else if (referenceCount > 0) {
+			int min = 0;
+			for (int j = 1; j < referenceCount; ++j)
+				min = reference[j] < reference[min] ? j : min;
+
+			same = same && q.First() == reference[min] && (unsigned int) q.FirstWeight() == reference[min];
+			q.PopFirst();
+			reference[min] = reference[--referenceCount];
+		}
+
+		same = same && q.Count() == (unsigned int) referenceCount;
+	}
+
+	return same;
+}
+
 static void TestPriorityQueue() {
 	HeapAllocator allocator;
 	InitHeapAllocator(&allocator);
@@ -91,10 +344,268 @@ static void TestPriorityQueue() {
 		}
 	}
 
+	{
+		// Order of equal weights in binary heap is kept (searches return the same paths in ties)
+		MinPriorityQueue<int> q;
+		q.Init(&allocator);
+
+		unsigned int weights[] = {3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 2, 2};
+		int order[] = {9, 3, 7, 5, 1, 11, 10, 6, 2, 0, 4, 8};
+		for (int i = 0; i < 12; ++i)
+			q.Add(i, weights[i]);
+
+		bool same = true;
+		for (int i = 0; i < 12; ++i) {
+			same = same && q.First() == order[i];
+			q.PopFirst();
+		}
+		TestAssert(same, "PriorityQueue should pop equal weights in the same order");
+	}
+
+	{
+		// Binary and d-ary heaps (children group in one cache line)
+		TestAssert(PriorityQueueMatchesReference<2>(&allocator), "PriorityQueue should pop the lightest value");
+		TestAssert(PriorityQueueMatchesReference<4>(&allocator), "PriorityQueue with 4 children should pop the lightest value");
+		TestAssert(PriorityQueueMatchesReference<8>(&allocator), "PriorityQueue with 8 children should pop the lightest value");
+		TestAssert(PriorityQueueMatchesReference<16>(&allocator), "PriorityQueue with 16 children should pop the lightest value");
+	}
+
+	{
+		// AddRange into empty queue (heapify) and into bigger queue (bubbling up) pops the same as Add
+		const int MAX_VALS = 500;
+		int weights[MAX_VALS];
+		unsigned int rangeWeights[MAX_VALS];
+
+		for (int i = 0; i < 20; ++i) {
+			MinPriorityQueue<int> q;
+			q.Init(&allocator);
+			q.Reserve(MAX_VALS);
+			unsigned int reallocations = q.ReallocationsCount();
+
+			int n = rand() % MAX_VALS;
+			int first = i % 2 ? n - n / 4 : 0;
+			for (int j = 0; j < n; ++j) {
+				weights[j] = rand() % MAX_VALS;
+				rangeWeights[j] = (unsigned int) weights[j];
+			}
+
+			for (int j = 0; j < first; ++j)
+				q.Add(weights[j], weights[j]);
+			q.AddRange(&weights[first], &rangeWeights[first], n - first);
+			std::sort(weights, &weights[n]);
+
+			TestAssert(q.Count() == (unsigned int) n, "PriorityQueue AddRange should add all values");
+			TestAssert(q.ReallocationsCount() == reallocations, "PriorityQueue should not reallocate under reserved capacity");
+
+			bool same = true;
+			for (int k = 0; !q.Empty(); ++k) {
+				same = same && q.FirstWeight() == weights[k] && q.First() == weights[k];
+				q.PopFirst();
+			}
+			TestAssert(same, "PriorityQueue Pop -ing after AddRange should match ordered array");
+
+			q.AddRange(weights, rangeWeights, 0);
+			TestAssert(q.Empty(), "PriorityQueue AddRange of nothing should keep it empty");
+		}
+	}
+
+	AllocatorDestruct(&allocator);
+}
+
+
+static void TestBucketQueue() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	{
+		BucketQueue<int> q;
+		q.Init(&allocator);
+
+		int vals[] = {55, 22, 88, 1919, 1414, 11, 1010};
+		int weights[] = {5, 2, 8, 19, 14, 1, 10};
+
+		int sorted[] = {11, 22, 55, 88, 1010, 1414, 1919};
+		int sortedWeights[] = {1, 2, 5, 8, 10, 14, 19};
+
+		for (size_t i = 0; i < sizeof(weights) / sizeof(int); ++i)
+			q.Add(vals[i], weights[i]);
+
+		int i = 0;
+		int w, v;
+		while (!q.Empty()) {
+			v = q.First();
+			w = q.FirstWeight();
+			q.PopFirst();
+
+			TestAssert(v == sorted[i], "BucketQueue Pop -ing value should match ordered array");
+			TestAssert(w == sortedWeights[i], "BucketQueue Pop -ing weight should match ordered array");
+			++i;
+		}
+
+		TestAssert(q.Empty(), "BucketQueue should be empty");
+	}
+
+	{
+		// Values with the same weight are LIFO
+		BucketQueue<int> q;
+		q.Init(&allocator);
+		q.Add(1, 3);
+		q.Add(2, 3);
+		q.Add(3, 3);
+		q.Add(4, 5);
+		q.Add(5, 4);
+
+		int order[] = {3, 2, 1, 5, 4};
+		for (int i = 0; i < 5; ++i) {
+			TestAssert(q.First() == order[i], "BucketQueue same weights should be popped LIFO");
+			q.PopFirst();
+		}
+		TestAssert(q.Empty(), "BucketQueue should be empty");
+	}
+
+	{
+		// Monotone usage as in A*, weights added after pop are not smaller than popped one
+		BucketQueue<int> q;
+		q.Init(&allocator);
+
+		for (int round = 0; round < 3; ++round) {
+			q.Clear();
+			TestAssert(q.Empty(), "BucketQueue should be empty after clear");
+
+			q.Add(0, 100 * round);
+			unsigned int last = 0;
+			int added = 1;
+			while (!q.Empty()) {
+				unsigned int w = q.FirstWeight();
+				q.PopFirst();
+
+				TestAssert(w >= last, "BucketQueue Pop -ing should be ordered");
+				last = w;
+
+				for (int j = 0; j < 2 && added < 5000; ++j, ++added)
+					q.Add(added, w + (rand() % 3));
+			}
+		}
+	}
+
+	{
+		// Random tests, they are hard to reproduce, but good as bruteforce to find if any problem exist
+		const int COUNT = 50;
+		const int MAX_VALS = 500;
+
+		int weights[MAX_VALS + 10];
+
+		for (int i = 0; i < COUNT; ++i) {
+			BucketQueue<int> q;
+			q.Init(&allocator);
+			int n = rand() % MAX_VALS;
+
+			for (int j = 0; j < n; ++j) {
+				weights[j] = rand() % MAX_VALS;
+				q.Add(weights[j], weights[j]);
+			}
+			std::sort(weights, &weights[n]);
+
+			int k = 0;
+			int w;
+			while (!q.Empty()) {
+				w = q.FirstWeight();
+				q.PopFirst();
+
+				TestAssert(w == weights[k], "BucketQueue Pop -ing should match ordered array");
+				++k;
+			}
+
+			TestAssert(q.Empty(), "BucketQueue should be empty");
+		}
+	}
+
 	AllocatorDestruct(&allocator);
 }
 
 
+static void TestIndexedPriorityQueue() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	{
+		IndexedPriorityQueue q;
+		q.Init(&allocator);
+		q.Begin(10);
+
+		q.Add(3, 30);
+		q.Add(5, 50);
+		q.Add(7, 70);
+		q.DecreaseKey(7, 10);
+
+		TestAssert(q.Count() == 3, "IndexedPriorityQueue should have every key once");
+		TestAssert(q.First() == 7 && q.FirstWeight() == 10, "IndexedPriorityQueue decreased key should be first");
+		TestAssert(!q.AddOrDecreaseKey(3, 40), "IndexedPriorityQueue should not increase weight");
+		TestAssert(q.AddOrDecreaseKey(5, 20) && q.Weight(5) == 20, "IndexedPriorityQueue should decrease weight");
+		TestAssert(q.Remove(3) && !q.Remove(3) && !q.Contains(3), "IndexedPriorityQueue removed key should not be inside");
+
+		q.PopFirst();
+		TestAssert(q.First() == 5 && !q.Contains(7), "IndexedPriorityQueue popped key should not be inside");
+
+		q.Begin(20);
+		TestAssert(q.Empty() && !q.Contains(5), "IndexedPriorityQueue Begin should clear keys");
+	}
+
+	{
+		// Random operations against array of weights, queue has to pop the lightest key
+		const int KEYS = 200;
+		const int OPERATIONS = 20000;
+		const unsigned int ABSENT = 0xFFffFFffu;
+		unsigned int weights[KEYS];
+
+		IndexedPriorityQueue q;
+		q.Init(&allocator);
+		q.Begin(KEYS);
+		for (int i = 0; i < KEYS; ++i)
+			weights[i] = ABSENT;
+
+		bool same = true;
+		unsigned int count = 0;
+		for (int i = 0; i < OPERATIONS; ++i) {
+			int key = rand() % KEYS;
+			unsigned int weight = (unsigned int) (rand() % 1000);
+
+			int operation = rand() % 4;
+			if (operation == 0) {
+				same = same && q.Remove(key) == (weights[key] != ABSENT);
+				count -= weights[key] != ABSENT;
+				weights[key] = ABSENT;
+			}
+			else if (operation == 1 && !q.Empty()) {
+				int first = q.First();
+				for (int k = 0; k < KEYS; ++k)
+					same = same && (weights[k] == ABSENT || weights[k] >= weights[first]);
+				same = same && (unsigned int) q.FirstWeight() == weights[first];
+				q.PopFirst();
+				weights[first] = ABSENT;
+				--count;
+			}
+			else {
+				bool changed = q.AddOrDecreaseKey(key, weight);
+				same = same && changed == (weights[key] == ABSENT || weight < weights[key]);
+				count += weights[key] == ABSENT;
+				if (changed)
+					weights[key] = weight;
+			}
+
+			same = same && q.Count() == count && q.Contains(key) == (weights[key] != ABSENT);
+		}
+
+		TestAssert(same, "IndexedPriorityQueue should match reference after random operations");
+
+		q.Clear();
+		for (int i = 0; i < KEYS; ++i)
+			same = same && !q.Contains(i);
+		TestAssert(same && q.Empty(), "IndexedPriorityQueue Clear should remove all keys");
+	}
+
+	AllocatorDestruct(&allocator);
+}
 
 static void TestUIntSet() {
 	HeapAllocator allocator;
@@ -199,10 +710,1610 @@ static void TestUIntSet() {
 			TestAssert(has == (i % 4 == 2 || i % 8 == 0), "Set find returned false where it should return true");
 		}
 	}
+
+	{
+		// Random adds and removes against bool array, keys with the same low bits collide in runs
+		UIntSet set;
+		set.Init(&allocator);
+
+		const unsigned int KEYS = 4096;
+		const int OPERATIONS = 100000;
+		bool inside[KEYS] = {};
+		unsigned int insideCount = 0;
+
+		for (int i = 0; i < OPERATIONS; ++i) {
+			unsigned int key = (unsigned int) rand() % KEYS;
+			unsigned int value = key << 20;
+
+			if (rand() % 3) {
+				set.Add(value);
+				insideCount += !inside[key];
+				inside[key] = true;
+			}
+			else {
+				set.Remove(value);
+				insideCount -= inside[key];
+				inside[key] = false;
+			}
+		}
+
+		bool same = set.Count() == insideCount;
+		for (unsigned int key = 0; key < KEYS; ++key)
+			same = same && set.Find(key << 20) == inside[key];
+
+		TestAssert(same, "Set should match reference after random adds and removes");
+	}
+
+	{
+		// Range operations match single ones, Clear keeps set usable
+		UIntSet set;
+		set.Init(&allocator);
+
+		const unsigned int N = 1000;
+		unsigned int values[2 * N];
+		bool found[2 * N];
+		for (unsigned int i = 0; i < 2 * N; ++i)
+			values[i] = i * 7919;
+
+		set.Reserve(N);
+		set.AddRange(values, N);
+		set.AddRange(values, N / 2);
+		TestAssert(set.Count() == N, "Set AddRange should add every value once");
+
+		unsigned int foundCount = set.FindRange(values, 2 * N, found);
+		bool same = foundCount == N;
+		for (unsigned int i = 0; i < 2 * N; ++i)
+			same = same && found[i] == (i < N) && set.Find(values[i]) == (i < N);
+		TestAssert(same, "Set FindRange should match Find");
+
+		set.Clear();
+		TestAssert(set.Empty(), "Set should be empty after Clear");
+		TestAssert(set.FindRange(values, N, found) == 0, "Cleared set should not find values");
+
+		set.AddRange(&values[N], N);
+		TestAssert(set.Count() == N && set.Find(values[N]) && !set.Find(values[0]), "Cleared set should be reusable");
+	}
 }
 
-void TestAll() {
-	TestPriorityQueue();
+static void TestUIntMap() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
 
-	TestUIntSet();
+	{
+		UIntMap<int> map;
+		map.Init(&allocator);
+
+		TestAssert(map.Find(3) == nullptr, "Empty map should not find key");
+
+		bool inserted = false;
+		*map.Insert(3, &inserted) = 30;
+		TestAssert(inserted && map.Count() == 1 && *map.Find(3) == 30, "Map should find inserted key");
+
+		*map.Insert(3, &inserted) += 1;
+		TestAssert(!inserted && map.Count() == 1 && *map.Find(3) == 31, "Map insert of existing key should return its value");
+
+		TestAssert(map.Remove(3) && !map.Remove(3) && map.Empty(), "Map should remove key once");
+	}
+
+	{
+		// Random inserts and removes against arrays, keys with the same low bits collide in runs
+		UIntMap<int> map;
+		map.Init(&allocator);
+
+		const unsigned int KEYS = 4096;
+		const int OPERATIONS = 100000;
+		bool inside[KEYS] = {};
+		int values[KEYS] = {};
+		unsigned int insideCount = 0;
+
+		for (int i = 0; i < OPERATIONS; ++i) {
+			unsigned int key = (unsigned int) rand() % KEYS;
+
+			if (rand() % 3) {
+				*map.Insert(key << 20) = i;
+				insideCount += !inside[key];
+				inside[key] = true;
+				values[key] = i;
+			}
+			else {
+				TestAssert(map.Remove(key << 20) == inside[key], "Map remove should return whether key was inside");
+				insideCount -= inside[key];
+				inside[key] = false;
+			}
+		}
+
+		bool same = map.Count() == insideCount;
+		for (unsigned int key = 0; key < KEYS; ++key) {
+			const int* value = map.Find(key << 20);
+			same = same && (value != nullptr) == inside[key] && (!value || *value == values[key]);
+		}
+		TestAssert(same, "Map should match reference after random inserts and removes");
+
+		unsigned int reallocations = map.ReallocationsCount();
+		map.Clear();
+		TestAssert(map.Empty() && map.Find(0) == nullptr, "Map clear should remove all keys");
+
+		for (unsigned int key = 0; key < insideCount; ++key)
+			*map.Insert(key) = 0;
+		TestAssert(map.ReallocationsCount() == reallocations, "Map clear should keep memory");
+	}
+
+	AllocatorDestruct(&allocator);
+}
+
+static void TestSearchContext() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	const int WIDTH = 8;
+	const int HEIGHT = 5;
+	unsigned char map[] = {1,1,1,1,1,1,1,1,
+	                       1,0,0,0,0,0,0,1,
+	                       1,1,1,1,1,1,0,1,
+	                       0,0,0,0,0,1,0,1,
+	                       1,1,1,1,1,1,0,1};
+
+	int buffer[WIDTH * HEIGHT];
+
+	{
+		SearchContext context;
+		context.Init(&allocator);
+
+		// Reused context has to give the same results as fresh one
+		for (int i = 0; i < 3; ++i) {
+			TestAssert(FindPath(&context, 0, 0, 0, 4, map, WIDTH, HEIGHT, buffer, WIDTH * HEIGHT) == 14, "FindPath should find shortest path");
+			TestAssert(buffer[0] == 32 && buffer[13] == 8, "FindPath should write path from target to start");
+
+			TestAssert(FindPath(&context, 0, 0, 7, 4, map, WIDTH, HEIGHT, buffer, WIDTH * HEIGHT) == 11, "FindPath should find shortest path");
+			TestAssert(FindPath(&context, 0, 0, 0, 3, map, WIDTH, HEIGHT, buffer, WIDTH * HEIGHT) == SearchContext::INFINITE_COST, "FindPath should not find path to blocked cell");
+			TestAssert(FindPath(&context, 2, 2, 2, 2, map, WIDTH, HEIGHT, buffer, WIDTH * HEIGHT) == 0, "FindPath should find empty path to start");
+		}
+
+		// Bucket open list has to find paths with the same cost
+		BucketQueue<int> bucketQueue;
+		bucketQueue.Init(&allocator);
+		TestAssert(FindPath(&context, &bucketQueue, 0, 0, 0, 4, map, WIDTH, HEIGHT, buffer, WIDTH * HEIGHT) == 14, "FindPath with BucketQueue should find shortest path");
+		TestAssert(FindPath(&context, &bucketQueue, 0, 0, 7, 4, map, WIDTH, HEIGHT, buffer, WIDTH * HEIGHT) == 11, "FindPath with BucketQueue should find shortest path");
+
+		// Smaller map in bigger context
+		TestAssert(FindPath(&context, 0, 0, 7, 0, map, WIDTH, 1, buffer, WIDTH * HEIGHT) == 7, "FindPath should find shortest path");
+
+		// Stats of corridor search, memory is already allocated by previous searches
+		SearchStats stats;
+		FindPath(&context, 0, 0, 7, 0, map, WIDTH, 1, buffer, WIDTH * HEIGHT, &stats);
+		TestAssert(stats.expandedCount == 7 && stats.pushedCount == 8 && stats.peakOpenCount == 1, "FindPath stats should count corridor nodes");
+		TestAssert(stats.allocationsCount == 0 && stats.openReallocationsCount == 0, "FindPath stats should count no allocations in reused context");
+
+		FindPathJPS(&context, 0, 0, 7, 0, map, WIDTH, 1, buffer, WIDTH * HEIGHT, &stats);
+		TestAssert(stats.expandedCount == 1 && stats.pushedCount == 2, "FindPathJPS stats should count jump points");
+
+		FindPath(&context, 2, 2, 2, 2, map, WIDTH, HEIGHT, buffer, WIDTH * HEIGHT, &stats);
+		TestAssert(stats.expandedCount == 0 && stats.pushedCount == 1, "FindPath stats should count only start for empty path");
+	}
+
+	{
+		// Fresh context allocates node states and open list
+		SearchContext context;
+		context.Init(&allocator);
+
+		SearchStats stats;
+		FindPath(&context, 0, 0, 0, 4, map, WIDTH, HEIGHT, buffer, WIDTH * HEIGHT, &stats);
+		TestAssert(stats.allocationsCount > stats.openReallocationsCount && stats.openReallocationsCount > 0, "FindPath stats should count allocations of fresh context");
+		TestAssert(stats.pushedCount >= stats.expandedCount && stats.peakOpenCount <= stats.pushedCount, "FindPath stats should be consistent");
+	}
+
+	AllocatorDestruct(&allocator);
+}
+
+static bool IsValidPath(const int* path, int length, int start, int target, const unsigned char* map, int width) {
+	int node = start;
+	for (int i = length - 1; i >= 0; --i) {
+		int diff = abs(path[i] - node);
+		bool neighbour = diff == width || (diff == 1 && path[i] / width == node / width);
+		if (!neighbour || map[path[i]] == 0)
+			return false;
+		node = path[i];
+	}
+	return node == target;
+}
+
+// Query on random map, start and target cells are passable
+struct RandomQuery {
+	int width;
+	int height;
+	int start;
+	int target;
+	int sx, sy;
+	int tx, ty;
+};
+
+// Random map up to maxSize x maxSize with obstacle percent below maxObstacles, seed is given to GenerateRandomMap
+static RandomQuery MakeRandomQuery(unsigned char* map, int maxSize, int maxObstacles, int seed) {
+	RandomQuery query;
+	query.width = 1 + rand() % maxSize;
+	query.height = 1 + rand() % maxSize;
+	GenerateRandomMap(map, query.width, query.height, rand() % maxObstacles, seed);
+
+	query.start = rand() % (query.width * query.height);
+	query.target = rand() % (query.width * query.height);
+	map[query.start] = 1;
+	map[query.target] = 1;
+
+	query.sx = query.start % query.width;
+	query.sy = query.start / query.width;
+	query.tx = query.target % query.width;
+	query.ty = query.target / query.width;
+	return query;
+}
+
+// Random queries, search(map, query, buffer, bufferSize) has to give path cost of FindPath and write valid path into buffer
+// map and buffer have maxSize * maxSize cells
+template<typename Search>
+static void TestMatchesFindPath(SearchContext* referenceContext, unsigned char* map, int* buffer, int maxSize, int count, int maxObstacles,
+	Search search, const char* costMessage, const char* pathMessage) {
+
+	bool sameCost = true;
+	bool validPath = true;
+	for (int i = 0; i < count; ++i) {
+		RandomQuery query = MakeRandomQuery(map, maxSize, maxObstacles, i);
+
+		int reference = FindPath(referenceContext, query.sx, query.sy, query.tx, query.ty, map, query.width, query.height, nullptr, 0);
+		int cost = search(map, query, buffer, maxSize * maxSize);
+
+		sameCost = sameCost && cost == reference;
+		if (cost != SearchContext::INFINITE_COST)
+			validPath = validPath && IsValidPath(buffer, cost, query.start, query.target, map, query.width);
+	}
+
+	TestAssert(sameCost, costMessage);
+	TestAssert(validPath, pathMessage);
+}
+
+static void TestGridNeighbours() {
+	// Kernel has to match scalar version on all cells (borders included)
+	const int WIDTH = 13;
+	const int HEIGHT = 7;
+
+	unsigned char map[WIDTH * HEIGHT];
+	GenerateRandomMap(map, WIDTH, HEIGHT, 30, 5);
+
+	bool same = true;
+	for (int y = 0; y < HEIGHT; ++y) {
+		for (int x = 0; x < WIDTH; ++x) {
+			int node = x + y * WIDTH;
+			int targetX = rand() % WIDTH;
+			int targetY = rand() % HEIGHT;
+
+			GridNeighbours scalar, kernel;
+			unsigned int scalarMask = GridExpandScalar(x, y, node, targetX, targetY, map, WIDTH, HEIGHT, &scalar);
+			unsigned int kernelMask = GridExpand(x, y, node, targetX, targetY, map, WIDTH, HEIGHT, &kernel);
+
+			same = same && scalarMask == kernelMask;
+			for (int i = 0; i < 4; ++i) {
+				if (!((scalarMask >> i) & 1))
+					continue;
+
+				int nb = scalar.nodes[i];
+				same = same && nb == kernel.nodes[i] && scalar.coords[i] == kernel.coords[i] && scalar.heuristics[i] == kernel.heuristics[i];
+				same = same && map[nb] && GridUnpackX(kernel.coords[i]) == nb % WIDTH && GridUnpackY(kernel.coords[i]) == nb / WIDTH;
+				same = same && kernel.heuristics[i] == abs(targetX - nb % WIDTH) + abs(targetY - nb / WIDTH);
+			}
+
+			int expectedCount = 0;
+			expectedCount += y > 0 && map[node - WIDTH];
+			expectedCount += x < WIDTH - 1 && map[node + 1];
+			expectedCount += y < HEIGHT - 1 && map[node + WIDTH];
+			expectedCount += x > 0 && map[node - 1];
+
+			int count = 0;
+			for (unsigned int mask = kernelMask; mask; mask &= mask - 1)
+				++count;
+			same = same && count == expectedCount;
+		}
+	}
+
+	TestAssert(same, "GridExpand should match scalar neighbours expansion");
+	TestAssert(GridUnpackX(GridPackCoords(GRID_MAX_PACKED_WIDTH - 1, GRID_MAX_PACKED_HEIGHT - 1)) == GRID_MAX_PACKED_WIDTH - 1 &&
+		GridUnpackY(GridPackCoords(GRID_MAX_PACKED_WIDTH - 1, GRID_MAX_PACKED_HEIGHT - 1)) == GRID_MAX_PACKED_HEIGHT - 1, "Packed coordinates should be unpacked");
+
+	// Coordinates are packed only when map fits, node is kept otherwise
+	GridCoder packedCoder = GridCoderMake(GRID_MAX_PACKED_WIDTH, GRID_MAX_PACKED_HEIGHT);
+	GridCoder wideCoder = GridCoderMake(GRID_MAX_PACKED_WIDTH + 1, 2);
+
+	int decodedX, decodedY;
+	GridDecode(&packedCoder, GridEncode(&packedCoder, 12345, 321), &decodedX, &decodedY);
+	TestAssert(packedCoder.packed && decodedX == 12345 && decodedY == 321, "GridCoder should pack coordinates of map within packed limits");
+
+	GridDecode(&wideCoder, GridEncode(&wideCoder, GRID_MAX_PACKED_WIDTH, 1), &decodedX, &decodedY);
+	TestAssert(!wideCoder.packed && GridEncode(&wideCoder, 3, 1) == 3 + (GRID_MAX_PACKED_WIDTH + 1) && decodedX == GRID_MAX_PACKED_WIDTH && decodedY == 1,
+		"GridCoder should keep node of map over packed limits");
+}
+
+static void TestPassabilityMap() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	{
+		// Sizes around 64 bit words, scans are compared with cell by cell scans
+		const int sizes[] = {1, 3, 63, 64, 65, 130};
+
+		for (int width : sizes) {
+			for (int height : sizes) {
+				unsigned char* map = static_cast<unsigned char*>(Allocate(&allocator, width * height, 1));
+				void* mem = Allocate(&allocator, PassabilityMapMemorySize(width, height), 8);
+
+				int density = rand() % 30;
+				for (int i = 0; i < width * height; ++i)
+					map[i] = (rand() % 100) < density ? 0 : 1;
+
+				PassabilityMap bits = PassabilityMapMake(mem, width, height);
+				PassabilityMapBuild(&bits, map);
+
+				for (int y = 0; y < height; ++y) {
+					for (int x = 0; x < width; ++x) {
+						TestAssert(PassabilityMapIs(&bits, x, y) == (map[x + y * width] != 0), "PassabilityMap cell should match byte map");
+
+						int next = x;
+						while (next < width && map[next + y * width])
+							++next;
+						TestAssert(PassabilityMapNextBlockedInRow(&bits, x, y) == next, "PassabilityMap next blocked in row is incorrect");
+
+						int prev = x;
+						while (prev >= 0 && map[prev + y * width])
+							--prev;
+						TestAssert(PassabilityMapPrevBlockedInRow(&bits, x, y) == prev, "PassabilityMap prev blocked in row is incorrect");
+
+						next = y;
+						while (next < height && map[x + next * width])
+							++next;
+						TestAssert(PassabilityMapNextBlockedInColumn(&bits, x, y) == next, "PassabilityMap next blocked in column is incorrect");
+
+						prev = y;
+						while (prev >= 0 && map[x + prev * width])
+							--prev;
+						TestAssert(PassabilityMapPrevBlockedInColumn(&bits, x, y) == prev, "PassabilityMap prev blocked in column is incorrect");
+					}
+				}
+
+				Deallocate(&allocator, mem);
+				Deallocate(&allocator, map);
+			}
+		}
+	}
+
+	AllocatorDestruct(&allocator);
+}
+
+static void TestPaddedMap() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	{
+		SearchContext context;
+		context.Init(&allocator);
+
+		BucketQueue<int> bucketQueue;
+		bucketQueue.Init(&allocator);
+
+		const int COUNT = 200;
+		const int MAX_SIZE = 40;
+
+		unsigned char map[MAX_SIZE * MAX_SIZE];
+		int buffer[MAX_SIZE * MAX_SIZE];
+
+		void* paddedMem = Allocate(&allocator, PaddedMapMemorySize(MAX_SIZE, MAX_SIZE), 1);
+
+		// Layout, border is blocked and indices are translated back
+		{
+			GenerateRandomMap(map, 5, 3, 30, 1);
+			PaddedMap padded = PaddedMapMake(paddedMem, 5, 3);
+			PaddedMapBuild(&padded, map);
+
+			TestAssert(padded.stride == 8 && PaddedMapIndicesCount(&padded) == 8 * 5, "PaddedMap stride should be power of two");
+
+			bool same = true;
+			for (int y = -1; y <= 3; ++y) {
+				for (int x = -1; x <= 5; ++x) {
+					int index = PaddedMapIndex(&padded, x, y);
+					bool inside = x >= 0 && x < 5 && y >= 0 && y < 3;
+					same = same && PaddedMapX(&padded, index) == x && PaddedMapY(&padded, index) == y;
+					same = same && (inside ? (padded.cells[index] != 0) == (map[x + y * 5] != 0) && PaddedMapNode(&padded, index) == x + y * 5 : padded.cells[index] == 0);
+				}
+			}
+			TestAssert(same, "PaddedMap should have map cells inside of blocked border");
+		}
+
+		// Random maps, search on padded map has to give the same path cost as on byte map
+		TestMatchesFindPath(&context, map, buffer, MAX_SIZE, COUNT, 40,
+			[&](const unsigned char* queryMap, const RandomQuery& query, int* outBuffer, int bufferSize) {
+				PaddedMap padded = PaddedMapMake(paddedMem, query.width, query.height);
+				PaddedMapBuild(&padded, queryMap);
+				return FindPath(&context, query.sx, query.sy, query.tx, query.ty, &padded, outBuffer, bufferSize);
+			},
+			"FindPath on PaddedMap path cost should match FindPath path cost", "FindPath on PaddedMap path should be connected and passable");
+
+		TestMatchesFindPath(&context, map, buffer, MAX_SIZE, COUNT, 40,
+			[&](const unsigned char* queryMap, const RandomQuery& query, int* outBuffer, int bufferSize) {
+				PaddedMap padded = PaddedMapMake(paddedMem, query.width, query.height);
+				PaddedMapBuild(&padded, queryMap);
+				return FindPath(&context, &bucketQueue, query.sx, query.sy, query.tx, query.ty, &padded, outBuffer, bufferSize);
+			},
+			"FindPath on PaddedMap with BucketQueue path cost should match FindPath path cost",
+			"FindPath on PaddedMap with BucketQueue path should be connected and passable");
+
+		Deallocate(&allocator, paddedMem);
+	}
+
+	AllocatorDestruct(&allocator);
+}
+
+static void TestTiledMap() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	{
+		SearchContext context;
+		context.Init(&allocator);
+
+		const int COUNT = 200;
+		const int MAX_SIZE = 40;
+
+		unsigned char map[MAX_SIZE * MAX_SIZE];
+		int buffer[MAX_SIZE * MAX_SIZE];
+
+		void* tiledMem = Allocate(&allocator, TiledMapMemorySize(MAX_SIZE, MAX_SIZE), 1);
+
+		// Every cell has its own index, index is translated back
+		{
+			const int WIDTH = 19;
+			const int HEIGHT = 10;
+
+			GenerateRandomMap(map, WIDTH, HEIGHT, 30, 2);
+			TiledMap tiled = TiledMapMake(tiledMem, WIDTH, HEIGHT);
+			TiledMapBuild(&tiled, map);
+
+			TestAssert(TiledMapIndicesCount(&tiled) == 3 * 2 * 64, "TiledMap should have whole tiles");
+
+			int passableCount = 0;
+			int tiledPassableCount = 0;
+			bool same = true;
+			for (int y = 0; y < HEIGHT; ++y) {
+				for (int x = 0; x < WIDTH; ++x) {
+					int index = TiledMapIndex(&tiled, x, y);
+					same = same && TiledMapNode(&tiled, index) == x + y * WIDTH && (tiled.cells[index] != 0) == (map[x + y * WIDTH] != 0);
+					passableCount += map[x + y * WIDTH] != 0;
+				}
+			}
+
+			for (int i = 0; i < TiledMapIndicesCount(&tiled); ++i)
+				tiledPassableCount += tiled.cells[i];
+
+			TestAssert(same, "TiledMap should have the same cells as map");
+			TestAssert(passableCount == tiledPassableCount, "TiledMap padding should be blocked");
+		}
+
+		// Random maps, search on tiled map has to give the same path cost as on byte map
+		TestMatchesFindPath(&context, map, buffer, MAX_SIZE, COUNT, 40,
+			[&](const unsigned char* queryMap, const RandomQuery& query, int* outBuffer, int bufferSize) {
+				TiledMap tiled = TiledMapMake(tiledMem, query.width, query.height);
+				TiledMapBuild(&tiled, queryMap);
+				return FindPath(&context, query.sx, query.sy, query.tx, query.ty, &tiled, outBuffer, bufferSize);
+			},
+			"FindPath on TiledMap path cost should match FindPath path cost", "FindPath on TiledMap path should be connected and passable");
+
+		Deallocate(&allocator, tiledMem);
+	}
+
+	AllocatorDestruct(&allocator);
+}
+
+static void TestSparseSearchContext() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	{
+		SparseSearchContext context;
+		context.Init(&allocator);
+
+		SearchContext denseContext;
+		denseContext.Init(&allocator);
+
+		const int COUNT = 300;
+		const int MAX_SIZE = 40;
+
+		unsigned char map[MAX_SIZE * MAX_SIZE];
+		int buffer[MAX_SIZE * MAX_SIZE];
+
+		// Random maps, sparse search has to give the same path cost as FindPath
+		TestMatchesFindPath(&denseContext, map, buffer, MAX_SIZE, COUNT, 40,
+			[&](const unsigned char* queryMap, const RandomQuery& query, int* outBuffer, int bufferSize) {
+				return FindPath(&context, query.sx, query.sy, query.tx, query.ty, queryMap, query.width, query.height, outBuffer, bufferSize);
+			},
+			"FindPath with SparseSearchContext path cost should match FindPath path cost",
+			"FindPath with SparseSearchContext path should be connected and passable");
+	}
+
+	{
+		// Short path on big open map, states are kept only for reached nodes
+		const int SIZE = 2048;
+		unsigned char* map = static_cast<unsigned char*>(Allocate(&allocator, SIZE * SIZE, 1));
+		MemSet(map, 1, SIZE * SIZE);
+
+		SparseSearchContext context;
+		context.Init(&allocator);
+
+		int buffer[64];
+		int cost = FindPath(&context, 1000, 1000, 1020, 1010, map, SIZE, SIZE, buffer, 64);
+
+		TestAssert(cost == 30, "FindPath with SparseSearchContext should find path on open map");
+		TestAssert(context.MemorySize() < 64 * 1024, "SparseSearchContext memory should scale with reached nodes");
+
+		Deallocate(&allocator, map);
+	}
+
+	AllocatorDestruct(&allocator);
+}
+
+// Cheapest cost of entering cells from start to target, relaxation until nothing changes
+static int WeightedReferenceCost(const unsigned char* map, int width, int height, int start, int target, int* costs) {
+	const int INFINITE = SearchContext::INFINITE_COST;
+	for (int i = 0; i < width * height; ++i)
+		costs[i] = INFINITE;
+	costs[start] = 0;
+
+	for (bool changed = true; changed; ) {
+		changed = false;
+		for (int node = 0; node < width * height; ++node) {
+			if (costs[node] == INFINITE)
+				continue;
+
+			int x = node % width, y = node / width;
+			int nbs[4] = {y > 0 ? node - width : -1, x + 1 < width ? node + 1 : -1, y + 1 < height ? node + width : -1, x > 0 ? node - 1 : -1};
+			for (int i = 0; i < 4; ++i) {
+				if (nbs[i] >= 0 && map[nbs[i]] && costs[node] + map[nbs[i]] < costs[nbs[i]]) {
+					costs[nbs[i]] = costs[node] + map[nbs[i]];
+					changed = true;
+				}
+			}
+		}
+	}
+
+	return costs[target];
+}
+
+static void TestWeightedAStar() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	{
+		SearchContext context;
+		context.Init(&allocator);
+
+		IndexedPriorityQueue indexed;
+		indexed.Init(&allocator);
+
+		MinPriorityQueue<int> duplicates;
+		duplicates.Init(&allocator);
+
+		const int COUNT = 200;
+		const int MAX_SIZE = 30;
+
+		unsigned char map[MAX_SIZE * MAX_SIZE];
+		int costs[MAX_SIZE * MAX_SIZE];
+		int buffer[MAX_SIZE * MAX_SIZE];
+
+		// Random maps with random cell costs, both open lists have to give the cheapest cost
+		bool sameCost = true;
+		bool validPath = true;
+		for (int i = 0; i < COUNT; ++i) {
+			RandomQuery query = MakeRandomQuery(map, MAX_SIZE, 30, i);
+			const int width = query.width;
+			const int height = query.height;
+			for (int j = 0; j < width * height; ++j)
+				map[j] = map[j] ? (unsigned char) (1 + rand() % 9) : 0;
+
+			int reference = WeightedReferenceCost(map, width, height, query.start, query.target, costs);
+
+			for (int k = 0; k < 2; ++k) {
+				int length = 0;
+				int cost = k == 0 ?
+					FindPathWeighted(&context, &indexed, query.sx, query.sy, query.tx, query.ty, map, width, height, buffer, MAX_SIZE * MAX_SIZE, &length) :
+					FindPathWeighted(&context, &duplicates, query.sx, query.sy, query.tx, query.ty, map, width, height, buffer, MAX_SIZE * MAX_SIZE, &length);
+
+				sameCost = sameCost && cost == reference;
+				if (cost != SearchContext::INFINITE_COST) {
+					int pathCost = 0;
+					for (int j = 0; j < length; ++j)
+						pathCost += map[buffer[j]];
+					validPath = validPath && IsValidPath(buffer, length, query.start, query.target, map, width) && pathCost == cost;
+				}
+			}
+		}
+
+		TestAssert(sameCost, "FindPathWeighted path cost should be the cheapest cost");
+		TestAssert(validPath, "FindPathWeighted path should be connected, passable and as expensive as returned cost");
+	}
+
+	{
+		// Uniform costs are the same search as FindPath
+		const int SIZE = 32;
+		unsigned char map[SIZE * SIZE];
+		GenerateRandomMap(map, SIZE, SIZE, 20, 3);
+		map[0] = 1;
+		map[SIZE * SIZE - 1] = 1;
+
+		SearchContext context;
+		context.Init(&allocator);
+
+		IndexedPriorityQueue indexed;
+		indexed.Init(&allocator);
+
+		int cost = FindPath(&context, 0, 0, SIZE - 1, SIZE - 1, map, SIZE, SIZE, nullptr, 0);
+		int length = -1;
+		int weightedCost = FindPathWeighted(&context, &indexed, 0, 0, SIZE - 1, SIZE - 1, map, SIZE, SIZE, nullptr, 0, &length);
+
+		TestAssert(cost == weightedCost, "FindPathWeighted on uniform costs should match FindPath");
+		TestAssert(cost == SearchContext::INFINITE_COST || length == cost, "FindPathWeighted path length should be cost on uniform costs");
+	}
+
+	AllocatorDestruct(&allocator);
+}
+
+static void TestCompactSearchContext() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	{
+		CompactSearchContext context;
+		context.Init(&allocator);
+
+		// States of previous searches are invalid, also after generation overflow
+		{
+			const int NODES = 10;
+
+			bool closedReset = true;
+			bool directionKept = true;
+			for (int search = 0; search < 100; ++search) {
+				context.Begin(NODES);
+				for (int node = 0; node < NODES; ++node)
+					closedReset = closedReset && !context.IsClosed(node);
+
+				int node = search % NODES;
+				context.Close(node, search % CompactSearchContext::DIRECTIONS_COUNT);
+				directionKept = directionKept && context.IsClosed(node) && context.ParentDirection(node) == search % CompactSearchContext::DIRECTIONS_COUNT;
+			}
+
+			TestAssert(closedReset, "CompactSearchContext Begin should invalidate closed nodes");
+			TestAssert(directionKept, "CompactSearchContext should keep parent direction of closed node");
+			TestAssert(context.ReallocationsCount() == 1, "CompactSearchContext should reallocate only for bigger graph");
+		}
+
+		SearchContext fullContext;
+		fullContext.Init(&allocator);
+
+		BucketQueue<int> bucketQueue;
+		bucketQueue.Init(&allocator);
+
+		const int COUNT = 300;
+		const int MAX_SIZE = 40;
+
+		unsigned char map[MAX_SIZE * MAX_SIZE];
+		int buffer[MAX_SIZE * MAX_SIZE];
+
+		// Random maps, compact search has to give the same path cost as FindPath
+		TestMatchesFindPath(&fullContext, map, buffer, MAX_SIZE, COUNT, 40,
+			[&](const unsigned char* queryMap, const RandomQuery& query, int* outBuffer, int bufferSize) {
+				return FindPath(&context, query.sx, query.sy, query.tx, query.ty, queryMap, query.width, query.height, outBuffer, bufferSize);
+			},
+			"FindPath with CompactSearchContext path cost should match FindPath path cost",
+			"FindPath with CompactSearchContext path should be connected and passable");
+
+		TestMatchesFindPath(&fullContext, map, buffer, MAX_SIZE, COUNT, 40,
+			[&](const unsigned char* queryMap, const RandomQuery& query, int* outBuffer, int bufferSize) {
+				return FindPath(&context, &bucketQueue, query.sx, query.sy, query.tx, query.ty, queryMap, query.width, query.height, outBuffer, bufferSize);
+			},
+			"FindPath with CompactSearchContext and BucketQueue path cost should match FindPath path cost",
+			"FindPath with CompactSearchContext and BucketQueue path should be connected and passable");
+
+		// Map wider than packed coordinates allow, open list keeps nodes, wall in the middle with gap in last row
+		{
+			const int WIDE_WIDTH = GRID_MAX_PACKED_WIDTH + 4464;
+			const int WIDE_HEIGHT = 3;
+			const int WIDE_NODES = WIDE_WIDTH * WIDE_HEIGHT;
+
+			unsigned char* wideMap = static_cast<unsigned char*>(Allocate(&allocator, WIDE_NODES, 1));
+			int* wideBuffer = static_cast<int*>(Allocate(&allocator, WIDE_NODES * sizeof(int), alignof(int)));
+
+			memset(wideMap, 1, WIDE_NODES);
+			wideMap[WIDE_WIDTH / 2] = 0;
+			wideMap[WIDE_WIDTH / 2 + WIDE_WIDTH] = 0;
+
+			int expected = (WIDE_WIDTH - 1) + 2 * (WIDE_HEIGHT - 1);
+			int target = WIDE_WIDTH - 1;
+
+			int cost = FindPath(&fullContext, 0, 0, WIDE_WIDTH - 1, 0, wideMap, WIDE_WIDTH, WIDE_HEIGHT, nullptr, 0);
+			int costCompact = FindPath(&context, 0, 0, WIDE_WIDTH - 1, 0, wideMap, WIDE_WIDTH, WIDE_HEIGHT, wideBuffer, WIDE_NODES);
+			TestAssert(cost == expected, "FindPath should search map wider than packed coordinates");
+			TestAssert(costCompact == expected && IsValidPath(wideBuffer, costCompact, 0, target, wideMap, WIDE_WIDTH),
+				"FindPath with CompactSearchContext should search map wider than packed coordinates");
+
+			SparseSearchContext sparseContext;
+			sparseContext.Init(&allocator);
+
+			int costSparse = FindPath(&sparseContext, 0, 0, WIDE_WIDTH - 1, 0, wideMap, WIDE_WIDTH, WIDE_HEIGHT, nullptr, 0);
+			TestAssert(costSparse == expected, "FindPath with SparseSearchContext should search map wider than packed coordinates");
+
+			Deallocate(&allocator, wideBuffer);
+			Deallocate(&allocator, wideMap);
+		}
+	}
+
+	AllocatorDestruct(&allocator);
+}
+
+static void TestJumpPointSearch() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	{
+		SearchContext context;
+		context.Init(&allocator);
+
+		// Random maps, JPS has to find path with the same cost as A*
+		const int COUNT = 200;
+		const int MAX_SIZE = 24;
+
+		unsigned char map[MAX_SIZE * MAX_SIZE];
+		int buffer[MAX_SIZE * MAX_SIZE];
+
+		void* bitsMem = Allocate(&allocator, PassabilityMapMemorySize(MAX_SIZE, MAX_SIZE), 8);
+
+		for (int i = 0; i < COUNT; ++i) {
+			int width = 1 + rand() % MAX_SIZE;
+			int height = 1 + rand() % MAX_SIZE;
+			int density = rand() % 40;
+
+			for (int j = 0; j < width * height; ++j)
+				map[j] = (rand() % 100) < density ? 0 : 1;
+
+			int start = rand() % (width * height);
+			int target = rand() % (width * height);
+			map[start] = 1;
+			map[target] = 1;
+
+			int sx = start % width, sy = start / width;
+			int tx = target % width, ty = target / width;
+
+			int cost = FindPath(&context, sx, sy, tx, ty, map, width, height, buffer, MAX_SIZE * MAX_SIZE);
+			int costJPS = FindPathJPS(&context, sx, sy, tx, ty, map, width, height, buffer, MAX_SIZE * MAX_SIZE);
+
+			TestAssert(cost == costJPS, "JPS path cost should match A* path cost");
+			if (costJPS != SearchContext::INFINITE_COST)
+				TestAssert(IsValidPath(buffer, costJPS, start, target, map, width), "JPS path should be connected and passable");
+
+			PassabilityMap bits = PassabilityMapMake(bitsMem, width, height);
+			PassabilityMapBuild(&bits, map);
+
+			int costBits = FindPathJPS(&context, sx, sy, tx, ty, &bits, buffer, MAX_SIZE * MAX_SIZE);
+			TestAssert(cost == costBits, "JPS on PassabilityMap path cost should match A* path cost");
+			if (costBits != SearchContext::INFINITE_COST)
+				TestAssert(IsValidPath(buffer, costBits, start, target, map, width), "JPS on PassabilityMap path should be connected and passable");
+		}
+
+		Deallocate(&allocator, bitsMem);
+	}
+
+	AllocatorDestruct(&allocator);
+}
+
+static void TestBidirectionalAStar() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	{
+		SearchContext context;
+		context.Init(&allocator);
+
+		SearchContext backwardContext;
+		backwardContext.Init(&allocator);
+
+		// Random maps, bidirectional search has to find path with the same cost as A*
+		const int COUNT = 300;
+		const int MAX_SIZE = 32;
+
+		unsigned char map[MAX_SIZE * MAX_SIZE];
+		int buffer[MAX_SIZE * MAX_SIZE];
+
+		TestMatchesFindPath(&context, map, buffer, MAX_SIZE, COUNT, 45,
+			[&](const unsigned char* queryMap, const RandomQuery& query, int* outBuffer, int bufferSize) {
+				return FindPathBidirectional(&context, &backwardContext, query.sx, query.sy, query.tx, query.ty, queryMap, query.width, query.height,
+					outBuffer, bufferSize);
+			},
+			"Bidirectional path cost should match A* path cost", "Bidirectional path should be connected and passable");
+
+		// Blocked target is unreachable
+		map[0] = 1;
+		map[1] = 0;
+		TestAssert(FindPathBidirectional(&context, &backwardContext, 0, 0, 1, 0, map, 2, 1, buffer, 2) == SearchContext::INFINITE_COST,
+			"Bidirectional search shouldnt reach blocked target");
+
+		// Long query on open map, both directions together expand less than A*
+		{
+			const int WIDTH = 256;
+			const int HEIGHT = 256;
+
+			unsigned char* bigMap = static_cast<unsigned char*>(Allocate(&allocator, WIDTH * HEIGHT, 1));
+			GenerateRandomMap(bigMap, WIDTH, HEIGHT, 30, 11);
+			bigMap[0] = 1;
+			bigMap[WIDTH * HEIGHT - 1] = 1;
+
+			SearchStats stats;
+			int cost = FindPath(&context, 0, 0, WIDTH - 1, HEIGHT - 1, bigMap, WIDTH, HEIGHT, nullptr, 0, &stats);
+			int expanded = stats.expandedCount;
+
+			int costBidirectional = FindPathBidirectional(&context, &backwardContext, 0, 0, WIDTH - 1, HEIGHT - 1, bigMap, WIDTH, HEIGHT, nullptr, 0, &stats);
+			TestAssert(cost == costBidirectional, "Bidirectional path cost should match A* path cost");
+			TestAssert(stats.expandedCount < expanded, "Bidirectional search should expand less nodes than A*");
+
+			Deallocate(&allocator, bigMap);
+		}
+	}
+
+	AllocatorDestruct(&allocator);
+}
+
+static void TestPathPostProcess() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	{
+		SearchContext context;
+		context.Init(&allocator);
+
+		// Straight corridor is one segment and one waypoint
+		{
+			const int WIDTH = 50;
+			unsigned char map[WIDTH];
+			for (int i = 0; i < WIDTH; ++i)
+				map[i] = 1;
+
+			int path[WIDTH];
+			int cost = FindPath(&context, 0, 0, WIDTH - 1, 0, map, WIDTH, 1, path, WIDTH);
+
+			PathSegment segments[4];
+			int waypoints[4];
+			TestAssert(PathToSegments(path, cost, 0, WIDTH, segments, 4) == 1 && segments[0].direction == 1 && segments[0].length == WIDTH - 1,
+				"PathToSegments should give one segment for corridor");
+			TestAssert(PathToWaypoints(path, cost, 0, WIDTH, waypoints, 4) == 1 && waypoints[0] == WIDTH - 1, "PathToWaypoints should give only target for corridor");
+			TestAssert(PathSmooth(path, cost, 0, map, WIDTH, 1, waypoints, 4) == 1 && waypoints[0] == WIDTH - 1, "PathSmooth should give only target for corridor");
+		}
+
+		// Line of sight passes through corner only between passable cells
+		{
+			const unsigned char map[] = {
+				1,0,1,
+				0,1,1,
+				1,1,1};
+
+			TestAssert(!PathLineOfSight(map, 3, 3, 0, 4), "PathLineOfSight should not pass between blocked cells");
+			TestAssert(PathLineOfSight(map, 3, 3, 4, 8), "PathLineOfSight should pass corner of passable cells");
+			TestAssert(PathLineOfSight(map, 3, 3, 6, 2) == false, "PathLineOfSight should not pass through blocked cell");
+			TestAssert(PathLineOfSight(map, 3, 3, 7, 5), "PathLineOfSight should see neighbour over corner");
+		}
+
+		const int COUNT = 200;
+		const int MAX_SIZE = 40;
+
+		unsigned char map[MAX_SIZE * MAX_SIZE];
+		int path[MAX_SIZE * MAX_SIZE];
+		int decoded[MAX_SIZE * MAX_SIZE];
+		int waypoints[MAX_SIZE * MAX_SIZE];
+		PathSegment segments[MAX_SIZE * MAX_SIZE];
+
+		// Random paths, segments decode back to path, waypoints are on path, smoothed waypoints see each other
+		bool decodedSame = true;
+		bool waypointsOnPath = true;
+		bool smoothVisible = true;
+		bool smoothShorter = true;
+		bool smallBuffer = true;
+		for (int i = 0; i < COUNT; ++i) {
+			RandomQuery query = MakeRandomQuery(map, MAX_SIZE, 40, i);
+			const int width = query.width;
+			const int height = query.height;
+			const int start = query.start;
+			const int target = query.target;
+
+			int cost = FindPath(&context, query.sx, query.sy, query.tx, query.ty, map, width, height, path, MAX_SIZE * MAX_SIZE);
+			if (cost == SearchContext::INFINITE_COST)
+				continue;
+
+			int segmentsCount = PathToSegments(path, cost, start, width, segments, MAX_SIZE * MAX_SIZE);
+			decodedSame = decodedSame && PathFromSegments(segments, segmentsCount, start, width, decoded, MAX_SIZE * MAX_SIZE) == cost &&
+				memcmp(path, decoded, cost * sizeof(int)) == 0;
+
+			PathSegment firstSegment;
+			smallBuffer = smallBuffer && PathToSegments(path, cost, start, width, &firstSegment, 1) == segmentsCount &&
+				(cost == 0 || (firstSegment.direction == segments[0].direction && firstSegment.length == segments[0].length));
+
+			int waypointsCount = PathToWaypoints(path, cost, start, width, waypoints, MAX_SIZE * MAX_SIZE);
+			waypointsOnPath = waypointsOnPath && waypointsCount <= segmentsCount && (cost == 0 || waypoints[waypointsCount - 1] == target);
+			for (int w = 0; w < waypointsCount; ++w)
+				waypointsOnPath = waypointsOnPath && std::find(path, path + cost, waypoints[w]) != path + cost;
+
+			int smoothCount = PathSmooth(path, cost, start, map, width, height, waypoints, MAX_SIZE * MAX_SIZE);
+			smoothVisible = smoothVisible && smoothCount <= waypointsCount && (cost == 0 || waypoints[smoothCount - 1] == target);
+
+			double length = 0.0;
+			int from = start;
+			for (int w = 0; w < smoothCount; ++w) {
+				smoothVisible = smoothVisible && PathLineOfSight(map, width, height, from, waypoints[w]);
+
+				int dx = waypoints[w] % width - from % width;
+				int dy = waypoints[w] / width - from / width;
+				length += sqrt((double) (dx * dx + dy * dy));
+				from = waypoints[w];
+			}
+			smoothShorter = smoothShorter && length <= cost + 1e-9;
+		}
+
+		TestAssert(decodedSame, "PathFromSegments should decode path of PathToSegments");
+		TestAssert(smallBuffer, "PathToSegments should count all segments and write only buffer size");
+		TestAssert(waypointsOnPath, "PathToWaypoints should give turning nodes of path and target");
+		TestAssert(smoothVisible, "PathSmooth waypoints should see each other");
+		TestAssert(smoothShorter, "PathSmooth path should not be longer than path");
+	}
+
+	AllocatorDestruct(&allocator);
+}
+
+static void TestHierarchicalMap() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	{
+		SearchContext context;
+		context.Init(&allocator);
+
+		SearchContext abstractContext;
+		abstractContext.Init(&allocator);
+
+		HierarchicalMap hierarchicalMap;
+		hierarchicalMap.Init(&allocator);
+
+		// Paths have to exist for the same queries as A* ones, they can be longer
+		const int WIDTH = 93;
+		const int HEIGHT = 71;
+		const int QUERIES = 100;
+
+		unsigned char* map = static_cast<unsigned char*>(Allocate(&allocator, WIDTH * HEIGHT, 1));
+		int* buffer = static_cast<int*>(Allocate(&allocator, WIDTH * HEIGHT * sizeof(int), alignof(int)));
+		int waypoints[256];
+
+		for (int kind = 0; kind < 3; ++kind) {
+			if (kind == 0)
+				GenerateRandomMap(map, WIDTH, HEIGHT, 30, 11);
+			else if (kind == 1)
+				GenerateRoomsMap(&allocator, map, WIDTH, HEIGHT, 9, 11);
+			else
+				GenerateMazeMap(&allocator, map, WIDTH, HEIGHT, 11);
+
+			hierarchicalMap.Build(&context, map, WIDTH, HEIGHT, 10);
+			TestAssert(hierarchicalMap.NodesCount() > 0 && hierarchicalMap.EdgesCount() > 0, "HierarchicalMap should have transitions");
+
+			unsigned int random = kind;
+			for (int i = 0; i < QUERIES; ++i) {
+				int start = RandomPassableCell(map, WIDTH, HEIGHT, &random);
+				int target = RandomPassableCell(map, WIDTH, HEIGHT, &random);
+				int sx = start % WIDTH, sy = start / WIDTH;
+				int tx = target % WIDTH, ty = target / WIDTH;
+
+				int cost = FindPath(&context, sx, sy, tx, ty, map, WIDTH, HEIGHT, nullptr, 0);
+				int costHierarchical = FindPathHierarchical(&hierarchicalMap, &abstractContext, &context, sx, sy, tx, ty, map, buffer, WIDTH * HEIGHT);
+
+				TestAssert((cost == SearchContext::INFINITE_COST) == (costHierarchical == SearchContext::INFINITE_COST), "FindPathHierarchical should find path when A* does");
+				if (cost == SearchContext::INFINITE_COST)
+					continue;
+
+				TestAssert(costHierarchical >= cost, "FindPathHierarchical path cant be shorter than A* path");
+				TestAssert(IsValidPath(buffer, costHierarchical, start, target, map, WIDTH), "FindPathHierarchical path should be connected and passable");
+
+				int waypointsCount;
+				int costAbstract = FindAbstractPath(&hierarchicalMap, &abstractContext, &context, sx, sy, tx, ty, map, waypoints, 256, &waypointsCount);
+				TestAssert(costAbstract >= costHierarchical, "FindAbstractPath cost should be upper bound of refined cost");
+				TestAssert(waypointsCount >= 2 && waypointsCount <= 256 && waypoints[0] == start && waypoints[waypointsCount - 1] == target, "FindAbstractPath should return waypoints from start to target");
+			}
+		}
+
+		Deallocate(&allocator, buffer);
+		Deallocate(&allocator, map);
+	}
+
+	AllocatorDestruct(&allocator);
+}
+
+static void TestIncrementalSearch() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	{
+		SearchContext context;
+		context.Init(&allocator);
+
+		IncrementalSearch search;
+		search.Init(&allocator);
+
+		// Cells are changed and start moves, repaired search has to match A* from scratch
+		const int MAPS = 30;
+		const int CHANGES = 40;
+		const int MAX_SIZE = 40;
+
+		unsigned char map[MAX_SIZE * MAX_SIZE];
+		int buffer[MAX_SIZE * MAX_SIZE];
+		int changed[4];
+
+		unsigned int random = 17;
+		for (int i = 0; i < MAPS; ++i) {
+			int width = 2 + rand() % (MAX_SIZE - 1);
+			int height = 2 + rand() % (MAX_SIZE - 1);
+			GenerateRandomMap(map, width, height, rand() % 40, i);
+
+			int target = rand() % (width * height);
+			map[target] = 1;
+			int start = RandomPassableCell(map, width, height, &random);
+
+			search.Begin(map, width, height, target % width, target / width);
+
+			for (int j = 0; j < CHANGES; ++j) {
+				int cost = FindPath(&context, start % width, start / width, target % width, target / width, map, width, height, nullptr, 0);
+				int costIncremental = search.FindPath(start % width, start / width, buffer, width * height);
+
+				TestAssert(cost == costIncremental, "IncrementalSearch path cost should match A* path cost");
+				if (costIncremental != SearchContext::INFINITE_COST)
+					TestAssert(IsValidPath(buffer, costIncremental, start, target, map, width), "IncrementalSearch path should be connected and passable");
+
+				// Start walks along path or jumps
+				if (costIncremental != SearchContext::INFINITE_COST && costIncremental > 0 && rand() % 2)
+					start = buffer[costIncremental - 1];
+				else
+					start = RandomPassableCell(map, width, height, &random);
+
+				int changedCount = 1 + rand() % 4;
+				for (int k = 0; k < changedCount; ++k) {
+					int cell = rand() % (width * height);
+					if (cell != target && cell != start)
+						map[cell] = !map[cell];
+					changed[k] = cell;
+				}
+				search.UpdateCells(changed, changedCount);
+			}
+		}
+
+		// Change far from path repairs less than full search
+		{
+			const int WIDTH = 200;
+			const int HEIGHT = 200;
+
+			unsigned char* bigMap = static_cast<unsigned char*>(Allocate(&allocator, WIDTH * HEIGHT, 1));
+			GenerateOpenMap(bigMap, WIDTH, HEIGHT, 3);
+			bigMap[0] = 1;
+			bigMap[WIDTH * HEIGHT - 1] = 1;
+
+			SearchStats stats;
+			search.Begin(bigMap, WIDTH, HEIGHT, WIDTH - 1, HEIGHT - 1);
+			search.FindPath(0, 0, nullptr, 0, &stats);
+			int fullExpanded = stats.expandedCount;
+
+			int cell = WIDTH - 1;
+			bigMap[cell] = !bigMap[cell];
+			search.UpdateCells(&cell, 1);
+			int cost = search.FindPath(0, 0, nullptr, 0, &stats);
+
+			TestAssert(cost == FindPath(&context, 0, 0, WIDTH - 1, HEIGHT - 1, bigMap, WIDTH, HEIGHT, nullptr, 0), "IncrementalSearch path cost should match A* path cost");
+			TestAssert(stats.expandedCount < fullExpanded / 10, "IncrementalSearch should repair only part of search");
+
+			// Blocked start has no path, nothing is expanded and search stays valid for next start
+			int blocked = WIDTH / 2 + (HEIGHT / 2) * WIDTH;
+			bigMap[blocked] = 0;
+			search.UpdateCells(&blocked, 1);
+			cost = search.FindPath(WIDTH / 2, HEIGHT / 2, nullptr, 0, &stats);
+			TestAssert(cost == IncrementalSearch::INFINITE_COST && stats.expandedCount == 0, "IncrementalSearch should not search from blocked start");
+
+			cost = search.FindPath(0, 0, nullptr, 0, &stats);
+			TestAssert(cost == FindPath(&context, 0, 0, WIDTH - 1, HEIGHT - 1, bigMap, WIDTH, HEIGHT, nullptr, 0), "IncrementalSearch path cost should match A* path cost");
+
+			Deallocate(&allocator, bigMap);
+		}
+	}
+
+	AllocatorDestruct(&allocator);
+}
+
+static void TestComponentMap() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	{
+		SearchContext context;
+		context.Init(&allocator);
+
+		ComponentMap components;
+		components.Init(&allocator);
+
+		ComponentMap built;
+		built.Init(&allocator);
+
+		// Cells are changed, updated labels have to split map the same way as labels built from scratch
+		const int MAPS = 30;
+		const int CHANGES = 60;
+		const int MAX_SIZE = 40;
+
+		unsigned char map[MAX_SIZE * MAX_SIZE];
+		int labelsMapping[MAX_SIZE * MAX_SIZE + 1];
+		int builtMapping[MAX_SIZE * MAX_SIZE + 1];
+		int changed[4];
+
+		for (int i = 0; i < MAPS; ++i) {
+			int width = 2 + rand() % (MAX_SIZE - 1);
+			int height = 2 + rand() % (MAX_SIZE - 1);
+			GenerateRandomMap(map, width, height, 20 + rand() % 40, i);
+
+			components.Build(map, width, height);
+
+			for (int j = 0; j < CHANGES; ++j) {
+				built.Build(map, width, height);
+				TestAssert(components.ComponentsCount() == built.ComponentsCount(), "ComponentMap components count should match built components count");
+
+				for (int k = 0; k <= width * height; ++k) {
+					labelsMapping[k] = -1;
+					builtMapping[k] = -1;
+				}
+
+				bool sameComponents = true;
+				for (int cell = 0; cell < width * height; ++cell) {
+					int label = components.Label(cell);
+					int builtLabel = built.Label(cell);
+					if ((label == 0) != (map[cell] == 0) || (builtLabel == 0) != (map[cell] == 0))
+						sameComponents = false;
+
+					if (labelsMapping[label] < 0)
+						labelsMapping[label] = builtLabel;
+					if (builtMapping[builtLabel] < 0)
+						builtMapping[builtLabel] = label;
+
+					if (labelsMapping[label] != builtLabel || builtMapping[builtLabel] != label)
+						sameComponents = false;
+				}
+				TestAssert(sameComponents, "ComponentMap labels should match labels built from scratch");
+
+				int start = rand() % (width * height);
+				int target = rand() % (width * height);
+				int cost = FindPath(&context, start % width, start / width, target % width, target / width, map, width, height, nullptr, 0);
+				bool reachable = map[start] && map[target] && cost != SearchContext::INFINITE_COST;
+				TestAssert(components.Connected(start, target) == reachable, "ComponentMap connected cells should be reachable by A*");
+
+				int changedCount = 1 + rand() % 4;
+				for (int k = 0; k < changedCount; ++k) {
+					int cell = rand() % (width * height);
+					map[cell] = !map[cell];
+					changed[k] = cell;
+				}
+				components.UpdateCells(&context, changed, changedCount);
+			}
+		}
+
+		// Two halves split by wall, unreachable query is rejected without search
+		{
+			const int WIDTH = 64;
+			const int HEIGHT = 64;
+
+			unsigned char wallMap[WIDTH * HEIGHT];
+			for (int k = 0; k < WIDTH * HEIGHT; ++k)
+				wallMap[k] = (k % WIDTH) != WIDTH / 2;
+
+			components.Build(wallMap, WIDTH, HEIGHT);
+			TestAssert(components.ComponentsCount() == 2, "ComponentMap should have 2 components");
+
+			SearchStats stats;
+			int cost = FindPathConnected(&context, &components, 0, 0, WIDTH - 1, HEIGHT - 1, wallMap, WIDTH, HEIGHT, nullptr, 0, &stats);
+			TestAssert(cost == SearchContext::INFINITE_COST, "FindPathConnected should return infinite cost");
+			TestAssert(stats.expandedCount == 0, "FindPathConnected should not search unreachable target");
+
+			cost = FindPathConnected(&context, &components, 0, 0, WIDTH / 2 - 1, HEIGHT - 1, wallMap, WIDTH, HEIGHT, nullptr, 0, &stats);
+			TestAssert(cost == WIDTH / 2 - 1 + HEIGHT - 1, "FindPathConnected should find path in component");
+
+			// Opened cell joins halves, blocked again splits them
+			int cell = WIDTH / 2 + (HEIGHT / 2) * WIDTH;
+			wallMap[cell] = 1;
+			components.UpdateCells(&context, &cell, 1);
+			TestAssert(components.ComponentsCount() == 1, "ComponentMap should join components");
+			TestAssert(components.Connected(0, WIDTH * HEIGHT - 1), "ComponentMap should connect halves");
+
+			wallMap[cell] = 0;
+			components.UpdateCells(&context, &cell, 1);
+			TestAssert(components.ComponentsCount() == 2, "ComponentMap should split component");
+			TestAssert(!components.Connected(0, WIDTH * HEIGHT - 1), "ComponentMap should split halves");
+		}
+	}
+
+	AllocatorDestruct(&allocator);
+}
+
+static void TestPathBatch() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	{
+		const int WIDTH = 64;
+		const int HEIGHT = 48;
+		const int QUERIES = 300;
+
+		unsigned char map[WIDTH * HEIGHT];
+		for (int i = 0; i < WIDTH * HEIGHT; ++i)
+			map[i] = (rand() % 100) < 25 ? 0 : 1;
+
+		PathQuery queries[QUERIES];
+		int* buffers = static_cast<int*>(Allocate(&allocator, QUERIES * WIDTH * HEIGHT * sizeof(int), alignof(int)));
+		int buffer[WIDTH * HEIGHT];
+
+		for (int i = 0; i < QUERIES; ++i) {
+			PathQuery& query = queries[i];
+			query.startX = rand() % WIDTH;
+			query.startY = rand() % HEIGHT;
+			query.targetX = rand() % WIDTH;
+			query.targetY = rand() % HEIGHT;
+			query.outBuffer = buffers + i * WIDTH * HEIGHT;
+			query.outBufferSize = WIDTH * HEIGHT;
+			query.pathCost = -1;
+		}
+
+		PathBatchWorkers workers;
+		workers.Init(&allocator, 4);
+
+		SearchContext context;
+		context.Init(&allocator);
+
+		// Second batch runs on warm workers
+		for (int batch = 0; batch < 2; ++batch) {
+			FindPathBatch(&workers, map, WIDTH, HEIGHT, queries, QUERIES);
+
+			for (int i = 0; i < QUERIES; ++i) {
+				PathQuery& query = queries[i];
+				int cost = FindPath(&context, query.startX, query.startY, query.targetX, query.targetY, map, WIDTH, HEIGHT, buffer, WIDTH * HEIGHT);
+				TestAssert(query.pathCost == cost, "FindPathBatch path cost should match FindPath");
+
+				if (cost != SearchContext::INFINITE_COST && cost > 0) {
+					TestAssert(query.outBuffer[0] == query.targetX + query.targetY * WIDTH, "FindPathBatch path should start with target");
+					TestAssert(IsValidPath(query.outBuffer, cost, query.startX + query.startY * WIDTH, query.outBuffer[0], map, WIDTH), "FindPathBatch path should be connected and passable");
+				}
+			}
+		}
+
+		Deallocate(&allocator, buffers);
+	}
+
+	AllocatorDestruct(&allocator);
+}
+
+static bool AllPassableReachable(SearchContext* context, const unsigned char* map, int width, int height) {
+	int start = 0;
+	while (!map[start])
+		++start;
+
+	// Search to blocked cell closes all reachable cells
+	int blocked = 0;
+	while (map[blocked])
+		++blocked;
+
+	FindPath(context, start % width, start / width, blocked % width, blocked / width, map, width, height, nullptr, 0);
+
+	for (int i = 0; i < width * height; ++i) {
+		if (map[i] && !context->IsClosed(i))
+			return false;
+	}
+	return true;
+}
+
+static void TestMapGenerator() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	{
+		const int WIDTH = 67;
+		const int HEIGHT = 45;
+
+		unsigned char a[WIDTH * HEIGHT];
+		unsigned char b[WIDTH * HEIGHT];
+
+		SearchContext context;
+		context.Init(&allocator);
+
+		GenerateRandomMap(a, WIDTH, HEIGHT, 30, 5);
+		GenerateRandomMap(b, WIDTH, HEIGHT, 30, 5);
+		TestAssert(memcmp(a, b, sizeof(a)) == 0, "GenerateRandomMap should give same map for same seed");
+
+		int blocked = 0;
+		for (int i = 0; i < WIDTH * HEIGHT; ++i)
+			blocked += a[i] == 0;
+		TestAssert(blocked > WIDTH * HEIGHT / 4 && blocked < WIDTH * HEIGHT * 7 / 20, "GenerateRandomMap should block density percent of cells");
+
+		GenerateRandomMap(b, WIDTH, HEIGHT, 30, 6);
+		TestAssert(memcmp(a, b, sizeof(a)) != 0, "GenerateRandomMap should give different map for different seed");
+
+		GenerateOpenMap(a, WIDTH, HEIGHT, 5);
+		blocked = 0;
+		for (int i = 0; i < WIDTH * HEIGHT; ++i)
+			blocked += a[i] == 0;
+		TestAssert(blocked > 0 && blocked < WIDTH * HEIGHT / 10, "GenerateOpenMap should have few obstacles");
+
+		// Maze and rooms are connected, one blocked cell is needed by AllPassableReachable
+		GenerateMazeMap(&allocator, a, WIDTH, HEIGHT, 5);
+		GenerateMazeMap(&allocator, b, WIDTH, HEIGHT, 5);
+		TestAssert(memcmp(a, b, sizeof(a)) == 0, "GenerateMazeMap should give same map for same seed");
+		TestAssert(AllPassableReachable(&context, a, WIDTH, HEIGHT), "GenerateMazeMap should connect all cells");
+		TestAssert(a[1 + WIDTH] == 0, "GenerateMazeMap should have walls on odd coordinates");
+
+		GenerateRoomsMap(&allocator, a, WIDTH, HEIGHT, 8, 5);
+		TestAssert(AllPassableReachable(&context, a, WIDTH, HEIGHT), "GenerateRoomsMap should connect all rooms");
+
+		unsigned int random = 3;
+		for (int i = 0; i < 100; ++i)
+			TestAssert(a[RandomPassableCell(a, WIDTH, HEIGHT, &random)] != 0, "RandomPassableCell should return passable cell");
+	}
+
+	AllocatorDestruct(&allocator);
+}
+
+static void TestMovingAI() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	{
+		const char* mapText =
+			"type octile\r\n"
+			"height 3\r\n"
+			"width 4\r\n"
+			"map\r\n"
+			".G@S\r\n"
+			"TOW.\r\n"
+			"....\r\n";
+
+		MovingAIMap map;
+		TestAssert(MovingAIParseMap(&allocator, mapText, &map), "MovingAIParseMap should parse map");
+		TestAssert(map.width == 4 && map.height == 3, "MovingAIParseMap should read size");
+
+		const unsigned char expected[] = {1,1,0,1, 0,0,0,1, 1,1,1,1};
+		TestAssert(memcmp(map.map, expected, sizeof(expected)) == 0, "MovingAIParseMap should read passable terrain");
+		MovingAIFreeMap(&allocator, &map);
+
+		TestAssert(!MovingAIParseMap(&allocator, "type octile\nheight 3\nwidth 4\nmap\n....\n..\n", &map), "MovingAIParseMap should fail on short map");
+		TestAssert(!MovingAIParseMap(&allocator, "height x\nwidth 4\nmap\n....\n", &map), "MovingAIParseMap should fail on bad header");
+
+		const char* scenarioText =
+			"version 1\n"
+			"0\tmaps/test.map\t4\t3\t0\t0\t3\t2\t5\n"
+			"1\tmaps/test.map\t4\t3\t1\t0\t3\t0\t3.41421356\n";
+
+		MovingAIScenario scenario;
+		TestAssert(MovingAIParseScenario(&allocator, scenarioText, &scenario), "MovingAIParseScenario should parse scenario");
+		TestAssert(scenario.queriesCount == 2, "MovingAIParseScenario should read all queries");
+		TestAssert(scenario.queries[1].startX == 1 && scenario.queries[1].startY == 0 && scenario.queries[1].targetX == 3 && scenario.queries[1].targetY == 0,
+			"MovingAIParseScenario should read coordinates");
+		TestAssert(scenario.queries[1].optimalLength > 3.41 && scenario.queries[1].optimalLength < 3.42, "MovingAIParseScenario should read optimal length");
+		MovingAIFreeScenario(&allocator, &scenario);
+
+		TestAssert(!MovingAIParseScenario(&allocator, "version 1\n0 test.map 4 3 0 0\n", &scenario), "MovingAIParseScenario should fail on short line");
+		TestAssert(!MovingAILoadMap(&allocator, "missing.map", &map), "MovingAILoadMap should fail on missing file");
+	}
+
+	AllocatorDestruct(&allocator);
+}
+
+// Header and data into new file (broken map files)
+static void WriteTestFile(const char* path, const void* header, size_t headerSize, const void* data, size_t dataSize) {
+	FILE* file = nullptr;
+#if MSVC
+	if (fopen_s(&file, path, "wb") != 0)
+		file = nullptr;
+#else
+	file = fopen(path, "wb");
+#endif
+	TestAssert(file != nullptr, "Test file should be created");
+
+	fwrite(header, 1, headerSize, file);
+	fwrite(data, 1, dataSize, file);
+	fclose(file);
+}
+
+static void TestMapFile() {
+	HeapAllocator allocator;
+	InitHeapAllocator(&allocator);
+
+	{
+		const char* path = "test_map_file.grid";
+
+		const int WIDTH = 70;
+		const int HEIGHT = 33;
+
+		unsigned char map[WIDTH * HEIGHT];
+		GenerateRandomMap(map, WIDTH, HEIGHT, 30, 5);
+		map[0] = 1;
+		map[WIDTH * HEIGHT - 1] = 1;
+
+		SearchContext context;
+		context.Init(&allocator);
+
+		int buffer[WIDTH * HEIGHT];
+		int cost = FindPath(&context, 0, 0, WIDTH - 1, HEIGHT - 1, map, WIDTH, HEIGHT, nullptr, 0);
+
+		// Bytes are the same map, FindPath runs on mapped memory
+		{
+			TestAssert(MapFileWrite(&allocator, path, map, WIDTH, HEIGHT, MapFileEncoding::Bytes), "MapFileWrite should write bytes");
+
+			MapFile file;
+			TestAssert(MapFileOpen(path, &file), "MapFileOpen should open written bytes");
+			TestAssert(file.width == WIDTH && file.height == HEIGHT && file.encoding == MapFileEncoding::Bytes, "MapFileOpen should read header");
+
+			bool same = true;
+			for (int i = 0; i < WIDTH * HEIGHT; ++i)
+				same = same && MapFileBytes(&file)[i] == (map[i] ? 1 : 0);
+			TestAssert(same, "MapFile bytes should match map");
+
+			int costFile = FindPath(&context, 0, 0, WIDTH - 1, HEIGHT - 1, MapFileBytes(&file), WIDTH, HEIGHT, buffer, WIDTH * HEIGHT);
+			TestAssert(cost == costFile, "FindPath on MapFile bytes path cost should match FindPath path cost");
+
+			MapFileClose(&file);
+		}
+
+		// Bits are PassabilityMap, JPS runs on mapped memory
+		{
+			TestAssert(MapFileWrite(&allocator, path, map, WIDTH, HEIGHT, MapFileEncoding::Bits), "MapFileWrite should write bits");
+
+			MapFile file;
+			TestAssert(MapFileOpen(path, &file), "MapFileOpen should open written bits");
+			TestAssert(file.encoding == MapFileEncoding::Bits, "MapFileOpen should read encoding");
+
+			PassabilityMap bits = MapFilePassabilityMap(&file);
+
+			bool same = true;
+			for (int y = 0; y < HEIGHT; ++y) {
+				for (int x = 0; x < WIDTH; ++x)
+					same = same && PassabilityMapIs(&bits, x, y) == (map[x + y * WIDTH] != 0);
+			}
+			TestAssert(same, "MapFile bits should match map");
+
+			int costFile = FindPathJPS(&context, 0, 0, WIDTH - 1, HEIGHT - 1, &bits, buffer, WIDTH * HEIGHT);
+			TestAssert(cost == costFile, "FindPathJPS on MapFile bits path cost should match FindPath path cost");
+
+			MapFileClose(&file);
+		}
+
+		// Broken files are not opened
+		{
+			MapFile file;
+			TestAssert(!MapFileOpen("missing.grid", &file), "MapFileOpen should fail on missing file");
+
+			MapFileHeader header;
+			memset(&header, 0, sizeof(header));
+			memcpy(header.magic, "GRID", 4);
+			header.version = MAP_FILE_VERSION + 1;
+			header.width = WIDTH;
+			header.height = HEIGHT;
+			header.stride = WIDTH;
+			header.dataOffset = sizeof(header);
+			header.dataSize = WIDTH * HEIGHT;
+
+			WriteTestFile(path, &header, sizeof(header), map, WIDTH * HEIGHT);
+			TestAssert(!MapFileOpen(path, &file), "MapFileOpen should fail on unknown version");
+
+			header.version = MAP_FILE_VERSION;
+			WriteTestFile(path, &header, sizeof(header), map, WIDTH * HEIGHT - 1);
+			TestAssert(!MapFileOpen(path, &file), "MapFileOpen should fail on short file");
+
+			// Sizes are checked in 64 bit, maps with more nodes or bits than int can index are refused
+			header.encoding = MapFileEncoding::Bits;
+			header.width = 0x7fffffc1u;
+			header.height = 1;
+			header.stride = (unsigned int) (((0x7fffffc1ull + 63) >> 6) * 8);
+			header.dataSize = 0;
+			WriteTestFile(path, &header, sizeof(header), map, WIDTH * HEIGHT);
+			TestAssert(!MapFileOpen(path, &file), "MapFileOpen should fail on more row bits than int");
+
+			header.encoding = MapFileEncoding::Bytes;
+			header.width = GRID_MAX_PACKED_WIDTH;
+			header.height = GRID_MAX_PACKED_HEIGHT;
+			header.stride = GRID_MAX_PACKED_WIDTH;
+			header.dataSize = (unsigned long long) GRID_MAX_PACKED_WIDTH * GRID_MAX_PACKED_HEIGHT;
+			WriteTestFile(path, &header, sizeof(header), map, WIDTH * HEIGHT);
+			TestAssert(!MapFileOpen(path, &file), "MapFileOpen should fail on more nodes than int");
+		}
+
+		// Map wider than packed coordinates is valid, FindPath keeps nodes in open list
+		{
+			const int WIDE_WIDTH = GRID_MAX_PACKED_WIDTH + 4464;
+			const int WIDE_HEIGHT = 3;
+			const int WIDE_NODES = WIDE_WIDTH * WIDE_HEIGHT;
+
+			unsigned char* wideMap = static_cast<unsigned char*>(Allocate(&allocator, WIDE_NODES, 1));
+			// Walls across map with gap alternating between first and last row
+			memset(wideMap, 1, WIDE_NODES);
+			for (int x = 1000; x < WIDE_WIDTH; x += 1000) {
+				int gap = (x / 1000) % 2 ? 0 : WIDE_HEIGHT - 1;
+				for (int y = 0; y < WIDE_HEIGHT; ++y)
+					wideMap[x + y * WIDE_WIDTH] = y == gap;
+			}
+
+			int wideCost = FindPath(&context, 0, 0, WIDE_WIDTH - 1, WIDE_HEIGHT - 1, wideMap, WIDE_WIDTH, WIDE_HEIGHT, nullptr, 0);
+
+			TestAssert(MapFileWrite(&allocator, path, wideMap, WIDE_WIDTH, WIDE_HEIGHT, MapFileEncoding::Bytes), "MapFileWrite should write wide bytes");
+
+			MapFile file;
+			TestAssert(MapFileOpen(path, &file), "MapFileOpen should open map wider than packed coordinates");
+			TestAssert(file.width == WIDE_WIDTH && file.height == WIDE_HEIGHT, "MapFileOpen should read header of wide map");
+
+			int costFile = FindPath(&context, 0, 0, WIDE_WIDTH - 1, WIDE_HEIGHT - 1, MapFileBytes(&file), WIDE_WIDTH, WIDE_HEIGHT, nullptr, 0);
+			TestAssert(wideCost != SearchContext::INFINITE_COST && wideCost == costFile, "FindPath on wide MapFile bytes path cost should match FindPath path cost");
+
+			MapFileClose(&file);
+			Deallocate(&allocator, wideMap);
+		}
+
+		remove(path);
+	}
+
+	AllocatorDestruct(&allocator);
+}
+
+
+void TestAll() {
+	TestHeapAllocator();
+
+	TestLinearAllocator();
+
+	TestPoolAllocator();
+
+	TestPriorityQueue();
+
+	TestBucketQueue();
+
+	TestIndexedPriorityQueue();
+
+	TestUIntSet();
+
+	TestUIntMap();
+
+	TestSearchContext();
+
+	TestGridNeighbours();
+
+	TestPassabilityMap();
+
+	TestPaddedMap();
+
+	TestTiledMap();
+
+	TestCompactSearchContext();
+
+	TestSparseSearchContext();
+
+	TestWeightedAStar();
+
+	TestJumpPointSearch();
+
+	TestBidirectionalAStar();
+
+	TestPathBatch();
+
+	TestPathPostProcess();
+
+	TestHierarchicalMap();
+
+	TestIncrementalSearch();
+
+	TestComponentMap();
+
+	TestMapGenerator();
+
+	TestMovingAI();
+
+	TestMapFile();
 }
\ No newline at end of file
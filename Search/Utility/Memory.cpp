@@ -1,6 +1,6 @@
 #include "Memory.h"
 
-#include <Utility>
+#include <cstring>
 
 void MemCopy(void* target, const void* source, size_t size) {
 	memcpy(target, source, size);
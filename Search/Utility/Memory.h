@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 
 
 // Align memory adress to next given alignment
@@ -0,0 +1,142 @@
+#include "Profiler.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "Memory.h"
+
+
+namespace {
+	struct ProfilerEntry {
+		long long int count;
+		long long int total;
+		long long int min;
+		long long int max;
+		long long int histogram[PROFILER_HISTOGRAM_BUCKETS];
+	};
+
+	struct ProfilerTable {
+		ProfilerEntry entries[PROFILER_MAX_BLOCKS];
+		ProfilerTable* next;
+	};
+
+	// Last block is shared by all blocks registered over the limit
+	const int OVERFLOW_BLOCK = PROFILER_MAX_BLOCKS - 1;
+	const char* const OVERFLOW_BLOCK_NAME = "(other blocks)";
+
+	const char* g_BlockNames[PROFILER_MAX_BLOCKS];
+	std::atomic<int> g_BlocksCount(0);
+
+	std::atomic<ProfilerTable*> g_Tables(nullptr);
+
+	thread_local ProfilerTable* t_Table = nullptr;
+}
+
+
+static ProfilerTable* CreateTable() {
+	// Never freed, records of finished threads stay in report
+	ProfilerTable* table = static_cast<ProfilerTable*>(malloc(sizeof(ProfilerTable)));
+	MemSet(table, 0, sizeof(ProfilerTable));
+
+	table->next = g_Tables.load(std::memory_order_relaxed);
+	while (!g_Tables.compare_exchange_weak(table->next, table, std::memory_order_release, std::memory_order_relaxed));
+
+	return table;
+}
+
+static int HistogramBucket(long long int cycles) {
+	int bucket = 0;
+	while (cycles > 1 && bucket < PROFILER_HISTOGRAM_BUCKETS - 1) {
+		cycles >>= 1;
+		++bucket;
+	}
+	return bucket;
+}
+
+int ProfilerRegisterBlock(const char* name) {
+	// Counter stops at limit, records of blocks over it are merged into overflow block (also in release build)
+	int id = g_BlocksCount.load(std::memory_order_relaxed);
+	do {
+		if (id >= PROFILER_MAX_BLOCKS)
+			return OVERFLOW_BLOCK;
+	} while (!g_BlocksCount.compare_exchange_weak(id, id + 1, std::memory_order_relaxed));
+
+	g_BlockNames[id] = id == OVERFLOW_BLOCK ? OVERFLOW_BLOCK_NAME : name;
+	return id;
+}
+
+void ProfilerRecord(int blockId, long long int cycles) {
+	assert(blockId >= 0 && blockId < PROFILER_MAX_BLOCKS);
+
+	ProfilerTable* table = t_Table;
+	if (!table) {
+		table = CreateTable();
+		t_Table = table;
+	}
+
+	ProfilerEntry& entry = table->entries[blockId];
+	if (entry.count == 0 || cycles < entry.min)
+		entry.min = cycles;
+	if (cycles > entry.max)
+		entry.max = cycles;
+
+	++entry.count;
+	entry.total += cycles;
+	++entry.histogram[HistogramBucket(cycles)];
+}
+
+void ProfilerReport() {
+	int blocksCount = g_BlocksCount.load(std::memory_order_relaxed);
+	bool reported[PROFILER_MAX_BLOCKS] = {};
+
+	printf("%-24s %10s %14s %10s %12s %12s\n", "block", "count", "total", "min", "avg", "max");
+
+	for (int i = 0; i < blocksCount; ++i) {
+		if (reported[i])
+			continue;
+
+		// Sum of all threads and all blocks with the same name
+		ProfilerEntry sum = {};
+		for (int j = i; j < blocksCount; ++j) {
+			if (strcmp(g_BlockNames[i], g_BlockNames[j]) != 0)
+				continue;
+
+			reported[j] = true;
+
+			for (ProfilerTable* table = g_Tables.load(std::memory_order_acquire); table; table = table->next) {
+				const ProfilerEntry& entry = table->entries[j];
+				if (entry.count == 0)
+					continue;
+
+				if (sum.count == 0 || entry.min < sum.min)
+					sum.min = entry.min;
+				if (entry.max > sum.max)
+					sum.max = entry.max;
+
+				sum.count += entry.count;
+				sum.total += entry.total;
+				for (int k = 0; k < PROFILER_HISTOGRAM_BUCKETS; ++k)
+					sum.histogram[k] += entry.histogram[k];
+			}
+		}
+
+		if (sum.count == 0)
+			continue;
+
+		printf("%-24s %10lld %14lld %10lld %12lld %12lld\n", g_BlockNames[i], sum.count, sum.total, sum.min, sum.total / sum.count, sum.max);
+
+		for (int k = 0; k < PROFILER_HISTOGRAM_BUCKETS; ++k) {
+			if (sum.histogram[k])
+				printf("    < 2^%-2d %10lld\n", k + 1, sum.histogram[k]);
+		}
+	}
+	printf("\n");
+}
+
+void ProfilerReset() {
+	for (ProfilerTable* table = g_Tables.load(std::memory_order_acquire); table; table = table->next)
+		MemSet(table->entries, 0, sizeof(table->entries));
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+//  Profiler
+//    Aggregated block timings (count, total, min, max and log2 histogram of cycles)
+//    Every thread writes only to its own table, no locks or atomics when recording
+//    Thread table is created and registered on first record in the thread (lock free list), tables are never freed
+//    Report sums tables of all threads, blocks with the same name are merged
+//    Report and Reset read / write other threads tables, call them when threads arent profiling
+//    Used through PROFILE_ macros in Timer.h
+
+const int PROFILER_MAX_BLOCKS = 256;
+const int PROFILER_HISTOGRAM_BUCKETS = 48;
+
+// Returns id of block, call once per call site
+// Blocks over PROFILER_MAX_BLOCKS - 1 share the last id and are reported together as "(other blocks)"
+int ProfilerRegisterBlock(const char* name);
+
+void ProfilerRecord(int blockId, long long int cycles);
+
+// Prints all blocks with records
+void ProfilerReport();
+
+void ProfilerReset();
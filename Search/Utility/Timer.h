@@ -2,36 +2,61 @@
 
 #include "../Config.h"
 
-#if PROFILE and MSVC
-
-#include <cstdio> // tmp
+#if MSVC
 #include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
 
-#include <windows.h>
-
+// In cycles (rdtsc), on platforms without rdtsc in nanoseconds (clock_gettime)
 inline long long int QueryCycles() {
+#if MSVC || defined(__x86_64__) || defined(__i386__)
 	return __rdtsc(); // in cycles .... for nano -> * 1000000 / QueryPerformanceFrequency LARGE_INTEGER.QuadPart;
+#else
+	timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec * 1000000000ll + time.tv_nsec;
+#endif
 }
 
+#if PROFILE
+
+#include "Profiler.h"
+
+// Records time of the scope into profiler
 struct TimedBlock {
-	TimedBlock(const char* name) {
+	TimedBlock(int blockId) {
 		_cycleCount = QueryCycles();
-		_name = name;
+		_blockId = blockId;
 	}
 
 	~TimedBlock() {
-		printf("%s time: %lld \n", _name, QueryCycles() - _cycleCount);
+		ProfilerRecord(_blockId, QueryCycles() - _cycleCount);
 	}
-	const char* _name;
+	int _blockId;
 	long long int _cycleCount;
 };
 
-#define PROFILE_BLOCK() TimedBlock block##__FUNCTION__##__LINE__(__FUNCTION__);
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+// Block id is registered once per call site (static)
+#define PROFILE_BLOCK() static const int PROFILE_CONCAT(profileBlockId, __LINE__) = ProfilerRegisterBlock(__FUNCTION__); \
+	TimedBlock PROFILE_CONCAT(profileBlock, __LINE__)(PROFILE_CONCAT(profileBlockId, __LINE__));
+
+#define PROFILE_START(name) static const int name##ProfileId = ProfilerRegisterBlock(#name); long long int name = QueryCycles();
+#define PROFILE_END(name) (QueryCycles() - name)
 
-#define PROFILE_START(name) auto name = QueryCycles();
-#define PROFILE_END(name) QueryCycles() - name 
+// Records into profiler, nothing is printed until ProfilerReport
+#define PROFILE_END_LOG(name) ProfilerRecord(name##ProfileId, PROFILE_END(name));
 
-#define PROFILE_END_LOG(name) printf("%s time: %lld \n", #name, PROFILE_END(name));
+#else
 
+#define PROFILE_BLOCK()
+#define PROFILE_START(name)
+#define PROFILE_END(name) 0
+#define PROFILE_END_LOG(name)
 
 #endif
@@ -1,10 +1,57 @@
 #pragma once
 
+#include <cassert>
+#include <cstddef>
+
+#include "../Config.h"
+
+#if MSVC
+#include <intrin.h>
+#endif
+
 
 bool IsPowerOfTwo(size_t x);
 
+// Count of zero bits below the lowest / above the highest set bit, x cant be 0
+int CountTrailingZeros64(unsigned long long x);
+int CountLeadingZeros64(unsigned long long x);
+
 
 
 inline bool IsPowerOfTwo(size_t x) {
 	return x != 0 && !(x & (x - 1));
 }
+
+inline int CountTrailingZeros64(unsigned long long x) {
+	assert(x != 0);
+#if MSVC && defined(_M_X64)
+	unsigned long index;
+	_BitScanForward64(&index, x);
+	return (int) index;
+#elif MSVC
+	unsigned long index;
+	if (_BitScanForward(&index, (unsigned long) x))
+		return (int) index;
+	_BitScanForward(&index, (unsigned long) (x >> 32));
+	return (int) index + 32;
+#else
+	return __builtin_ctzll(x);
+#endif
+}
+
+inline int CountLeadingZeros64(unsigned long long x) {
+	assert(x != 0);
+#if MSVC && defined(_M_X64)
+	unsigned long index;
+	_BitScanReverse64(&index, x);
+	return 63 - (int) index;
+#elif MSVC
+	unsigned long index;
+	if (_BitScanReverse(&index, (unsigned long) (x >> 32)))
+		return 31 - (int) index;
+	_BitScanReverse(&index, (unsigned long) x);
+	return 63 - (int) index;
+#else
+	return __builtin_clzll(x);
+#endif
+}